@@ -0,0 +1,95 @@
+/**
+ CCamera2D
+ @brief A class which scrolls the view of the 2D scene to follow a target, without going past the edges of the map
+ By: JH Chong
+ Date: Aug 2022
+ */
+#include "Camera2D.h"
+
+/**
+ @brief Constructor This constructor has protected access modifier as this class will be a Singleton
+ */
+CCamera2D::CCamera2D(void)
+	: vec2Centre(0.0f)
+	, cSettings(NULL)
+{
+}
+
+/**
+ @brief Destructor This destructor has protected access modifier as this class will be a Singleton
+ */
+CCamera2D::~CCamera2D(void)
+{
+	// We won't delete this since it was created elsewhere
+	cSettings = NULL;
+}
+
+/**
+ @brief Init Initialise this instance
+ */
+bool CCamera2D::Init(void)
+{
+	// Get the handler to the CSettings instance
+	cSettings = &CSettings::GetInstance();
+
+	vec2Centre = glm::vec2(0.0f);
+
+	return true;
+}
+
+/**
+ @brief Update the view to centre on a position in UV space
+ @param vec2Target A const glm::vec2& variable containing the position to centre the view on
+ */
+void CCamera2D::Update(const glm::vec2& vec2Target)
+{
+	vec2Centre.x = ClampToMap(vec2Target.x, cSettings->NUM_TILES_XAXIS * cSettings->TILE_WIDTH);
+	vec2Centre.y = ClampToMap(vec2Target.y, cSettings->NUM_TILES_YAXIS * cSettings->TILE_HEIGHT);
+}
+
+/**
+ @brief Get the matrix which converts UV space to the view
+ */
+glm::mat4 CCamera2D::GetViewMatrix(void) const
+{
+	return glm::translate(glm::mat4(1.0f), glm::vec3(-vec2Centre.x, -vec2Centre.y, 0.0f));
+}
+
+/**
+ @brief Get the rectangle in UV space which is visible in the view
+ @param vec2Min A glm::vec2& variable to store the bottom-left corner of the view
+ @param vec2Max A glm::vec2& variable to store the top-right corner of the view
+ */
+void CCamera2D::GetViewRect(glm::vec2& vec2Min, glm::vec2& vec2Max) const
+{
+	// The view always spans [-1, 1] around its centre
+	vec2Min = vec2Centre - glm::vec2(1.0f);
+	vec2Max = vec2Centre + glm::vec2(1.0f);
+}
+
+/**
+ @brief Get the centre of the view in UV space
+ */
+const glm::vec2& CCamera2D::GetCentre(void) const
+{
+	return vec2Centre;
+}
+
+/**
+ @brief Clamp a value on an axis so that the view does not go past the edges of the map.
+		The map starts at -1 in UV space and extends for fMapSize, while the view is 2 units wide.
+ @param fValue A const float variable containing the value to clamp
+ @param fMapSize A const float variable containing the size of the map in UV space on this axis
+ */
+float CCamera2D::ClampToMap(const float fValue, const float fMapSize) const
+{
+	// Centre the map if it is not larger than the view
+	if (fMapSize <= 2.0f)
+		return -1.0f + fMapSize * 0.5f;
+
+	if (fValue < 0.0f)
+		return 0.0f;
+	if (fValue > fMapSize - 2.0f)
+		return fMapSize - 2.0f;
+	return fValue;
+}
@@ -0,0 +1,53 @@
+/**
+ CCamera2D
+ @brief A class which scrolls the view of the 2D scene to follow a target, without going past the edges of the map
+ By: JH Chong
+ Date: Aug 2022
+ */
+#pragma once
+
+// Include SingletonTemplate
+#include "Singleton\SingletonTemplate.h"
+
+// Include GLM
+#include <includes/glm.hpp>
+#include <includes/gtc/matrix_transform.hpp>
+
+// Include Settings
+#include "GameControl\Settings.h"
+
+class CCamera2D : public CSingletonTemplate<CCamera2D>
+{
+	friend CSingletonTemplate<CCamera2D>;
+public:
+	// Init
+	bool Init(void);
+
+	// Update the view to centre on a position in UV space
+	void Update(const glm::vec2& vec2Target);
+
+	// Get the matrix which converts UV space to the view
+	glm::mat4 GetViewMatrix(void) const;
+
+	// Get the rectangle in UV space which is visible in the view
+	void GetViewRect(glm::vec2& vec2Min, glm::vec2& vec2Max) const;
+
+	// Get the centre of the view in UV space
+	const glm::vec2& GetCentre(void) const;
+
+protected:
+	// The centre of the view in UV space
+	glm::vec2 vec2Centre;
+
+	// Settings
+	CSettings* cSettings;
+
+	// Clamp a value on an axis so that the view does not go past the edges of the map
+	float ClampToMap(const float fValue, const float fMapSize) const;
+
+	// Constructor
+	CCamera2D(void);
+
+	// Destructor
+	virtual ~CCamera2D(void);
+};
@@ -0,0 +1,930 @@
+/**
+ CEnemySystem2D
+ @brief A class which updates and renders all the enemies of the 2D game scene.
+		The enemies are stored as arrays of their fields instead of as objects, so that each part of
+		their update runs as one loop over the arrays, and they are all rendered from one CQuadBatch.
+		An enemy is the index of its entries in the arrays, and of its state in a CStateMachine,
+		which keeps the enemies in each state together so that each state is updated as a batch.
+		The enemies are also kept in a CSpatialHash2D by their tiles, so that the enemies on or near
+		a tile are found without checking every enemy. A CAIScheduler updates the enemies far from the player
+		less often, and spreads their path requests over the frames within a budget and a number in flight.
+		The distance fields which the enemies follow are brought up to date once a frame, and then each enemy
+		chooses its step, is moved, and has its interaction with the map found in one pass in parallel on a CWorkerPool,
+		while the map is only read. The interactions are then made in the order of the enemies,
+		so the result is the same as updating the enemies one at a time.
+ By: JH Chong
+ Date: Aug 2022
+ */
+#include "EnemySystem2D.h"
+
+#include <iostream>
+#include <algorithm>
+using namespace std;
+
+// Include Shader Manager
+#include "RenderControl\ShaderManager.h"
+
+// Include GLEW
+#include <GL/glew.h>
+
+// Include ImageLoader
+#include "System\ImageLoader.h"
+
+// Include Camera2D to render the enemies in the view
+#include "Camera2D.h"
+
+// Include math.h
+#include <math.h>
+
+// The transitions of the states of the enemies.
+// An enemy attacks with MAX_LIVES, flees to a Live with 1 life, and is knocked out with no lives until another enemy
+// gives it a Live. Any enemy which is not knocked out can be sent to support a knocked out enemy
+static const CStateMachine::Transition arrEnemyTransitions[] =
+{
+	{ CEnemySystem2D::ATTACK,			CEnemySystem2D::LIVES_LOW,			CEnemySystem2D::FLEE },
+	{ CEnemySystem2D::ATTACK,			CEnemySystem2D::SUPPORT_REQUESTED,	CEnemySystem2D::FIND_LIVE },
+	{ CEnemySystem2D::FLEE,				CEnemySystem2D::LIVES_FULL,			CEnemySystem2D::ATTACK },
+	{ CEnemySystem2D::FLEE,				CEnemySystem2D::LIVES_NONE,			CEnemySystem2D::KNOCKOUT },
+	{ CEnemySystem2D::FLEE,				CEnemySystem2D::SUPPORT_REQUESTED,	CEnemySystem2D::FIND_LIVE },
+	{ CEnemySystem2D::KNOCKOUT,			CEnemySystem2D::LIVES_LOW,			CEnemySystem2D::FLEE },
+	{ CEnemySystem2D::FIND_LIVE,		CEnemySystem2D::STAGE_DONE,			CEnemySystem2D::TAKE_LIVE },
+	{ CEnemySystem2D::TAKE_LIVE,		CEnemySystem2D::STAGE_DONE,			CEnemySystem2D::REQUEST_ROUTE },
+	{ CEnemySystem2D::REQUEST_ROUTE,	CEnemySystem2D::STAGE_DONE,			CEnemySystem2D::MOVE_TO_SUPPORT },
+	{ CEnemySystem2D::MOVE_TO_SUPPORT,	CEnemySystem2D::STAGE_DONE,			CEnemySystem2D::GIVE_LIVE },
+	{ CEnemySystem2D::GIVE_LIVE,		CEnemySystem2D::STAGE_DONE,			CEnemySystem2D::ATTACK },
+	// The stages of supporting a knocked out enemy, which are all left in the same way
+	{ CEnemySystem2D::FIND_LIVE,		CEnemySystem2D::LIVES_LOW,			CEnemySystem2D::FLEE },
+	{ CEnemySystem2D::FIND_LIVE,		CEnemySystem2D::LIVES_NONE,			CEnemySystem2D::KNOCKOUT },
+	{ CEnemySystem2D::FIND_LIVE,		CEnemySystem2D::SUPPORT_REQUESTED,	CEnemySystem2D::FIND_LIVE },
+	{ CEnemySystem2D::TAKE_LIVE,		CEnemySystem2D::LIVES_LOW,			CEnemySystem2D::FLEE },
+	{ CEnemySystem2D::TAKE_LIVE,		CEnemySystem2D::LIVES_NONE,			CEnemySystem2D::KNOCKOUT },
+	{ CEnemySystem2D::TAKE_LIVE,		CEnemySystem2D::SUPPORT_REQUESTED,	CEnemySystem2D::FIND_LIVE },
+	{ CEnemySystem2D::REQUEST_ROUTE,	CEnemySystem2D::LIVES_LOW,			CEnemySystem2D::FLEE },
+	{ CEnemySystem2D::REQUEST_ROUTE,	CEnemySystem2D::LIVES_NONE,			CEnemySystem2D::KNOCKOUT },
+	{ CEnemySystem2D::REQUEST_ROUTE,	CEnemySystem2D::SUPPORT_REQUESTED,	CEnemySystem2D::FIND_LIVE },
+	{ CEnemySystem2D::MOVE_TO_SUPPORT,	CEnemySystem2D::LIVES_LOW,			CEnemySystem2D::FLEE },
+	{ CEnemySystem2D::MOVE_TO_SUPPORT,	CEnemySystem2D::LIVES_NONE,			CEnemySystem2D::KNOCKOUT },
+	{ CEnemySystem2D::MOVE_TO_SUPPORT,	CEnemySystem2D::SUPPORT_REQUESTED,	CEnemySystem2D::FIND_LIVE },
+	{ CEnemySystem2D::GIVE_LIVE,		CEnemySystem2D::LIVES_LOW,			CEnemySystem2D::FLEE },
+	{ CEnemySystem2D::GIVE_LIVE,		CEnemySystem2D::LIVES_NONE,			CEnemySystem2D::KNOCKOUT },
+	{ CEnemySystem2D::GIVE_LIVE,		CEnemySystem2D::SUPPORT_REQUESTED,	CEnemySystem2D::FIND_LIVE },
+};
+
+// The states in which the enemies move and interact with the map and the player
+static const unsigned int arrActiveStates[] =
+{
+	CEnemySystem2D::ATTACK,
+	CEnemySystem2D::FLEE,
+	CEnemySystem2D::TAKE_LIVE,
+	CEnemySystem2D::MOVE_TO_SUPPORT
+};
+static const unsigned int NUM_ACTIVE_STATES = sizeof(arrActiveStates) / sizeof(arrActiveStates[0]);
+
+/**
+ @brief Constructor This constructor has protected access modifier as this class will be a Singleton
+ */
+CEnemySystem2D::CEnemySystem2D(void)
+	: cMap2D(NULL)
+	, cPlayer2D(NULL)
+	, cSettings(NULL)
+	, NUM_STEPS_PER_TILE_XAXIS_ENEMY(0)
+	, NUM_STEPS_PER_TILE_YAXIS_ENEMY(0)
+	, MICRO_STEP_XAXIS_ENEMY(0.0f)
+	, MICRO_STEP_YAXIS_ENEMY(0.0f)
+	, iTextureID(0)
+	, fAnimationTime(0.0f)
+	, cQuadBatch(NULL)
+	, VAO(0)
+{
+	cFSM.Init(NUM_FSM, NUM_EVENTS, arrEnemyTransitions, sizeof(arrEnemyTransitions) / sizeof(arrEnemyTransitions[0]));
+}
+
+/**
+ @brief Destructor This destructor has protected access modifier as this class will be a Singleton
+ */
+CEnemySystem2D::~CEnemySystem2D(void)
+{
+	// Cancel the route requests. A planner which is still being searched is released by its worker
+	Clear();
+
+	if (cQuadBatch)
+	{
+		delete cQuadBatch;
+		cQuadBatch = NULL;
+	}
+
+	// We won't delete these since they were created elsewhere
+	cPlayer2D = NULL;
+	cMap2D = NULL;
+
+	// optional: de-allocate all resources once they've outlived their purpose:
+	if (VAO != 0)
+		glDeleteVertexArrays(1, &VAO);
+}
+
+/**
+ @brief Set the shader to render the enemies with
+ @param _name A const std::string& variable containing the name of the shader in CShaderManager
+ */
+void CEnemySystem2D::SetShader(const std::string& _name)
+{
+	sShaderName = _name;
+}
+
+/**
+ @brief Init the enemies at the enemy spawn points of the current level. The spawn points are erased from the map
+ @return true if the enemies were initialised, otherwise false
+ */
+bool CEnemySystem2D::Init(void)
+{
+	// Get the handler to the CSettings instance
+	cSettings = &CSettings::GetInstance();
+
+	NUM_STEPS_PER_TILE_XAXIS_ENEMY = (int)cSettings->NUM_STEPS_PER_TILE_XAXIS + 2;
+	NUM_STEPS_PER_TILE_YAXIS_ENEMY = (int)cSettings->NUM_STEPS_PER_TILE_YAXIS + 2;
+
+	MICRO_STEP_XAXIS_ENEMY = cSettings->TILE_WIDTH / NUM_STEPS_PER_TILE_XAXIS_ENEMY;
+	MICRO_STEP_YAXIS_ENEMY = cSettings->TILE_HEIGHT / NUM_STEPS_PER_TILE_YAXIS_ENEMY;
+
+	// Get the handler to the CMap2D instance
+	cMap2D = &CMap2D::GetInstance();
+	cPlayer2D = &CPlayer2D::GetInstance();
+
+	// Add an enemy at each enemy spawn point, and erase the spawn point from arrMapInfo
+	Clear();
+	cEnemyGrid.Init(cSettings->NUM_TILES_XAXIS, cSettings->NUM_TILES_YAXIS);
+	unsigned int uiRow = -1;
+	unsigned int uiCol = -1;
+	while (cMap2D->FindValue(300, uiRow, uiCol))
+	{
+		cMap2D->SetMapInfo(uiRow, uiCol, cMap2D->GetBackgroundInfo(uiRow, uiCol));
+		AddEnemy(glm::vec2(uiCol, uiRow));
+	}
+
+	// Update the enemies on the screen every frame, and the enemies further away less often
+	const unsigned int uiNumViewTiles = glm::max(cSettings->NUM_VIEW_TILES_XAXIS, cSettings->NUM_VIEW_TILES_YAXIS);
+	cScheduler.Init(GetNumEnemies());
+	cScheduler.SetTierDistance(CAIScheduler::TIER_NEAR, uiNumViewTiles * 0.5f);
+	cScheduler.SetTierDistance(CAIScheduler::TIER_MID, (float)uiNumViewTiles);
+	cScheduler.SetReplanBudget(cSettings->AI_REPLAN_BUDGET);
+	cScheduler.SetMaxReplansInFlight(cSettings->AI_MAX_ROUTES_IN_FLIGHT);
+
+	// Start a worker for each hardware thread except the one running the game, with a buffer of moves and interactions for each
+	cWorkerPool.Init();
+	arrTileMoves.assign(cWorkerPool.GetNumThreads(), std::vector<unsigned int>());
+	arrTileInteractions.assign(cWorkerPool.GetNumThreads(), std::vector<unsigned int>());
+
+	// Load the enemy2D texture
+	if (iTextureID == 0)
+	{
+		iTextureID = CImageLoader::GetInstance().LoadTextureGetID("Image/Scene2D/Enemy.png", true);
+		if (iTextureID == 0)
+		{
+			std::cout << "Unable to load Image/Scene2D/Enemy.png" << std::endl;
+			return false;
+		}
+	}
+
+	if (VAO == 0)
+		glGenVertexArrays(1, &VAO);
+	glBindVertexArray(VAO);
+
+	// Create a quad for each enemy, which is replaced with the enemy's position and animation frame when it is rendered
+	if (cQuadBatch == NULL)
+		cQuadBatch = new CQuadBatch();
+	cQuadBatch->Clear();
+	for (unsigned int i = 0; i < GetNumEnemies(); i++)
+		cQuadBatch->AddQuad(glm::vec2(0.0f), glm::vec2(0.0f));
+	cQuadBatch->Upload();
+
+	fAnimationTime = 0.0f;
+
+	return true;
+}
+
+/**
+ @brief Update the enemies. Each part of the update runs over all the enemies before the next part starts.
+		The shared distance fields and the routes are updated on this thread first, then each enemy is updated
+		in one pass on cWorkerPool, and then the enemies interact and change their states on this thread.
+		The time of the update is kept by cScheduler
+ @param dElapsedTime A const double variable containing the time since the last frame
+ */
+void CEnemySystem2D::Update(const double dElapsedTime)
+{
+	cScheduler.BeginFrame();
+
+	UpdateSteps();
+	UpdateEnemies();
+	UpdateInteractions();
+	UpdateFSMs();
+	UpdateSupport();
+
+	// Play the 2 frames of the animation in 1 second, repeating
+	fAnimationTime = fmod(fAnimationTime + (float)dElapsedTime, 1.0f);
+
+	cScheduler.EndFrame();
+}
+
+/**
+ @brief Set up the OpenGL display environment before rendering
+ */
+void CEnemySystem2D::PreRender(void)
+{
+	// bind textures on corresponding texture units
+	glActiveTexture(GL_TEXTURE0);
+
+	// Activate blending mode
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	// Activate the shader
+	CShaderManager::GetInstance().Use(sShaderName);
+}
+
+/**
+ @brief Render all the enemies in one draw call. The quads are in UV space, so only the view of the camera is needed,
+		and a knocked out enemy is coloured red by the colour of its quad
+ */
+void CEnemySystem2D::Render(void)
+{
+	if ((cQuadBatch == NULL) || (GetNumEnemies() == 0))
+		return;
+
+	// The frame of the animation in the 2x2 sprite sheet, from the top row
+	const float fFrame = (fAnimationTime < 0.5f) ? 0.0f : 1.0f;
+	const glm::vec2 vec2UVMin = glm::vec2(fFrame * 0.5f, 0.5f);
+	const glm::vec2 vec2UVMax = glm::vec2(fFrame * 0.5f + 0.5f, 1.0f);
+	const glm::vec2 vec2TileSize = glm::vec2(cSettings->TILE_WIDTH, cSettings->TILE_HEIGHT);
+	for (unsigned int i = 0; i < arrIndices.size(); i++)
+	{
+		cQuadBatch->SetQuad(i, arrUVCoordinates[i], vec2TileSize, vec2UVMin, vec2UVMax,
+							(cFSM.GetState(i) == KNOCKOUT) ? glm::vec4(1.0, 0.0, 0.0, 1.0) : glm::vec4(1.0, 1.0, 1.0, 1.0));
+	}
+	cQuadBatch->UploadQuads(0, GetNumEnemies());
+
+	// get matrix's uniform location and set matrix
+	unsigned int transformLoc = glGetUniformLocation(CShaderManager::GetInstance().activeShader->ID, "transform");
+	unsigned int colorLoc = glGetUniformLocation(CShaderManager::GetInstance().activeShader->ID, "runtimeColour");
+	glm::mat4 transform = CCamera2D::GetInstance().GetViewMatrix();
+	glUniformMatrix4fv(transformLoc, 1, GL_FALSE, glm::value_ptr(transform));
+	glUniform4fv(colorLoc, 1, glm::value_ptr(glm::vec4(1.0, 1.0, 1.0, 1.0)));
+
+	glBindTexture(GL_TEXTURE_2D, iTextureID); // Get the texture to be rendered
+	glBindVertexArray(VAO);
+	cQuadBatch->Render();
+	glBindVertexArray(0);
+}
+
+/**
+ @brief PostRender Set up the OpenGL display environment after rendering.
+ */
+void CEnemySystem2D::PostRender(void)
+{
+	// Disable blending
+	glDisable(GL_BLEND);
+}
+
+/**
+ @brief Get the number of enemies
+ */
+unsigned int CEnemySystem2D::GetNumEnemies(void) const
+{
+	return (unsigned int)arrIndices.size();
+}
+
+/**
+ @brief Get the tile of an enemy
+ @param uiEnemy A const unsigned int variable containing the enemy
+ */
+const glm::vec2& CEnemySystem2D::GetIndex(const unsigned int uiEnemy) const
+{
+	return arrIndices[uiEnemy];
+}
+
+/**
+ @brief Get the state of an enemy
+ @param uiEnemy A const unsigned int variable containing the enemy
+ */
+CEnemySystem2D::FSM CEnemySystem2D::GetFSM(const unsigned int uiEnemy) const
+{
+	return (FSM)cFSM.GetState(uiEnemy);
+}
+
+/**
+ @brief Get the number of lives of an enemy
+ @param uiEnemy A const unsigned int variable containing the enemy
+ */
+int CEnemySystem2D::GetLives(const unsigned int uiEnemy) const
+{
+	return arrLives[uiEnemy];
+}
+
+/**
+ @brief Add to the lives of an enemy, up to MAX_LIVES
+ @param uiEnemy A const unsigned int variable containing the enemy
+ @param iLives A const int variable containing the number of lives to add
+ */
+void CEnemySystem2D::AddLives(const unsigned int uiEnemy, const int iLives)
+{
+	arrLives[uiEnemy] = glm::min(arrLives[uiEnemy] + iLives, static_cast<int>(MAX_LIVES));
+}
+
+/**
+ @brief Get the scheduler of the enemies, to show its times in the HUD
+ */
+const CAIScheduler& CEnemySystem2D::GetScheduler(void) const
+{
+	return cScheduler;
+}
+
+/**
+ @brief Remove all the enemies
+ */
+void CEnemySystem2D::Clear(void)
+{
+	// A planner whose request is still being searched is deleted by the worker when the search finishes
+	for (unsigned int i = 0; i < arrRoutePlanners.size(); i++)
+	{
+		if (cMap2D)
+			cMap2D->CancelPath(arrRouteRequests[i]);
+	}
+
+	arrIndices.clear();
+	cEnemyGrid.Clear();
+	arrMicroSteps.clear();
+	arrUVCoordinates.clear();
+	cFSM.Clear();
+	cScheduler.Init(0);
+	arrLives.clear();
+	arrCarriedLives.clear();
+	arrGotSupport.clear();
+	arrNearestLives.clear();
+	arrSupportPositions.clear();
+	arrSteps.clear();
+	arrHasStep.clear();
+	arrRoutes.clear();
+	arrRouteCursors.clear();
+	arrRoutePlanners.clear();
+	arrRouteRequests.clear();
+	arrRouteRevisions.clear();
+}
+
+/**
+ @brief Add an enemy at a tile
+ @param vec2Index A const glm::vec2& variable containing the tile, with the row counted from the bottom of the map
+ */
+void CEnemySystem2D::AddEnemy(const glm::vec2& vec2Index)
+{
+	cEnemyGrid.Insert((unsigned int)arrIndices.size(), (int)vec2Index.x, (int)vec2Index.y);
+	arrIndices.push_back(vec2Index);
+	// By default, microsteps should be zero
+	arrMicroSteps.push_back(glm::i32vec2(0, 0));
+	arrUVCoordinates.push_back(glm::vec2(cSettings->ConvertIndexToUVSpace(cSettings->x, vec2Index.x, false, 0),
+										 cSettings->ConvertIndexToUVSpace(cSettings->y, vec2Index.y, false, 0)));
+	cFSM.AddInstance(ATTACK);
+	arrLives.push_back(static_cast<int>(MAX_LIVES));
+	arrCarriedLives.push_back(0);
+	arrGotSupport.push_back(false);
+	arrNearestLives.push_back(glm::vec2(1000, 1000));
+	arrSupportPositions.push_back(glm::vec2(-1, -1));
+	arrSteps.push_back(vec2Index);
+	arrHasStep.push_back(false);
+	arrRoutes.push_back(std::vector<glm::vec2>());
+	arrRouteCursors.push_back(0);
+	arrRoutePlanners.push_back(std::shared_ptr<CDStarLite>());
+	arrRouteRequests.push_back(CPathJobQueue::JOB_NONE);
+	arrRouteRevisions.push_back(0);
+}
+
+/**
+ @brief Check if a state is a stage of supporting a knocked out enemy
+ @param uiState A const unsigned int variable containing the state
+ */
+bool CEnemySystem2D::IsSupportState(const unsigned int uiState)
+{
+	return (uiState >= FIND_LIVE) && (uiState <= GIVE_LIVE);
+}
+
+/**
+ @brief Check if a state is one in which the enemies move and interact with the player and the map
+ @param uiState A const unsigned int variable containing the state
+ */
+bool CEnemySystem2D::IsActiveState(const unsigned int uiState)
+{
+	for (unsigned int uiActiveState = 0; uiActiveState < NUM_ACTIVE_STATES; uiActiveState++)
+	{
+		if (arrActiveStates[uiActiveState] == uiState)
+			return true;
+	}
+	return false;
+}
+
+/**
+ @brief Bring the distance fields which are shared in CMap2D up to date, and choose the steps of the supporting enemies
+		which request their routes, which all change shared data and so are done on this thread before UpdateEnemies().
+		The chasing, fleeing and Live taking enemies choose their steps in UpdateEnemies() from the fields prepared here.
+		The routes to the knocked out enemies are queued in cScheduler, and requested while the budget of the frame
+		and the number of routes in flight allow. The enemies which are queued here are due by their tiers of the last frame
+ */
+void CEnemySystem2D::UpdateSteps(void)
+{
+	// Build the fields from the player and from the Lives once, so that the enemies only read them in parallel
+	cMap2D->PrepareChaseField(cPlayer2D->vec2Index);
+	cMap2D->PrepareValueField(5);
+
+	// Find the nearest Live to take to the knocked out enemy
+	const std::vector<unsigned int>& vecFindingLive = cFSM.GetInstances(FIND_LIVE);
+	for (unsigned int k = 0; k < vecFindingLive.size(); k++)
+	{
+		const unsigned int i = vecFindingLive[k];
+		arrRoutes[i].clear();
+		arrHasStep[i] = false;
+		FindNearestLive(i);
+	}
+
+	// Request the route to the enemy which needs support, which is repaired in the background
+	const std::vector<unsigned int>& vecRequestingRoute = cFSM.GetInstances(REQUEST_ROUTE);
+	for (unsigned int k = 0; k < vecRequestingRoute.size(); k++)
+	{
+		const unsigned int i = vecRequestingRoute[k];
+		// The cancelled request may still be searched with the planner, so a new planner is made instead of waiting for it
+		cMap2D->CancelPath(arrRouteRequests[i]);
+		cScheduler.FinishReplan(i);
+		arrRouteRequests[i] = CPathJobQueue::JOB_NONE;
+		if ((arrRoutePlanners[i]) && (!cMap2D->IsPlannerBusy(arrRoutePlanners[i].get())))
+			arrRoutePlanners[i]->Reset();
+		else
+			arrRoutePlanners[i] = std::make_shared<CDStarLite>();
+		arrRoutes[i].clear();
+		arrHasStep[i] = false;
+		cScheduler.QueueReplan(i);
+	}
+
+	const std::vector<unsigned int>& vecMovingToSupport = cFSM.GetInstances(MOVE_TO_SUPPORT);
+	for (unsigned int k = 0; k < vecMovingToSupport.size(); k++)
+	{
+		const unsigned int i = vecMovingToSupport[k];
+
+		// Take the route once it has been repaired in the background.
+		// The enemy may have moved on since it was requested, so skip the tiles which it has already reached
+		if ((arrRouteRequests[i] != CPathJobQueue::JOB_NONE) &&
+			(cMap2D->CollectPath(arrRouteRequests[i], arrRoutes[i]) != CPathJobQueue::JOB_PENDING))
+		{
+			arrRouteRequests[i] = CPathJobQueue::JOB_NONE;
+			cScheduler.FinishReplan(i);
+			std::vector<glm::vec2>::iterator it = std::find(arrRoutes[i].begin(), arrRoutes[i].end(), arrIndices[i]);
+			arrRouteCursors[i] = (it != arrRoutes[i].end()) ? (unsigned int)(it - arrRoutes[i].begin()) + 1 : 0;
+			NextStep(i);
+		}
+
+		// Repair the route once the tiles have changed since it was requested, so that it goes around them
+		if ((arrRouteRequests[i] == CPathJobQueue::JOB_NONE) && (arrIndices[i] != arrSupportPositions[i]) &&
+			(arrRouteRevisions[i] != cMap2D->GetNavRevision()) && (cScheduler.IsDue(i)))
+			cScheduler.QueueReplan(i);
+	}
+
+	cScheduler.RunReplans([this](const unsigned int uiEnemy) { return RequestRoute(uiEnemy); });
+}
+
+/**
+ @brief Update each enemy in one pass on cWorkerPool: its tier, its step, its move and the UV coordinates to render it.
+		An enemy only changes its own data, and only reads the map and the fields prepared in UpdateSteps(),
+		so the enemies can be updated in any order. Each chunk of the enemies keeps the enemies which reach another tile,
+		and the active enemies which may interact with their tiles, in its own buffers, and the enemies which reached
+		another tile are then moved to that tile in cEnemyGrid on this thread
+ */
+void CEnemySystem2D::UpdateEnemies(void)
+{
+	const unsigned int uiNumEnemies = (unsigned int)arrIndices.size();
+	cWorkerPool.ParallelFor(uiNumEnemies, MIN_ENEMIES_PER_CHUNK,
+		[this](const unsigned int uiBegin, const unsigned int uiEnd, const unsigned int uiChunk)
+		{
+			arrTileMoves[uiChunk].clear();
+			arrTileInteractions[uiChunk].clear();
+			for (unsigned int i = uiBegin; i < uiEnd; i++)
+				UpdateEnemy(i, uiChunk);
+		});
+
+	const unsigned int uiNumChunks = cWorkerPool.GetNumChunks(uiNumEnemies, MIN_ENEMIES_PER_CHUNK);
+	for (unsigned int uiChunk = 0; uiChunk < uiNumChunks; uiChunk++)
+	{
+		const std::vector<unsigned int>& vecMoves = arrTileMoves[uiChunk];
+		for (unsigned int k = 0; k < vecMoves.size(); k++)
+		{
+			const unsigned int i = vecMoves[k];
+			cEnemyGrid.Move(i, (int)arrIndices[i].x, (int)arrIndices[i].y);
+		}
+	}
+}
+
+/**
+ @brief Update an enemy on a worker of cWorkerPool. The enemy is put in the tier of its distance from the player in tiles,
+		and if it is in an active state and cScheduler updates it in this frame, a chasing, fleeing or Live taking enemy
+		takes one step at a time from the prepared distance fields. The step being taken is finished first,
+		so that an enemy does not turn back in the middle of a tile. An enemy which cScheduler updates every few frames
+		moves by a microstep for each of those frames, so that it keeps its speed, but stops at the next tile
+		so that it does not pass a tile without interacting with it
+ @param uiEnemy A const unsigned int variable containing the enemy
+ @param uiChunk A const unsigned int variable containing the chunk of the enemy, whose buffers the enemy is added to
+ */
+void CEnemySystem2D::UpdateEnemy(const unsigned int uiEnemy, const unsigned int uiChunk)
+{
+	const glm::vec2 vec2Distance = glm::abs(arrIndices[uiEnemy] - cPlayer2D->vec2Index);
+	cScheduler.SetDistance(uiEnemy, glm::max(vec2Distance.x, vec2Distance.y));
+
+	const unsigned int uiState = cFSM.GetState(uiEnemy);
+	if ((IsActiveState(uiState)) && (cScheduler.IsDue(uiEnemy)))
+	{
+		if (!arrHasStep[uiEnemy])
+		{
+			glm::vec2 vec2NextStep;
+			switch (uiState)
+			{
+			case ATTACK:
+				// Take one step at a time towards the player
+				arrHasStep[uiEnemy] = cMap2D->GetNextStepInChaseField(cPlayer2D->vec2Index, arrIndices[uiEnemy], vec2NextStep);
+				break;
+
+			case FLEE:
+				// Take one step at a time towards the nearest Live by path.
+				// The field is kept up to date as Lives are taken and respawned, so the enemy turns to another Live when its Live is taken
+				arrHasStep[uiEnemy] = cMap2D->GetNextStepInValueField(5, arrIndices[uiEnemy], vec2NextStep);
+				break;
+
+			case TAKE_LIVE:
+				// Move to the nearest Live, one step at a time from the distance field of the Lives
+				if (cMap2D->FindNearestValueInField(5, arrIndices[uiEnemy], vec2NextStep))
+					arrNearestLives[uiEnemy] = vec2NextStep;
+				arrHasStep[uiEnemy] = cMap2D->GetNextStepInValueField(5, arrIndices[uiEnemy], vec2NextStep);
+				break;
+
+			default:
+				break;
+			}
+			if (arrHasStep[uiEnemy])
+				arrSteps[uiEnemy] = vec2NextStep;
+		}
+
+		const glm::vec2 vec2OldIndex = arrIndices[uiEnemy];
+		for (unsigned int uiFrame = 0; (uiFrame < cScheduler.GetInterval(uiEnemy)) && (arrHasStep[uiEnemy]) && (arrIndices[uiEnemy] == vec2OldIndex); uiFrame++)
+			MoveToStep(uiEnemy);
+		if (arrIndices[uiEnemy] != vec2OldIndex)
+			arrTileMoves[uiChunk].push_back(uiEnemy);
+
+		// Keep the enemies on a Live or a spike, which interact with their tiles on the game thread
+		const int iTileValue = cMap2D->GetMapInfo(arrIndices[uiEnemy].y, arrIndices[uiEnemy].x);
+		if ((iTileValue == 5) || (iTileValue == 55))
+			arrTileInteractions[uiChunk].push_back(uiEnemy);
+	}
+
+	arrUVCoordinates[uiEnemy].x = cSettings->ConvertIndexToUVSpace(cSettings->x, arrIndices[uiEnemy].x, false, arrMicroSteps[uiEnemy].x * MICRO_STEP_XAXIS_ENEMY);
+	arrUVCoordinates[uiEnemy].y = cSettings->ConvertIndexToUVSpace(cSettings->y, arrIndices[uiEnemy].y, false, arrMicroSteps[uiEnemy].y * MICRO_STEP_YAXIS_ENEMY);
+}
+
+/**
+ @brief Move an enemy by a microstep towards its step.
+		When the enemy reaches its step, it settles onto the ground or the ladder of the tile before taking the next step
+ @param uiEnemy A const unsigned int variable containing the enemy
+ */
+void CEnemySystem2D::MoveToStep(const unsigned int uiEnemy)
+{
+	glm::vec2& vec2Index = arrIndices[uiEnemy];
+	glm::i32vec2& i32vec2NumMicroSteps = arrMicroSteps[uiEnemy];
+	const glm::vec2 dir = (arrSteps[uiEnemy] - vec2Index);
+
+	if (dir.x < 0)
+	{
+		if (vec2Index.x >= 0)
+		{
+			i32vec2NumMicroSteps.x--;
+			if (i32vec2NumMicroSteps.x < 0)
+			{
+				i32vec2NumMicroSteps.x = NUM_STEPS_PER_TILE_XAXIS_ENEMY;
+				vec2Index.x--;
+			}
+		}
+	}
+	else if (dir.x > 0)
+	{
+		if (vec2Index.x < (int)cSettings->NUM_TILES_XAXIS)
+		{
+			i32vec2NumMicroSteps.x++;
+			if (i32vec2NumMicroSteps.x >= NUM_STEPS_PER_TILE_XAXIS_ENEMY)
+			{
+				i32vec2NumMicroSteps.x = 0;
+				vec2Index.x++;
+			}
+		}
+	}
+
+	if (dir.y < 0)
+	{
+		if (vec2Index.y >= 0)
+		{
+			i32vec2NumMicroSteps.y--;
+			if (i32vec2NumMicroSteps.y < 0)
+			{
+				i32vec2NumMicroSteps.y = NUM_STEPS_PER_TILE_YAXIS_ENEMY;
+				vec2Index.y--;
+			}
+		}
+	}
+	else if (dir.y > 0)
+	{
+		if (vec2Index.y < (int)cSettings->NUM_TILES_YAXIS)
+		{
+			i32vec2NumMicroSteps.y++;
+			if (i32vec2NumMicroSteps.y >= NUM_STEPS_PER_TILE_YAXIS_ENEMY)
+			{
+				i32vec2NumMicroSteps.y = 0;
+				vec2Index.y++;
+			}
+		}
+	}
+
+	if ((round(vec2Index.y) == round(arrSteps[uiEnemy].y)) &&
+		(round(vec2Index.x) == round(arrSteps[uiEnemy].x)))
+	{
+		if ((cMap2D->GetMapInfo(vec2Index.y - 1, vec2Index.x) >= 100) &&
+			(cMap2D->GetMapInfo(vec2Index.y - 1, vec2Index.x) <= 120))
+		{
+			i32vec2NumMicroSteps.y--;
+			if (i32vec2NumMicroSteps.y < 0)
+			{
+				i32vec2NumMicroSteps.y = 0;
+				NextStep(uiEnemy);
+			}
+		}
+		else if ((cMap2D->GetMapInfo(vec2Index.y, vec2Index.x) >= 30) &&
+				 (cMap2D->GetMapInfo(vec2Index.y, vec2Index.x) <= 36))
+		{
+			i32vec2NumMicroSteps.x--;
+			if (i32vec2NumMicroSteps.x < 0)
+			{
+				i32vec2NumMicroSteps.x = 0;
+				NextStep(uiEnemy);
+			}
+		}
+		else
+		{
+			NextStep(uiEnemy);
+		}
+	}
+}
+
+/**
+ @brief Let each active enemy interact with the player and the map.
+		Each active enemy on the player's tile takes a life from the player, unless the player is invisible,
+		which only checks the enemies in the player's tile of cEnemyGrid.
+		The enemies on a Live or a spike were found in UpdateEnemies(), in the buffer of each chunk of the enemies.
+		The buffers are joined in the order of the chunks, which is the order of the enemies, and each enemy interacts
+		with its tile on this thread. The tile is read again at that point, as an enemy before it may have taken
+		the same Live or spike, so the result is the same as checking the enemies one at a time.
+		The tiles are checked in the frames in which cScheduler updates the enemy
+ */
+void CEnemySystem2D::UpdateInteractions(void)
+{
+	const glm::vec2 vec2PlayerIndex = cPlayer2D->vec2Index;
+	if (!cPlayer2D->GetInvisibility())
+	{
+		for (unsigned int i = cEnemyGrid.GetFirst((int)vec2PlayerIndex.x, (int)vec2PlayerIndex.y);
+			 i != CSpatialHash2D::NONE;
+			 i = cEnemyGrid.GetNext(i))
+		{
+			if ((arrIndices[i] == vec2PlayerIndex) && (IsActiveState(cFSM.GetState(i))))
+				cPlayer2D->AddLives(-1);
+		}
+	}
+
+	const unsigned int uiNumChunks = cWorkerPool.GetNumChunks((unsigned int)arrIndices.size(), MIN_ENEMIES_PER_CHUNK);
+	for (unsigned int uiChunk = 0; uiChunk < uiNumChunks; uiChunk++)
+	{
+		const std::vector<unsigned int>& vecInteractions = arrTileInteractions[uiChunk];
+		for (unsigned int k = 0; k < vecInteractions.size(); k++)
+			InteractWithTile(vecInteractions[k]);
+	}
+}
+
+/**
+ @brief Let an enemy interact with its tile.
+		A fleeing enemy takes a Live for itself, a supporting enemy carries a Live to the enemy which it supports,
+		and a spike takes a life from any enemy
+ @param uiEnemy A const unsigned int variable containing the enemy
+ */
+void CEnemySystem2D::InteractWithTile(const unsigned int uiEnemy)
+{
+	const unsigned int uiState = cFSM.GetState(uiEnemy);
+	switch (cMap2D->GetMapInfo(arrIndices[uiEnemy].y, arrIndices[uiEnemy].x))
+	{
+	case 5:
+		if (uiState == FLEE)
+		{
+			ClearTile(uiEnemy);
+			++arrLives[uiEnemy];
+		}
+		else if ((IsSupportState(uiState)) && (arrCarriedLives[uiEnemy] < MAX_CARRIED_LIVES))
+		{
+			ClearTile(uiEnemy);
+			++arrCarriedLives[uiEnemy];
+		}
+		break;
+
+	case 55:
+		ClearTile(uiEnemy);
+		--arrLives[uiEnemy];
+		break;
+
+	default:
+		break;
+	}
+}
+
+/**
+ @brief Raise the events which change the states of the enemies, from their lives and positions, and make the transitions.
+		The events from the lives of an enemy are raised last, so they replace the end of a stage of supporting
+ */
+void CEnemySystem2D::UpdateFSMs(void)
+{
+	// The stages which are done in one frame
+	const std::vector<unsigned int>& vecFindingLive = cFSM.GetInstances(FIND_LIVE);
+	for (unsigned int k = 0; k < vecFindingLive.size(); k++)
+		cFSM.Raise(vecFindingLive[k], STAGE_DONE);
+	const std::vector<unsigned int>& vecRequestingRoute = cFSM.GetInstances(REQUEST_ROUTE);
+	for (unsigned int k = 0; k < vecRequestingRoute.size(); k++)
+		cFSM.Raise(vecRequestingRoute[k], STAGE_DONE);
+
+	// The stages which are done when the enemy arrives
+	const std::vector<unsigned int>& vecTakingLive = cFSM.GetInstances(TAKE_LIVE);
+	for (unsigned int k = 0; k < vecTakingLive.size(); k++)
+	{
+		const unsigned int i = vecTakingLive[k];
+		if (arrIndices[i] == arrNearestLives[i])
+			cFSM.Raise(i, STAGE_DONE);
+	}
+	const std::vector<unsigned int>& vecMovingToSupport = cFSM.GetInstances(MOVE_TO_SUPPORT);
+	for (unsigned int k = 0; k < vecMovingToSupport.size(); k++)
+	{
+		const unsigned int i = vecMovingToSupport[k];
+		if (arrIndices[i] == arrSupportPositions[i])
+			cFSM.Raise(i, STAGE_DONE);
+	}
+
+	// Give the carried Live to the knocked out enemy on the support position, and go back to attacking
+	const std::vector<unsigned int>& vecGivingLive = cFSM.GetInstances(GIVE_LIVE);
+	for (unsigned int k = 0; k < vecGivingLive.size(); k++)
+	{
+		const unsigned int i = vecGivingLive[k];
+		if (arrCarriedLives[i] > 0)
+			--arrCarriedLives[i];
+		const glm::vec2& vec2SupportPosition = arrSupportPositions[i];
+		for (unsigned int j = cEnemyGrid.GetFirst((int)vec2SupportPosition.x, (int)vec2SupportPosition.y);
+			 j != CSpatialHash2D::NONE;
+			 j = cEnemyGrid.GetNext(j))
+		{
+			if ((arrIndices[j] == vec2SupportPosition) && (cFSM.GetState(j) == KNOCKOUT))
+			{
+				AddLives(j, 1);
+				break;
+			}
+		}
+		cFSM.Raise(i, STAGE_DONE);
+	}
+
+	for (unsigned int i = 0; i < arrLives.size(); i++)
+	{
+		if (arrLives[i] >= MAX_LIVES)
+			cFSM.Raise(i, LIVES_FULL);
+		else if (arrLives[i] == 1)
+			cFSM.Raise(i, LIVES_LOW);
+		else if (arrLives[i] <= 0)
+			cFSM.Raise(i, LIVES_NONE);
+	}
+
+	ApplyTransitions();
+}
+
+/**
+ @brief Send an enemy to support each enemy which has been knocked out,
+		which is the nearest enemy by tiles that is not knocked out, found by searching outwards in cEnemyGrid
+ */
+void CEnemySystem2D::UpdateSupport(void)
+{
+	auto isNotKnockedOut = [this](const unsigned int uiEnemy)
+	{
+		return cFSM.GetState(uiEnemy) != KNOCKOUT;
+	};
+
+	const std::vector<unsigned int>& vecKnockedOut = cFSM.GetInstances(KNOCKOUT);
+	for (unsigned int k = 0; k < vecKnockedOut.size(); k++)
+	{
+		const unsigned int i = vecKnockedOut[k];
+		if (arrGotSupport[i])
+			continue;
+
+		const unsigned int j = cEnemyGrid.FindNearest((int)arrIndices[i].x, (int)arrIndices[i].y, isNotKnockedOut);
+		if (j != CSpatialHash2D::NONE)
+		{
+			arrGotSupport[i] = true;
+			arrSupportPositions[j] = arrIndices[i];
+			cFSM.Raise(j, SUPPORT_REQUESTED);
+		}
+	}
+
+	ApplyTransitions();
+}
+
+/**
+ @brief Make the transitions of the events which have been raised, and start and end the states which have changed.
+		An enemy which stops supporting, or is sent to support another enemy, cancels its route,
+		and an enemy which is knocked out waits for another enemy to be sent to support it
+ */
+void CEnemySystem2D::ApplyTransitions(void)
+{
+	const std::vector<CStateMachine::StateChange>& vecChanges = cFSM.ApplyTransitions();
+	for (unsigned int k = 0; k < vecChanges.size(); k++)
+	{
+		const CStateMachine::StateChange& change = vecChanges[k];
+		if ((IsSupportState(change.uiFrom)) && ((!IsSupportState(change.uiTo)) || (change.uiTo == FIND_LIVE)))
+			EndSupport(change.uiInstance);
+		if (change.uiTo == KNOCKOUT)
+			arrGotSupport[change.uiInstance] = false;
+	}
+}
+
+/**
+ @brief Request the route of an enemy to the knocked out enemy which it supports, which is repaired in the background.
+		The enemy stops following its route if the tiles have changed so that the support position cannot be reached
+ @param uiEnemy A const unsigned int variable containing the enemy
+ @return true if the route is being searched in the background
+ */
+bool CEnemySystem2D::RequestRoute(const unsigned int uiEnemy)
+{
+	// A planner which is still searching a cancelled request is left to it
+	if ((!arrRoutePlanners[uiEnemy]) || (cMap2D->IsPlannerBusy(arrRoutePlanners[uiEnemy].get())))
+		arrRoutePlanners[uiEnemy] = std::make_shared<CDStarLite>();
+
+	arrRouteRevisions[uiEnemy] = cMap2D->GetNavRevision();
+	arrRouteRequests[uiEnemy] = cMap2D->RequestPath(arrIndices[uiEnemy], arrSupportPositions[uiEnemy], arrRoutePlanners[uiEnemy]);
+	if (arrRouteRequests[uiEnemy] == CPathJobQueue::JOB_NONE)
+	{
+		arrRoutes[uiEnemy].clear();
+		arrHasStep[uiEnemy] = false;
+		return false;
+	}
+	return true;
+}
+
+/**
+ @brief Take the next tile of the route of an enemy as its step, or stop the enemy at the end of its route
+ @param uiEnemy A const unsigned int variable containing the enemy
+ */
+void CEnemySystem2D::NextStep(const unsigned int uiEnemy)
+{
+	if (arrRouteCursors[uiEnemy] < arrRoutes[uiEnemy].size())
+	{
+		arrSteps[uiEnemy] = arrRoutes[uiEnemy][arrRouteCursors[uiEnemy]];
+		arrRouteCursors[uiEnemy]++;
+		arrHasStep[uiEnemy] = true;
+	}
+	else
+	{
+		arrHasStep[uiEnemy] = false;
+	}
+}
+
+/**
+ @brief Stop an enemy from supporting another, and cancel its route and its queued request for it.
+		The support position is kept, as it has already been replaced if the enemy is sent to support another enemy
+ @param uiEnemy A const unsigned int variable containing the enemy
+ */
+void CEnemySystem2D::EndSupport(const unsigned int uiEnemy)
+{
+	cMap2D->CancelPath(arrRouteRequests[uiEnemy]);
+	cScheduler.CancelReplan(uiEnemy);
+	cScheduler.FinishReplan(uiEnemy);
+	arrRouteRequests[uiEnemy] = CPathJobQueue::JOB_NONE;
+	arrRoutes[uiEnemy].clear();
+	arrRouteCursors[uiEnemy] = 0;
+	arrNearestLives[uiEnemy] = glm::vec2(1000, 1000);
+}
+
+/**
+ @brief Restore the background of the tile of an enemy
+ @param uiEnemy A const unsigned int variable containing the enemy
+ */
+void CEnemySystem2D::ClearTile(const unsigned int uiEnemy) const
+{
+	const glm::vec2& vec2Index = arrIndices[uiEnemy];
+	cMap2D->SetMapInfo(vec2Index.y, vec2Index.x, cMap2D->GetBackgroundInfo(vec2Index.y, vec2Index.x));
+}
+
+/**
+ @brief Find the nearest Live of an enemy by path, from the distance field of the Lives which are available in CMap2D
+ @param uiEnemy A const unsigned int variable containing the enemy
+ */
+void CEnemySystem2D::FindNearestLive(const unsigned int uiEnemy)
+{
+	glm::vec2 vec2Live;
+	if (cMap2D->FindNearestValueByPath(5, arrIndices[uiEnemy], vec2Live))
+		arrNearestLives[uiEnemy] = vec2Live;
+}
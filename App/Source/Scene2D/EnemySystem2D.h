@@ -0,0 +1,251 @@
+/**
+ CEnemySystem2D
+ @brief A class which updates and renders all the enemies of the 2D game scene.
+		The enemies are stored as arrays of their fields instead of as objects, so that each part of
+		their update runs as one loop over the arrays, and they are all rendered from one CQuadBatch.
+		An enemy is the index of its entries in the arrays, and of its state in a CStateMachine,
+		which keeps the enemies in each state together so that each state is updated as a batch.
+		The enemies are also kept in a CSpatialHash2D by their tiles, so that the enemies on or near
+		a tile are found without checking every enemy. A CAIScheduler updates the enemies far from the player
+		less often, and spreads their path requests over the frames within a budget and a number in flight.
+		The distance fields which the enemies follow are brought up to date once a frame, and then each enemy
+		chooses its step, is moved, and has its interaction with the map found in one pass in parallel on a CWorkerPool,
+		while the map is only read. The interactions are then made in the order of the enemies,
+		so the result is the same as updating the enemies one at a time.
+ By: JH Chong
+ Date: Aug 2022
+ */
+#pragma once
+
+// Include SingletonTemplate
+#include "Singleton/SingletonTemplate.h"
+
+// Include GLM
+#include <includes/glm.hpp>
+#include <includes/gtc/matrix_transform.hpp>
+#include <includes/gtc/type_ptr.hpp>
+
+// Include QuadBatch
+#include "Primitives/QuadBatch.h"
+
+// Include the Map2D as we will use it to check the enemies' movements and actions
+#include "Map2D.h"
+
+// Include Player2D
+#include "Player2D.h"
+
+// Include Settings
+#include "GameControl\Settings.h"
+
+// Include DStarLite
+#include "Pathfinding/DStarLite.h"
+
+// Include StateMachine
+#include "FSM/StateMachine.h"
+
+// Include SpatialHash2D
+#include "Primitives/SpatialHash2D.h"
+
+// Include AIScheduler
+#include "FSM/AIScheduler.h"
+
+// Include WorkerPool
+#include "System/WorkerPool.h"
+
+#include <vector>
+#include <string>
+#include <memory>
+
+class CEnemySystem2D : public CSingletonTemplate<CEnemySystem2D>
+{
+	friend CSingletonTemplate<CEnemySystem2D>;
+public:
+	// The states of an enemy. The states from FIND_LIVE to GIVE_LIVE are the stages of supporting a knocked out enemy
+	enum FSM
+	{
+		ATTACK = 0,
+		FLEE,
+		KNOCKOUT,
+		// Find the nearest Live
+		FIND_LIVE,
+		// Move to the nearest Live and take it
+		TAKE_LIVE,
+		// Request the route to the knocked out enemy
+		REQUEST_ROUTE,
+		// Move to the knocked out enemy
+		MOVE_TO_SUPPORT,
+		// Give the Live to the knocked out enemy
+		GIVE_LIVE,
+		NUM_FSM
+	};
+
+	// The events which change the states of the enemies, see the transitions in EnemySystem2D.cpp
+	enum EVENT
+	{
+		// The enemy has MAX_LIVES, 1 life, or no lives
+		LIVES_FULL = 0,
+		LIVES_LOW,
+		LIVES_NONE,
+		// The enemy has finished its stage of supporting a knocked out enemy
+		STAGE_DONE,
+		// The enemy has been sent to support a knocked out enemy
+		SUPPORT_REQUESTED,
+		NUM_EVENTS
+	};
+
+	// The number of lives of a new enemy, and the most lives which an enemy can have
+	static const int MAX_LIVES = 2;
+	// The number of Lives which an enemy can carry to a knocked out enemy
+	static const unsigned char MAX_CARRIED_LIVES = 1;
+
+	// Set the shader to render the enemies with
+	void SetShader(const std::string& _name);
+
+	// Init the enemies at the enemy spawn points of the current level
+	bool Init(void);
+
+	// Update
+	void Update(const double dElapsedTime);
+
+	// PreRender
+	void PreRender(void);
+
+	// Render
+	void Render(void);
+
+	// PostRender
+	void PostRender(void);
+
+	// Get the number of enemies
+	unsigned int GetNumEnemies(void) const;
+
+	// Get the tile of an enemy
+	const glm::vec2& GetIndex(const unsigned int uiEnemy) const;
+	// Get the state of an enemy
+	FSM GetFSM(const unsigned int uiEnemy) const;
+	// Get the number of lives of an enemy
+	int GetLives(const unsigned int uiEnemy) const;
+	// Add to the lives of an enemy, up to MAX_LIVES
+	void AddLives(const unsigned int uiEnemy, const int iLives);
+
+	// Get the scheduler of the enemies, to show its times in the HUD
+	const CAIScheduler& GetScheduler(void) const;
+
+protected:
+	// The fewest enemies which are updated on each thread, so that a few enemies are updated without waking the workers
+	static const unsigned int MIN_ENEMIES_PER_CHUNK = 64;
+
+	// The shader to render the enemies with
+	std::string sShaderName;
+
+	// Handler to the CMap2D instance
+	CMap2D* cMap2D;
+
+	// Handle to the CPlayer2D
+	CPlayer2D* cPlayer2D;
+
+	// Settings
+	CSettings* cSettings;
+
+	// The number of microsteps to cross a tile, and the size of a microstep in UV space, which are the same for every enemy
+	int NUM_STEPS_PER_TILE_XAXIS_ENEMY;
+	int NUM_STEPS_PER_TILE_YAXIS_ENEMY;
+	float MICRO_STEP_XAXIS_ENEMY;
+	float MICRO_STEP_YAXIS_ENEMY;
+
+	// The tile of each enemy in the Map2D
+	std::vector<glm::vec2> arrIndices;
+	// The enemies on each tile, which is updated whenever an enemy moves to another tile
+	CSpatialHash2D cEnemyGrid;
+	// The number of microsteps of each enemy from its tile. A tile's width or height is in multiples of these microsteps
+	std::vector<glm::i32vec2> arrMicroSteps;
+	// The UV coordinates to render each enemy
+	std::vector<glm::vec2> arrUVCoordinates;
+	// The state of each enemy, and the enemies in each state
+	CStateMachine cFSM;
+	// The tier of each enemy by its distance from the player, and the queue of the routes to request
+	CAIScheduler cScheduler;
+	// The workers which update the enemies
+	CWorkerPool cWorkerPool;
+	// The enemies which moved to another tile, and the enemies which interact with their tiles, found by each chunk of the enemies
+	std::vector<std::vector<unsigned int>> arrTileMoves;
+	std::vector<std::vector<unsigned int>> arrTileInteractions;
+	// The lives of each enemy, and the number of Lives which it is carrying to a knocked out enemy
+	std::vector<int> arrLives;
+	std::vector<unsigned char> arrCarriedLives;
+	// Whether another enemy has been sent to support each knocked out enemy
+	std::vector<unsigned char> arrGotSupport;
+	// The nearest Live of each supporting enemy, and the tile of the knocked out enemy which it supports
+	std::vector<glm::vec2> arrNearestLives;
+	std::vector<glm::vec2> arrSupportPositions;
+
+	// The tile which each enemy is moving to, if arrHasStep is set
+	std::vector<glm::vec2> arrSteps;
+	std::vector<unsigned char> arrHasStep;
+	// The route of each supporting enemy, and the cursor of the next tile in it after the step
+	std::vector<std::vector<glm::vec2>> arrRoutes;
+	std::vector<unsigned int> arrRouteCursors;
+	// The planner which repairs the route of each enemy, which is only created when the enemy first supports another,
+	// and the request to repair the route in the background, which shares the planner until its search finishes
+	std::vector<std::shared_ptr<CDStarLite>> arrRoutePlanners;
+	std::vector<unsigned int> arrRouteRequests;
+	// The revision of the navigation grid when the route of each enemy was last requested,
+	// so that the route is only repaired again once the tiles have changed
+	std::vector<unsigned int> arrRouteRevisions;
+
+	// The texture of the enemies, and the time of their animation, which all the enemies play together
+	unsigned int iTextureID;
+	float fAnimationTime;
+	// The quads of the enemies, with one quad for each enemy
+	CQuadBatch* cQuadBatch;
+	// The vertex array object which cQuadBatch is drawn with
+	unsigned int VAO;
+
+	// Constructor
+	CEnemySystem2D(void);
+
+	// Destructor
+	virtual ~CEnemySystem2D(void);
+
+	// Remove all the enemies
+	void Clear(void);
+
+	// Add an enemy at a tile
+	void AddEnemy(const glm::vec2& vec2Index);
+
+	// Check if a state is a stage of supporting a knocked out enemy
+	static bool IsSupportState(const unsigned int uiState);
+	// Check if a state is one in which the enemies move and interact with the player and the map
+	static bool IsActiveState(const unsigned int uiState);
+
+	// Prepare the shared distance fields, and choose the steps of the supporting enemies which request their routes
+	void UpdateSteps(void);
+	// Update the tier, the step, the move and the UV coordinates of each enemy in parallel
+	void UpdateEnemies(void);
+	// Update the tier, the step, the move and the UV coordinates of an enemy on a worker
+	void UpdateEnemy(const unsigned int uiEnemy, const unsigned int uiChunk);
+	// Move an enemy towards its step
+	void MoveToStep(const unsigned int uiEnemy);
+	// Let each enemy interact with the player and the map
+	void UpdateInteractions(void);
+	// Let an enemy interact with its tile
+	void InteractWithTile(const unsigned int uiEnemy);
+	// Change the states of the enemies from their lives and positions
+	void UpdateFSMs(void);
+	// Send an enemy to support each enemy which has been knocked out
+	void UpdateSupport(void);
+	// Make the transitions of the events which have been raised, and start and end the states which have changed
+	void ApplyTransitions(void);
+
+	// Request the route of an enemy to the knocked out enemy which it supports
+	bool RequestRoute(const unsigned int uiEnemy);
+	// Take the next tile of the route of an enemy as its step
+	void NextStep(const unsigned int uiEnemy);
+	// Stop an enemy from supporting another, and cancel its route
+	void EndSupport(const unsigned int uiEnemy);
+
+	// Restore the background of the tile of an enemy
+	void ClearTile(const unsigned int uiEnemy) const;
+	// Find the nearest Live of an enemy by path
+	void FindNearestLive(const unsigned int uiEnemy);
+};
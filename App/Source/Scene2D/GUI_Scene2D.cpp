@@ -19,6 +19,7 @@ CGUI_Scene2D::CGUI_Scene2D(void)
 	, window_flags(0)
 	, cPlayerInventoryManager(NULL)
 	, cInventoryItem(NULL)
+	, cEnemySystem2D(NULL)
 {
 }
 
@@ -88,14 +89,12 @@ bool CGUI_Scene2D::Init(void)
 	cInventoryItem = cPlayerInventoryManager->Add("Spike", "Image/Scene2D/Spike.tga", 3, 0);
 	cInventoryItem->vec2Size = glm::vec2(25, 25);
 
-	for (unsigned i = 0; i < enemyVector->size(); ++i)
-	{
-		(*enemyVector)[i]->GetInventoryManager()->Add("Enemy " + std::to_string(i) + " Live", "Image/Scene2D/Live.tga", 1, 0);
-	}
-
 	// Game Manager
 	cGameManager = &CGameManager::GetInstance();
 
+	// Enemies
+	cEnemySystem2D = &CEnemySystem2D::GetInstance();
+
 	openInventory = false;
 
 	return true;
@@ -132,6 +131,18 @@ void CGUI_Scene2D::Update(const double dElapsedTime, const double& time)
 			// Display the FPS
 			ImGui::TextColored(ImVec4(0.0f, 0.0f, 0.0f, 1.0f), "FPS: %d", cFPSCounter->GetFrameRate());
 
+			// Display the time spent on the enemies, their routes, and the number of enemies in each tier
+			const CAIScheduler& cScheduler = cEnemySystem2D->GetScheduler();
+			ImGui::TextColored(ImVec4(0.0f, 0.0f, 0.0f, 1.0f), "AI: %.2f ms (avg %.2f ms)",
+							   cScheduler.GetFrameTime() / 1000.0, cScheduler.GetAverageFrameTime() / 1000.0);
+			ImGui::TextColored(ImVec4(0.0f, 0.0f, 0.0f, 1.0f), "Routes: %u/%u searching, %u waiting (%u sent in %.0f us)",
+							   cScheduler.GetNumReplansInFlight(), cScheduler.GetMaxReplansInFlight(),
+							   cScheduler.GetNumQueuedReplans(), cScheduler.GetNumReplans(), cScheduler.GetReplanTime());
+			ImGui::TextColored(ImVec4(0.0f, 0.0f, 0.0f, 1.0f), "Tiers: %u/%u/%u",
+							   cScheduler.GetNumAgents(CAIScheduler::TIER_NEAR),
+							   cScheduler.GetNumAgents(CAIScheduler::TIER_MID),
+							   cScheduler.GetNumAgents(CAIScheduler::TIER_FAR));
+
 			ImGuiWindowFlags statsWinFlags =
 				ImGuiWindowFlags_AlwaysAutoResize |
 				ImGuiWindowFlags_NoBackground |
@@ -623,8 +634,3 @@ const bool& CGUI_Scene2D::InventoryOpen() const
 {
 	return openInventory;
 }
-
-void CGUI_Scene2D::SetEnemyVector(std::vector<CEnemy2D*>& cEnemyVector)
-{
-	enemyVector = &cEnemyVector;
-}
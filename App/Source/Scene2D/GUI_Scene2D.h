@@ -44,7 +44,7 @@
 
 #include "Player2D.h"
 
-#include "Enemy2D.h"
+#include "EnemySystem2D.h"
 
 #include <string>
 using namespace std;
@@ -70,8 +70,6 @@ public:
 
 	const bool& InventoryOpen() const;
 
-	void SetEnemyVector(std::vector<CEnemy2D*>& cEnemyVector);
-
 protected:
 	// Constructor
 	CGUI_Scene2D(void);
@@ -99,7 +97,8 @@ protected:
 
 	CPlayer2D* cPlayer2D;
 
-	std::vector<CEnemy2D*>* enemyVector;
+	// The enemies, to show the time spent on updating them
+	CEnemySystem2D* cEnemySystem2D;
 
 	bool openInventory;
 };
@@ -17,17 +17,20 @@
 
 #include <iostream>
 #include <vector>
+#include <cstring>
 using namespace std;
 
-// For AStar PathFinding
-using namespace std::placeholders;
-
 /**
  @brief Constructor This constructor has protected access modifier as this class will be a Singleton
  */
 CMap2D::CMap2D(void)
 	: uiCurLevel(0)
-	, quadMesh(NULL)
+	, cTileAtlas(NULL)
+	, uiNumChunksX(0)
+	, uiNumChunksY(0)
+	, cCamera2D(NULL)
+	, uiTileChangesBase(0)
+	, uiMapRevision(0)
 {
 }
 
@@ -36,26 +39,32 @@ CMap2D::CMap2D(void)
  */
 CMap2D::~CMap2D(void)
 {
-	// Dynamically deallocate the 3D array used to store the map information
+	// Stop the path finding workers before the data which they search is deleted
+	cPathJobQueue.Destroy();
+	cNavGridSnapshot.Clear();
+
+	// Dynamically deallocate the levels used to store the map information
 	for (unsigned int uiLevel = 0; uiLevel < uiNumLevels; uiLevel++)
 	{
-		for (unsigned int iRow = 0; iRow < cSettings->NUM_TILES_YAXIS; iRow++)
-		{
-			delete[] arrMapInfo[uiLevel][iRow];
-		}
-		delete [] arrMapInfo[uiLevel];
+		delete[] arrMapInfo[uiLevel];
+		delete[] arrBackgroundInfo[uiLevel];
 	}
 	delete[] arrMapInfo;
+	delete[] arrBackgroundInfo;
 
-	if (quadMesh)
+	// Delete the vertex buffers of the chunks
+	while (vecBuiltChunks.size() > 0)
+		ReleaseTileChunk(vecBuiltChunks.back());
+
+	// We won't delete this since it was created elsewhere
+	cCamera2D = NULL;
+
+	if (cTileAtlas)
 	{
-		delete quadMesh;
-		quadMesh = NULL;
+		delete cTileAtlas;
+		cTileAtlas = NULL;
 	}
 
-	// Delete AStar lists
-	DeleteAStarLists();
-
 	// optional: de-allocate all resources once they've outlived their purpose:
 	glDeleteVertexArrays(1, &VAO);
 	glDeleteBuffers(1, &VBO);
@@ -65,241 +74,58 @@ CMap2D::~CMap2D(void)
 	cSettings = NULL;
 }
 
+/**
+ @brief Load the images of the tiles and pack them into cTileAtlas
+ */
 bool CMap2D::InitTGAs()
 {
-	/* Background */
-	iTextureID = CImageLoader::GetInstance().LoadTextureGetID("Image/Scene2D/BackgroundSky.tga", true);
-	if (iTextureID == 0)
-	{
-		cout << "Unable to load Image/Scene2D/BackgroundSky.tga" << endl;
-		return false;
-	}
-	else
-	{
-		// Store the texture ID into MapOfTextureIDs
-		MapOfTextureIDs.insert(pair<int, int>(1, iTextureID));
-	}
-	iTextureID = CImageLoader::GetInstance().LoadTextureGetID("Image/Scene2D/BackgroundCloudTop.tga", true);
-	if (iTextureID == 0)
-	{
-		cout << "Unable to load Image/Scene2D/BackgroundCloudTop.tga" << endl;
-		return false;
-	}
-	else
-	{
-		// Store the texture ID into MapOfTextureIDs
-		MapOfTextureIDs.insert(pair<int, int>(2, iTextureID));
-	}
-	iTextureID = CImageLoader::GetInstance().LoadTextureGetID("Image/Scene2D/BackgroundCloudBottom.tga", true);
-	if (iTextureID == 0)
-	{
-		cout << "Unable to load Image/Scene2D/BackgroundCloudBottom.tga" << endl;
-		return false;
-	}
-	else
-	{
-		// Store the texture ID into MapOfTextureIDs
-		MapOfTextureIDs.insert(pair<int, int>(3, iTextureID));
-	}
-	/* Interactables */
-	iTextureID = CImageLoader::GetInstance().LoadTextureGetID("Image/Scene2D/Live.tga", true);
-	if (iTextureID == 0)
-	{
-		cout << "Unable to load Image/Scene2D/Live.tga" << endl;
-		return false;
-	}
-	else
-	{
-		MapOfTextureIDs.insert(pair<int, int>(5, iTextureID));
-	}
-	iTextureID = CImageLoader::GetInstance().LoadTextureGetID("Image/Scene2D/Key.tga", true);
-	if (iTextureID == 0)
-	{
-		cout << "Unable to load Image/Scene2D/Key.tga" << endl;
-		return false;
-	}
-	else
-	{
-		MapOfTextureIDs.insert(pair<int, int>(10, iTextureID));
-	}
-	iTextureID = CImageLoader::GetInstance().LoadTextureGetID("Image/Scene2D/Speed.tga", true);
-	if (iTextureID == 0)
-	{
-		cout << "Unable to load Image/Scene2D/Speed.tga" << endl;
-		return false;
-	}
-	else
-	{
-		MapOfTextureIDs.insert(pair<int, int>(15, iTextureID));
-	}
-	iTextureID = CImageLoader::GetInstance().LoadTextureGetID("Image/Scene2D/Invisibility.tga", true);
-	if (iTextureID == 0)
-	{
-		cout << "Unable to load Image/Scene2D/Invisibility.tga" << endl;
-		return false;
-	}
-	else
-	{
-		MapOfTextureIDs.insert(pair<int, int>(20, iTextureID));
-	}
-	iTextureID = CImageLoader::GetInstance().LoadTextureGetID("Image/Scene2D/TreasureChest.tga", true);
-	if (iTextureID == 0)
-	{
-		cout << "Unable to load Image/Scene2D/TreasureChest.tga" << endl;
-		return false;
-	}
-	else
-	{
-		// Store the texture ID into MapOfTextureIDs
-		MapOfTextureIDs.insert(pair<int, int>(25, iTextureID));
-	}
-	iTextureID = CImageLoader::GetInstance().LoadTextureGetID("Image/Scene2D/LadderTop.tga", true);
-	if (iTextureID == 0)
-	{
-		cout << "Unable to load Image/Scene2D/LadderTop.tga" << endl;
-		return false;
-	}
-	else
-	{
-		// Store the texture ID into MapOfTextureIDs
-		MapOfTextureIDs.insert(pair<int, int>(30, iTextureID));
-	}
-	iTextureID = CImageLoader::GetInstance().LoadTextureGetID("Image/Scene2D/LadderBottom.tga", true);
-	if (iTextureID == 0)
-	{
-		cout << "Unable to load Image/Scene2D/LadderBottom.tga" << endl;
-		return false;
-	}
-	else
-	{
-		// Store the texture ID into MapOfTextureIDs
-		MapOfTextureIDs.insert(pair<int, int>(35, iTextureID));
-	}
-	iTextureID = CImageLoader::GetInstance().LoadTextureGetID("Image/Scene2D/LadderBottom.tga", true);
-	if (iTextureID == 0)
-	{
-		cout << "Unable to load Image/Scene2D/LadderBottom.tga" << endl;
-		return false;
-	}
-	else
-	{
-		// Store the texture ID into MapOfTextureIDs
-		MapOfTextureIDs.insert(pair<int, int>(36, iTextureID));
-	}
-	iTextureID = CImageLoader::GetInstance().LoadTextureGetID("Image/Scene2D/ZiplineLeft.tga", true);
-	if (iTextureID == 0)
-	{
-		cout << "Unable to load Image/Scene2D/ZiplineLeft.tga" << endl;
-		return false;
-	}
-	else
-	{
-		// Store the texture ID into MapOfTextureIDs
-		MapOfTextureIDs.insert(pair<int, int>(40, iTextureID));
-	}
-	iTextureID = CImageLoader::GetInstance().LoadTextureGetID("Image/Scene2D/ZiplineCenter.tga", true);
-	if (iTextureID == 0)
-	{
-		cout << "Unable to load Image/Scene2D/ZiplineCenter.tga" << endl;
-		return false;
-	}
-	else
-	{
-		// Store the texture ID into MapOfTextureIDs
-		MapOfTextureIDs.insert(pair<int, int>(45, iTextureID));
-	}
-	iTextureID = CImageLoader::GetInstance().LoadTextureGetID("Image/Scene2D/ZiplineRight.tga", true);
-	if (iTextureID == 0)
-	{
-		cout << "Unable to load Image/Scene2D/ZiplineRight.tga" << endl;
-		return false;
-	}
-	else
-	{
-		// Store the texture ID into MapOfTextureIDs
-		MapOfTextureIDs.insert(pair<int, int>(50, iTextureID));
-	}
-	iTextureID = CImageLoader::GetInstance().LoadTextureGetID("Image/Scene2D/Spike.tga", true);
-	if (iTextureID == 0)
-	{
-		cout << "Unable to load Image/Scene2D/Spike.tga" << endl;
-		return false;
-	}
-	else
-	{
-		// Store the texture ID into MapOfTextureIDs
-		MapOfTextureIDs.insert(pair<int, int>(55, iTextureID));
-	}
-	iTextureID = CImageLoader::GetInstance().LoadTextureGetID("Image/Scene2D/MapSpike.tga", true);
-	if (iTextureID == 0)
-	{
-		cout << "Unable to load Image/Scene2D/MapSpike.tga" << endl;
-		return false;
-	}
-	else
-	{
-		// Store the texture ID into MapOfTextureIDs
-		MapOfTextureIDs.insert(pair<int, int>(60, iTextureID));
+	// The tile values and the images used to render them
+	static const struct {
+		int iValue;
+		const char* filename;
+	} arrTileImages[] = {
+		/* Background */
+		{ 1, "Image/Scene2D/BackgroundSky.tga" },
+		{ 2, "Image/Scene2D/BackgroundCloudTop.tga" },
+		{ 3, "Image/Scene2D/BackgroundCloudBottom.tga" },
+		/* Interactables */
+		{ 5, "Image/Scene2D/Live.tga" },
+		{ 10, "Image/Scene2D/Key.tga" },
+		{ 15, "Image/Scene2D/Speed.tga" },
+		{ 20, "Image/Scene2D/Invisibility.tga" },
+		{ 25, "Image/Scene2D/TreasureChest.tga" },
+		{ 30, "Image/Scene2D/LadderTop.tga" },
+		{ 35, "Image/Scene2D/LadderBottom.tga" },
+		{ 36, "Image/Scene2D/LadderBottom.tga" },
+		{ 40, "Image/Scene2D/ZiplineLeft.tga" },
+		{ 45, "Image/Scene2D/ZiplineCenter.tga" },
+		{ 50, "Image/Scene2D/ZiplineRight.tga" },
+		{ 55, "Image/Scene2D/Spike.tga" },
+		{ 60, "Image/Scene2D/MapSpike.tga" },
+		/* Non animates */
+		{ 100, "Image/Scene2D/GroundTop.tga" },
+		{ 105, "Image/Scene2D/GroundBottom.tga" },
+		{ 110, "Image/Scene2D/CloudLeft.tga" },
+		{ 115, "Image/Scene2D/CloudCenter.tga" },
+		{ 120, "Image/Scene2D/CloudRight.tga" },
+	};
+
+	for (unsigned int i = 0; i < sizeof(arrTileImages) / sizeof(arrTileImages[0]); i++)
+	{
+		if (cTileAtlas->AddImage(arrTileImages[i].iValue, arrTileImages[i].filename, true) == false)
+		{
+			cout << "Unable to load " << arrTileImages[i].filename << endl;
+			return false;
+		}
 	}
 
-
-
-	/* Non animates */
-	iTextureID = CImageLoader::GetInstance().LoadTextureGetID("Image/Scene2D/GroundTop.tga", true);
-	if (iTextureID == 0)
-	{
-		cout << "Unable to load Image/Scene2D/GroundTop.tga" << endl;
-		return false;
-	}
-	else
-	{
-		// Store the texture ID into MapOfTextureIDs
-		MapOfTextureIDs.insert(pair<int, int>(100, iTextureID));
-	}
-	iTextureID = CImageLoader::GetInstance().LoadTextureGetID("Image/Scene2D/GroundBottom.tga", true);
-	if (iTextureID == 0)
-	{
-		cout << "Unable to load Image/Scene2D/GroundBottom.tga" << endl;
-		return false;
-	}
-	else
-	{
-		// Store the texture ID into MapOfTextureIDs
-		MapOfTextureIDs.insert(pair<int, int>(105, iTextureID));
-	}
-	iTextureID = CImageLoader::GetInstance().LoadTextureGetID("Image/Scene2D/CloudLeft.tga", true);
-	if (iTextureID == 0)
-	{
-		cout << "Unable to load Image/Scene2D/CloudLeft.tga" << endl;
-		return false;
-	}
-	else
-	{
-		// Store the texture ID into MapOfTextureIDs
-		MapOfTextureIDs.insert(pair<int, int>(110, iTextureID));
-	}
-	iTextureID = CImageLoader::GetInstance().LoadTextureGetID("Image/Scene2D/CloudCenter.tga", true);
-	if (iTextureID == 0)
-	{
-		cout << "Unable to load Image/Scene2D/CloudCenter.tga" << endl;
-		return false;
-	}
-	else
-	{
-		// Store the texture ID into MapOfTextureIDs
-		MapOfTextureIDs.insert(pair<int, int>(115, iTextureID));
-	}
-	iTextureID = CImageLoader::GetInstance().LoadTextureGetID("Image/Scene2D/CloudRight.tga", true);
-	if (iTextureID == 0)
+	// Pack all the tile images into one texture, so that the tiles can be rendered without rebinding textures
+	if (cTileAtlas->Build() == false)
 	{
-		cout << "Unable to load Image/Scene2D/CloudRight.tga" << endl;
+		cout << "Unable to build the tile atlas" << endl;
 		return false;
 	}
-	else
-	{
-		// Store the texture ID into MapOfTextureIDs
-		MapOfTextureIDs.insert(pair<int, int>(120, iTextureID));
-	}
+	iTextureID = cTileAtlas->GetTextureID();
 
 	return true;
 }
@@ -319,33 +145,16 @@ bool CMap2D::Init(	const unsigned int uiNumLevels,
 	cSettings = &CSettings::GetInstance();	
 
 	// Initialise the variables for AStar
-	m_weight = 1;
-	m_startPos = glm::vec2(0, 0);
-	m_targetPos = glm::vec2(0, 0);
-	//m_size = cSettings->NUM_TILES_YAXIS* cSettings->NUM_TILES_XAXIS;
-
 	m_nrOfDirections = 4;
-	m_directions = { { -1, 0 }, { 1, 0 }, { 0, 1 }, { 0, -1 },
-						{ -1, -1 }, { 1, 1 }, { -1, 1 }, { 1, -1 } };
-
-	// Resize these 2 lists
-	m_cameFromList.resize(cSettings->NUM_TILES_YAXIS * cSettings->NUM_TILES_XAXIS);
-	m_closedList.resize(cSettings->NUM_TILES_YAXIS * cSettings->NUM_TILES_XAXIS, false);
 
 	// Create the arrMapInfo and initialise to 0
-	// Start by initialising the number of levels
-	arrMapInfo = new Grid** [uiNumLevels];
+	// Each level is a single contiguous block of uiNumRows * uiNumCols tiles
+	arrMapInfo = new TileValue* [uiNumLevels];
+	arrBackgroundInfo = new TileValue* [uiNumLevels];
 	for (unsigned uiLevel = 0; uiLevel < uiNumLevels; uiLevel++)
 	{
-		arrMapInfo[uiLevel] = new Grid* [uiNumRows];
-		for (unsigned uiRow = 0; uiRow < uiNumRows; uiRow++)
-		{
-			arrMapInfo[uiLevel][uiRow] = new Grid[uiNumCols];
-			for (unsigned uiCol = 0; uiCol < uiNumCols; uiCol++)
-			{
-				arrMapInfo[uiLevel][uiRow][uiCol].value = 0;
-			}
-		}
+		arrMapInfo[uiLevel] = new TileValue[uiNumRows * uiNumCols]();
+		arrBackgroundInfo[uiLevel] = new TileValue[uiNumRows * uiNumCols]();
 	}
 
 	// Store the map sizes in cSettings
@@ -358,16 +167,23 @@ bool CMap2D::Init(	const unsigned int uiNumLevels,
 	glGenVertexArrays(1, &VAO);
 	glBindVertexArray(VAO);
 
-	//CS: Create the Quad Mesh using the mesh builder
-	quadMesh = CMeshBuilder::GenerateQuad(glm::vec4(1, 1, 1, 1), cSettings->TILE_WIDTH, cSettings->TILE_HEIGHT);
+	// Create the chunks which cache the quads of the tiles
+	InitTileChunks();
+
+	// Get the handler to the CCamera2D instance
+	cCamera2D = &CCamera2D::GetInstance();
 
 	// Load and create textures
-	// Load the ground texture
+	// Pack the tile textures into an atlas
+	cTileAtlas = new CTextureAtlas();
 	if (InitTGAs() == false)
 	{
 		std::cout << "Failed to init TGAs" << std::endl;
 		return false;
 	}
+
+	// Start the workers for the paths which are found in the background
+	cPathJobQueue.Init();
 	
 	return true;
 }
@@ -379,7 +195,10 @@ void CMap2D::Update(const double dElapsedTime, const double& time)
 {
 	this->time = time;
 
-	RespawnLives();
+	// Deliver the paths which were found since the last frame
+	cPathJobQueue.BeginFrame();
+
+	ProcessTileEvents();
 }
 
 /**
@@ -403,28 +222,66 @@ void CMap2D::PreRender(void)
  */
 void CMap2D::Render(void)
 {
+	// Find the tiles which are in the view. The rows are counted from the top of the map
+	glm::vec2 vec2ViewMin, vec2ViewMax;
+	cCamera2D->GetViewRect(vec2ViewMin, vec2ViewMax);
+	int iMinCol = (int)floor((vec2ViewMin.x + 1.0f) / cSettings->TILE_WIDTH);
+	int iMaxCol = (int)floor((vec2ViewMax.x + 1.0f) / cSettings->TILE_WIDTH);
+	int iMinRow = (int)cSettings->NUM_TILES_YAXIS - 1 - (int)floor((vec2ViewMax.y + 1.0f) / cSettings->TILE_HEIGHT);
+	int iMaxRow = (int)cSettings->NUM_TILES_YAXIS - 1 - (int)floor((vec2ViewMin.y + 1.0f) / cSettings->TILE_HEIGHT);
+	iMinCol = glm::clamp(iMinCol, 0, (int)cSettings->NUM_TILES_XAXIS - 1);
+	iMaxCol = glm::clamp(iMaxCol, 0, (int)cSettings->NUM_TILES_XAXIS - 1);
+	iMinRow = glm::clamp(iMinRow, 0, (int)cSettings->NUM_TILES_YAXIS - 1);
+	iMaxRow = glm::clamp(iMaxRow, 0, (int)cSettings->NUM_TILES_YAXIS - 1);
+
+	// Convert them to the chunks which are in the view
+	const unsigned int uiMinChunkX = iMinCol / TILE_CHUNK_SIZE;
+	const unsigned int uiMaxChunkX = iMaxCol / TILE_CHUNK_SIZE;
+	const unsigned int uiMinChunkY = iMinRow / TILE_CHUNK_SIZE;
+	const unsigned int uiMaxChunkY = iMaxRow / TILE_CHUNK_SIZE;
+
+	// Release the chunks which are more than a chunk away from the view, 
+	// so that scrolling across a large map does not keep every chunk in memory
+	for (unsigned int i = 0; i < vecBuiltChunks.size(); )
+	{
+		const unsigned int uiChunkX = vecBuiltChunks[i] % uiNumChunksX;
+		const unsigned int uiChunkY = vecBuiltChunks[i] / uiNumChunksX;
+		if ((uiChunkX + 1 < uiMinChunkX) || (uiChunkX > uiMaxChunkX + 1) ||
+			(uiChunkY + 1 < uiMinChunkY) || (uiChunkY > uiMaxChunkY + 1))
+		{
+			// ReleaseTileChunk() moves the last built chunk into this slot
+			ReleaseTileChunk(vecBuiltChunks[i]);
+		}
+		else
+		{
+			i++;
+		}
+	}
+
+	// The tile quads are in UV space, so only the view of the camera is needed
+	transform = cCamera2D->GetViewMatrix();
+
 	// get matrix's uniform location and set matrix
 	unsigned int transformLoc = glGetUniformLocation(CShaderManager::GetInstance().activeShader->ID, "transform");
 	glUniformMatrix4fv(transformLoc, 1, GL_FALSE, glm::value_ptr(transform));
 
-	// Render
-	for (unsigned int uiRow = 0; uiRow < cSettings->NUM_TILES_YAXIS; uiRow++)
+	// Render the chunks in the view with one draw call each, as they all use the tile atlas
+	glBindTexture(GL_TEXTURE_2D, cTileAtlas->GetTextureID());
+	glBindVertexArray(VAO);
+	for (unsigned int uiChunkY = uiMinChunkY; uiChunkY <= uiMaxChunkY; uiChunkY++)
 	{
-		for (unsigned int uiCol = 0; uiCol < cSettings->NUM_TILES_XAXIS; uiCol++)
+		for (unsigned int uiChunkX = uiMinChunkX; uiChunkX <= uiMaxChunkX; uiChunkX++)
 		{
-			transform = glm::mat4(1.0f); // make sure to initialize matrix to identity matrix first
-			transform = glm::translate(transform, glm::vec3(cSettings->ConvertIndexToUVSpace(cSettings->x, uiCol, false, 0),
-															cSettings->ConvertIndexToUVSpace(cSettings->y, uiRow, true, 0),
-															0.0f));
-			//transform = glm::rotate(transform, (float)glfwGetTime(), glm::vec3(0.0f, 0.0f, 1.0f));
-
-			// Update the shaders with the latest transform
-			glUniformMatrix4fv(transformLoc, 1, GL_FALSE, glm::value_ptr(transform));
-
-			// Render a tile
-			RenderTile(uiRow, uiCol);
+			const unsigned int uiChunk = uiChunkY * uiNumChunksX + uiChunkX;
+			// Update the tile quads if the tiles have changed since they were built
+			if (tileChunks[uiChunk].bDirty)
+				BuildTileChunk(uiChunk);
+			else if (tileChunks[uiChunk].vecDirtyTiles.size() > 0)
+				UpdateTileChunk(uiChunk);
+			tileChunks[uiChunk].batch->Render();
 		}
 	}
+	glBindVertexArray(0);
 }
 
 /**
@@ -504,10 +361,19 @@ void CMap2D::SetNumSteps(const CSettings::AXIS sAxis, const unsigned int uiValue
  */
 void CMap2D::SetMapInfo(const unsigned int uiRow, const unsigned int uiCol, const int iValue, const bool bInvert)
 {
-	if (bInvert)
-		arrMapInfo[uiCurLevel][cSettings->NUM_TILES_YAXIS - uiRow - 1][uiCol].value = iValue;
-	else
-		arrMapInfo[uiCurLevel][uiRow][uiCol].value = iValue;
+	if (!IsWithinMap(uiRow, uiCol))
+		return;
+
+	const unsigned int uiIndex = GetTileIndex(uiRow, uiCol, bInvert);
+	TileValue& tile = arrMapInfo[uiCurLevel][uiIndex];
+	if (tile == (TileValue)iValue)
+		return;
+
+	const TileValue oldValue = tile;
+	tile = (TileValue)iValue;
+
+	OnTileChanged(	uiIndex / cSettings->NUM_TILES_XAXIS, uiIndex % cSettings->NUM_TILES_XAXIS, 
+					oldValue, tile);
 }
 
 /**
@@ -518,16 +384,60 @@ void CMap2D::SetMapInfo(const unsigned int uiRow, const unsigned int uiCol, cons
  */
 int CMap2D::GetMapInfo(const unsigned int uiRow, const int unsigned uiCol, const bool bInvert) const
 {
-	if (bInvert)
-		return arrMapInfo[uiCurLevel][cSettings->NUM_TILES_YAXIS - uiRow - 1][uiCol].value;
-	else
-		return arrMapInfo[uiCurLevel][uiRow][uiCol].value;
+	// Tiles outside of the map are treated as empty, e.g. when checking below the bottom row
+	if (!IsWithinMap(uiRow, uiCol))
+		return 0;
+
+	return arrMapInfo[uiCurLevel][GetTileIndex(uiRow, uiCol, bInvert)];
+}
+
+/**
+ @brief Get the background value at certain indices in the arrBackgroundInfo.
+		This is the background tile drawn under a tile, and the value to restore when an item is removed from a tile
+ @param iRow A const int variable containing the row index of the element to get from
+ @param iCol A const int variable containing the column index of the element to get from
+ @param bInvert A const bool variable which indicates if the row information is inverted
+ */
+int CMap2D::GetBackgroundInfo(const unsigned int uiRow, const unsigned int uiCol, const bool bInvert) const
+{
+	if (!IsWithinMap(uiRow, uiCol))
+		return 0;
+
+	return arrBackgroundInfo[uiCurLevel][GetTileIndex(uiRow, uiCol, bInvert)];
 }
 
 /**
- @brief Load a map
+ @brief Load a map. Files with the .map extension are loaded as binary map files, and other files as CSV files
+ @param filename A string variable containing the name of the map file
+ @param uiCurLevel A const unsigned int variable containing the level to load the map into
  */ 
 bool CMap2D::LoadMap(string filename, const unsigned int uiCurLevel)
+{
+	bool bResult = false;
+	bool bIndexed = false;
+	if ((filename.size() > 4) && (filename.compare(filename.size() - 4, 4, ".map") == 0))
+		bResult = LoadBinaryMap(filename, uiCurLevel, bIndexed);
+	else
+		bResult = LoadCSVMap(filename, uiCurLevel);
+	if (bResult == false)
+		return false;
+
+	MarkTileChunksDirty();
+	ResetTileChanges();
+	if (!bIndexed)
+		RebuildValueIndices();
+	BuildNavGrid();
+	cTileEvents.Clear();
+
+	return true;
+}
+
+/**
+ @brief Load a map from a CSV file
+ @param filename A const string& variable containing the name of the CSV file
+ @param uiLevel A const unsigned int variable containing the level to load the map into
+ */
+bool CMap2D::LoadCSVMap(const string& filename, const unsigned int uiLevel)
 {
 	doc = rapidcsv::Document(FileSystem::getPath(filename).c_str());
 
@@ -540,6 +450,7 @@ bool CMap2D::LoadMap(string filename, const unsigned int uiCurLevel)
 	}
 
 	// Read the rows and columns of CSV data into arrMapInfo
+	TileValue* pLevel = arrMapInfo[uiLevel];
 	for (unsigned int uiRow = 0; uiRow < cSettings->NUM_TILES_YAXIS; uiRow++)
 	{
 		// Read a row from the CSV file
@@ -548,27 +459,79 @@ bool CMap2D::LoadMap(string filename, const unsigned int uiCurLevel)
 		// Load a particular CSV value into the arrMapInfo
 		for (unsigned int uiCol = 0; uiCol < cSettings->NUM_TILES_XAXIS; ++uiCol)
 		{
-			arrMapInfo[uiCurLevel][uiRow][uiCol].value = (int)stoi(row[uiCol]);
-			if ((int)stoi(row[uiCol]) == 5)
-				liveMap.insert(pair<pair<float, float>, double>(make_pair((float)uiCol, (float)uiRow), -10.0));
+			const int iValue = (int)stoi(row[uiCol]);
+			pLevel[uiRow * cSettings->NUM_TILES_XAXIS + uiCol] = (TileValue)iValue;
 		}
 	}
 
+	// Split the background tiles into their own layer
+	BuildBackgroundLayer(uiLevel);
+
+	return true;
+}
+
+/**
+ @brief Load a map from a binary map file. The layers are copied straight from the mapped file into arrMapInfo.
+		If the map is loaded into the current level, mapOfValueIndices is built from the spawn table of the file 
+		instead of by scanning the tiles
+ @param filename A const string& variable containing the name of the binary map file
+ @param uiLevel A const unsigned int variable containing the level to load the map into
+ @param bIndexed A bool& variable to store if mapOfValueIndices was built from the file
+ */
+bool CMap2D::LoadBinaryMap(const string& filename, const unsigned int uiLevel, bool& bIndexed)
+{
+	bIndexed = false;
+
+	CMapFile cMapFile;
+	if (cMapFile.Open(FileSystem::getPath(filename)) == false)
+		return false;
+
+	// Check if the sizes of the map file matches the declared arrMapInfo sizes
+	if ((cSettings->NUM_TILES_XAXIS != cMapFile.GetNumCols()) ||
+		(cSettings->NUM_TILES_YAXIS != cMapFile.GetNumRows()))
+	{
+		cout << "Sizes of binary map does not match declared arrMapInfo sizes." << endl;
+		return false;
+	}
+
+	const unsigned short* pTiles = cMapFile.GetLayer(CMapFile::LAYER_TILES);
+	if (pTiles == NULL)
+	{
+		cout << "Binary map " << filename << " has no tiles." << endl;
+		return false;
+	}
+
+	const size_t numTiles = (size_t)cSettings->NUM_TILES_YAXIS * cSettings->NUM_TILES_XAXIS;
+	memcpy(arrMapInfo[uiLevel], pTiles, numTiles * sizeof(TileValue));
+
+	// Use the background layer stored in the file, or build it if the file does not have one
+	const unsigned short* pBackground = cMapFile.GetLayer(CMapFile::LAYER_BACKGROUND);
+	if (pBackground)
+		memcpy(arrBackgroundInfo[uiLevel], pBackground, numTiles * sizeof(TileValue));
+	else
+		BuildBackgroundLayer(uiLevel);
+
+	if (uiLevel == uiCurLevel)
+		bIndexed = LoadValueIndices(cMapFile);
+
 	return true;
 }
 
 /**
- @brief Save the tilemap to a text file
+ @brief Save the tilemap to a text file, or to a binary map file if the file has the .map extension
  @param filename A string variable containing the name of the text file to save the map to
  */
 bool CMap2D::SaveMap(string filename, const unsigned int uiCurLevel)
 {
+	if ((filename.size() > 4) && (filename.compare(filename.size() - 4, 4, ".map") == 0))
+		return SaveBinaryMap(filename, uiCurLevel);
+
 	// Update the rapidcsv::Document from arrMapInfo
 	for (unsigned int uiRow = 0; uiRow < cSettings->NUM_TILES_YAXIS; uiRow++)
 	{
 		for (unsigned int uiCol = 0; uiCol < cSettings->NUM_TILES_XAXIS; uiCol++)
 		{
-			doc.SetCell(uiCol, uiRow, arrMapInfo[uiCurLevel][uiRow][uiCol].value);
+			doc.SetCell(uiCol, uiRow, (int)arrMapInfo[uiCurLevel][uiRow * cSettings->NUM_TILES_XAXIS + uiCol]);
 		}
 		cout << endl;
 	}
@@ -579,6 +542,79 @@ bool CMap2D::SaveMap(string filename, const unsigned int uiCurLevel)
 	return true;
 }
 
+/**
+ @brief Save a map to a binary map file
+ @param filename A const string& variable containing the name of the binary map file
+ @param uiLevel A const unsigned int variable containing the level to save
+ */
+bool CMap2D::SaveBinaryMap(const string& filename, const unsigned int uiLevel)
+{
+	// Collect the spawn points and the other indexed tiles, so that loading the file does not scan the tiles for them,
+	// and count the tiles of each indexed value, so that loading the file can check that none of them is missing
+	std::vector<MapFileSpawn> vecSpawns;
+	std::vector<MapFileValueCount> vecValueCounts;
+	for (unsigned int i = 0; i < TileRules::NUM_INDEXED_VALUES; i++)
+	{
+		MapFileValueCount count = { TileRules::INDEXED_VALUES[i], 0, 0 };
+		vecValueCounts.push_back(count);
+	}
+	for (unsigned int uiRow = 0; uiRow < cSettings->NUM_TILES_YAXIS; uiRow++)
+	{
+		for (unsigned int uiCol = 0; uiCol < cSettings->NUM_TILES_XAXIS; uiCol++)
+		{
+			const TileValue value = arrMapInfo[uiLevel][uiRow * cSettings->NUM_TILES_XAXIS + uiCol];
+			if (TileRules::IsIndexed(value))
+			{
+				MapFileSpawn spawn = { value, 0, uiRow, uiCol };
+				vecSpawns.push_back(spawn);
+				for (unsigned int i = 0; i < vecValueCounts.size(); i++)
+				{
+					if (vecValueCounts[i].usValue == value)
+						vecValueCounts[i].uiCount++;
+				}
+			}
+		}
+	}
+
+	const unsigned short* arrLayers[CMapFile::NUM_LAYERS] = { arrMapInfo[uiLevel], arrBackgroundInfo[uiLevel] };
+	return CMapFile::Write(	FileSystem::getPath(filename), 
+							cSettings->NUM_TILES_YAXIS, cSettings->NUM_TILES_XAXIS,
+							arrLayers, CMapFile::NUM_LAYERS, vecSpawns, vecValueCounts);
+}
+
+/**
+ @brief Get the revision of the current level, which increases whenever a tile is changed
+ */
+unsigned int CMap2D::GetMapRevision(void) const
+{
+	return uiMapRevision;
+}
+
+/**
+ @brief Get the revision of the navigation grid, which increases whenever a tile changes how it can be walked through.
+		A path which was found at the current revision does not have to be searched again
+ */
+unsigned int CMap2D::GetNavRevision(void) const
+{
+	return cNavGrid.GetRevision();
+}
+
+/**
+ @brief Get the tile changes made after a revision of the current level.
+		Cached data built from the map can store GetMapRevision() and use this to catch up with the map later.
+ @param uiRevision A const unsigned int variable containing the revision which the caller is up to date with
+ @param vecChanges A std::vector<TileChange>& variable which the changes are appended to, oldest first
+ @return false if the changes are no longer available, e.g. the level was reloaded, so the caller has to rebuild its data
+ */
+bool CMap2D::GetTileChangesSince(const unsigned int uiRevision, std::vector<TileChange>& vecChanges) const
+{
+	if ((uiRevision < uiTileChangesBase) || (uiRevision > uiMapRevision))
+		return false;
+
+	vecChanges.insert(vecChanges.end(), vecTileChanges.begin() + (uiRevision - uiTileChangesBase), vecTileChanges.end());
+	return true;
+}
+
 /**
 @brief Find the indices of a certain value in arrMapInfo
 @param iValue A const int variable containing the row index of the found element
@@ -588,11 +624,29 @@ bool CMap2D::SaveMap(string filename, const unsigned int uiCurLevel)
 */
 bool CMap2D::FindValue(const int iValue, unsigned int& uirRow, unsigned int& uirCol, const bool bInvert)
 {
+	// Look up indexed values instead of scanning the map
+	if ((iValue >= 0) && (iValue <= 0xFFFF) && (TileRules::IsIndexed((TileValue)iValue)))
+	{
+		std::map<TileValue, std::set<unsigned int>>::const_iterator it = mapOfValueIndices.find((TileValue)iValue);
+		if ((it == mapOfValueIndices.end()) || (it->second.empty()))
+			return false;
+
+		const unsigned int uiIndex = *it->second.begin();
+		const unsigned int uiRow = uiIndex / cSettings->NUM_TILES_XAXIS;
+		if (bInvert)
+			uirRow = cSettings->NUM_TILES_YAXIS - uiRow - 1;
+		else
+			uirRow = uiRow;
+		uirCol = uiIndex % cSettings->NUM_TILES_XAXIS;
+		return true;
+	}
+
+	const TileValue* pLevel = arrMapInfo[uiCurLevel];
 	for (unsigned int uiRow = 0; uiRow < cSettings->NUM_TILES_YAXIS; uiRow++)
 	{
 		for (unsigned int uiCol = 0; uiCol < cSettings->NUM_TILES_XAXIS; uiCol++)
 		{
-			if (arrMapInfo[uiCurLevel][uiRow][uiCol].value == iValue)
+			if (pLevel[uiRow * cSettings->NUM_TILES_XAXIS + uiCol] == iValue)
 			{
 				if (bInvert)
 					uirRow = cSettings->NUM_TILES_YAXIS - uiRow - 1;
@@ -608,220 +662,785 @@ bool CMap2D::FindValue(const int iValue, unsigned int& uirRow, unsigned int& uir
 }
 
 /**
- @brief Set current level
+ @brief Get the number of tiles with a certain value in the current level. Only indexed values are counted
+ @param iValue A const int variable containing the value to count
  */
-void CMap2D::SetCurrentLevel(unsigned int uiCurLevel)
+unsigned int CMap2D::GetValueCount(const int iValue) const
 {
-	if (uiCurLevel < uiNumLevels)
-	{
-		this->uiCurLevel = uiCurLevel;
-	}
+	if ((iValue < 0) || (iValue > 0xFFFF))
+		return 0;
+
+	std::map<TileValue, std::set<unsigned int>>::const_iterator it = mapOfValueIndices.find((TileValue)iValue);
+	if (it == mapOfValueIndices.end())
+		return 0;
+	return (unsigned int)it->second.size();
 }
+
 /**
- @brief Get current level
+ @brief Find the nearest tile with a certain value to a position. Only indexed values can be found
+ @param iValue A const int variable containing the value to find
+ @param vec2Position A const glm::vec2& variable containing the position to search from
+ @param vec2Nearest A glm::vec2& variable to store the column and row of the nearest tile
+ @param bInvert A const bool variable which indicates if the row information is inverted
+ @return true if a tile with this value was found, otherwise false
  */
-unsigned int CMap2D::GetCurrentLevel(void) const
+bool CMap2D::FindNearestValue(const int iValue, const glm::vec2& vec2Position, glm::vec2& vec2Nearest, const bool bInvert) const
 {
-	return uiCurLevel;
+	if ((iValue < 0) || (iValue > 0xFFFF))
+		return false;
+
+	std::map<TileValue, std::set<unsigned int>>::const_iterator it = mapOfValueIndices.find((TileValue)iValue);
+	if ((it == mapOfValueIndices.end()) || (it->second.empty()))
+		return false;
+
+	float fNearestDistance = 0.0f;
+	for (std::set<unsigned int>::const_iterator itIndex = it->second.begin(); itIndex != it->second.end(); ++itIndex)
+	{
+		const unsigned int uiRow = *itIndex / cSettings->NUM_TILES_XAXIS;
+		const glm::vec2 vec2Tile = glm::vec2(	*itIndex % cSettings->NUM_TILES_XAXIS,
+												bInvert ? cSettings->NUM_TILES_YAXIS - uiRow - 1 : uiRow);
+		const float fDistance = glm::length(vec2Tile - vec2Position);
+		if ((itIndex == it->second.begin()) || (fDistance < fNearestDistance))
+		{
+			fNearestDistance = fDistance;
+			vec2Nearest = vec2Tile;
+		}
+	}
+	return true;
+}
+
+/**
+ @brief Find the nearest tile with a certain value to a tile, by the cost of the path to it. 
+		Only indexed values can be found, see TileRules::IsIndexed()
+ @param iValue A const int variable containing the value to find
+ @param currentPos A const glm::vec2& variable containing the tile to search from, with the row counted from the bottom of the map
+ @param nearestPos A glm::vec2& variable to store the nearest tile
+ @return true if a tile with the value can be reached, otherwise false
+ */
+bool CMap2D::FindNearestValueByPath(const int iValue, const glm::vec2& currentPos, glm::vec2& nearestPos)
+{
+	PrepareValueField(iValue);
+	return FindNearestValueInField(iValue, currentPos, nearestPos);
+}
+
+/**
+ @brief Find the nearest tile with a certain value to a tile, by the cost of the path to it, from the field of the value
+		as it was left by PrepareValueField(). The map is not changed, so this can be called on several threads at once
+ @param iValue A const int variable containing the value to find
+ @param currentPos A const glm::vec2& variable containing the tile to search from, with the row counted from the bottom of the map
+ @param nearestPos A glm::vec2& variable to store the nearest tile
+ @return true if a tile with the value can be reached, or false if it cannot or the field is not up to date
+ */
+bool CMap2D::FindNearestValueInField(const int iValue, const glm::vec2& currentPos, glm::vec2& nearestPos) const
+{
+	const CDistanceField* pField = GetPreparedValueField(iValue);
+	if ((pField == NULL) || (!IsWithinMap(currentPos.y, currentPos.x)))
+		return false;
+
+	unsigned int uiNearest = 0;
+	if (!pField->GetNearestSource(cNavGrid.GetCell(currentPos.x, currentPos.y), uiNearest))
+		return false;
+	nearestPos = glm::vec2(cNavGrid.GetX(uiNearest), cNavGrid.GetY(uiNearest));
+	return true;
+}
+
+/**
+ @brief Get the next tile to move to from a tile, towards the nearest tile with a certain value by path. 
+		Only indexed values can be found, see TileRules::IsIndexed()
+ @param iValue A const int variable containing the value to move towards
+ @param currentPos A const glm::vec2& variable containing the tile to move from, with the row counted from the bottom of the map
+ @param nextPos A glm::vec2& variable to store the next tile
+ @return true if there is a next tile, or false if the current tile has the value or cannot reach it
+ */
+bool CMap2D::GetNextStepToValue(const int iValue, const glm::vec2& currentPos, glm::vec2& nextPos)
+{
+	PrepareValueField(iValue);
+	return GetNextStepInValueField(iValue, currentPos, nextPos);
+}
+
+/**
+ @brief Get the next tile to move to from a tile, towards the nearest tile with a certain value by path, from the field of the value
+		as it was left by PrepareValueField(). The map is not changed, so this can be called on several threads at once
+ @param iValue A const int variable containing the value to move towards
+ @param currentPos A const glm::vec2& variable containing the tile to move from, with the row counted from the bottom of the map
+ @param nextPos A glm::vec2& variable to store the next tile
+ @return true if there is a next tile, or false if the current tile has the value, cannot reach it, or the field is not up to date
+ */
+bool CMap2D::GetNextStepInValueField(const int iValue, const glm::vec2& currentPos, glm::vec2& nextPos) const
+{
+	const CDistanceField* pField = GetPreparedValueField(iValue);
+	if ((pField == NULL) || (isBlocked(currentPos.y, currentPos.x)))
+		return false;
+
+	unsigned int uiNext = 0;
+	if (!pField->GetNextCell(cNavGrid.GetCell(currentPos.x, currentPos.y), uiNext))
+		return false;
+	nextPos = glm::vec2(cNavGrid.GetX(uiNext), cNavGrid.GetY(uiNext));
+	return true;
+}
+
+/**
+ @brief Bring the distance field of an indexed value up to date with the tiles, so that it can then be read
+		by FindNearestValueInField() and GetNextStepInValueField() on other threads until the tiles change
+ @param iValue A const int variable containing the value
+ @return true if the value is indexed, otherwise false
+ */
+bool CMap2D::PrepareValueField(const int iValue)
+{
+	return (GetValueField(iValue) != NULL);
+}
+
+/**
+ @brief Get the distance field of an indexed value if it is up to date with the tiles, without changing it
+ @param iValue A const int variable containing the value
+ @return The distance field, or NULL if the value is not indexed or its field has to be updated first
+ */
+const CDistanceField* CMap2D::GetPreparedValueField(const int iValue) const
+{
+	if ((iValue < 0) || (iValue > 0xFFFF))
+		return NULL;
+
+	std::map<TileValue, ValueField>::const_iterator it = mapOfValueFields.find((TileValue)iValue);
+	if ((it == mapOfValueFields.end()) || (it->second.bRebuild) || (!it->second.vecChangedCells.empty()) ||
+		(!it->second.cField.IsUpToDate(cNavGrid, m_nrOfDirections)))
+		return NULL;
+	return &it->second.cField;
 }
 
 /**
- @brief Render a tile at a position based on its tile index
- @param iRow A const int variable containing the row index of the tile
- @param iCol A const int variable containing the column index of the tile
+ @brief Get the distance field of an indexed value. 
+		It is built from mapOfValueIndices the first time, and again after the walkable tiles have changed. 
+		Otherwise the tiles of the value which were added or removed are added to or removed from it in place
+ @param iValue A const int variable containing the value
+ @return The distance field, or NULL if the value is not indexed
  */
-void CMap2D::RenderTile(const unsigned int uiRow, const unsigned int uiCol)
+CDistanceField* CMap2D::GetValueField(const int iValue)
 {
-	//if (arrMapInfo[uiCurLevel][uiRow][uiCol].value != 0)
-	if ((arrMapInfo[uiCurLevel][uiRow][uiCol].value > 0) &&
-		(arrMapInfo[uiCurLevel][uiRow][uiCol].value < 200))
+	if ((iValue < 0) || (iValue > 0xFFFF) || (!TileRules::IsIndexed((TileValue)iValue)))
+		return NULL;
+
+	std::map<TileValue, ValueField>::iterator it = mapOfValueFields.find((TileValue)iValue);
+	if (it == mapOfValueFields.end())
+	{
+		it = mapOfValueFields.insert(std::make_pair((TileValue)iValue, ValueField())).first;
+		it->second.bRebuild = true;
+	}
+	ValueField& valueField = it->second;
+
+	if ((valueField.bRebuild) || (!valueField.cField.IsUpToDate(cNavGrid, m_nrOfDirections)))
 	{
-		if (arrMapInfo[uiCurLevel][uiRow][uiCol].value > 3)
+		std::vector<unsigned int> vecSources;
+		const std::set<unsigned int>& setOfIndices = mapOfValueIndices[(TileValue)iValue];
+		for (std::set<unsigned int>::const_iterator itIndex = setOfIndices.begin(); itIndex != setOfIndices.end(); ++itIndex)
 		{
-			if (arrMapInfo[uiCurLevel][uiRow][uiCol].value == 20)
-			{
-				glBindTexture(GL_TEXTURE_2D, MapOfTextureIDs.at(1));
-				glBindVertexArray(VAO);
-				quadMesh->Render();
-				glBindVertexArray(0);
-			}
+			const unsigned int uiRow = *itIndex / cSettings->NUM_TILES_XAXIS;
+			vecSources.push_back(cNavGrid.GetCell(*itIndex % cSettings->NUM_TILES_XAXIS, cSettings->NUM_TILES_YAXIS - uiRow - 1));
+		}
+		valueField.cField.Build(cNavGrid, vecSources, m_nrOfDirections);
+		valueField.bRebuild = false;
+	}
+	else
+	{
+		for (unsigned int i = 0; i < valueField.vecChangedCells.size(); i++)
+		{
+			if (valueField.vecChangedCells[i].second)
+				valueField.cField.AddSource(cNavGrid, valueField.vecChangedCells[i].first);
 			else
-			{
-				// Search the same col to find similar background, break if found
-				for (unsigned col = 0; col < cSettings->NUM_TILES_XAXIS; col++)
-				{
-					if (arrMapInfo[uiCurLevel][uiRow][col].value <= 3)
-					{
-						glBindTexture(GL_TEXTURE_2D, MapOfTextureIDs.at(arrMapInfo[uiCurLevel][uiRow][col].value));
-						glBindVertexArray(VAO);
-						quadMesh->Render();
-						glBindVertexArray(0);
-						break;
-					}
-				}
-			}
+				valueField.cField.RemoveSource(cNavGrid, valueField.vecChangedCells[i].first);
 		}
+	}
+	valueField.vecChangedCells.clear();
+
+	return &valueField.cField;
+}
+
+/**
+ @brief Schedule a tile to be set to a value after a delay
+ @param dDelay A const double variable containing the number of seconds before the tile is set
+ @param uiRow A const unsigned int variable containing the row of the tile
+ @param uiCol A const unsigned int variable containing the column of the tile
+ @param iValue A const int variable containing the value to set the tile to
+ @param bInvert A const bool variable which indicates if the row information is inverted
+ */
+void CMap2D::ScheduleTileEvent(const double dDelay, const unsigned int uiRow, const unsigned int uiCol, const int iValue, const bool bInvert)
+{
+	if (!IsWithinMap(uiRow, uiCol))
+		return;
 
-		glBindTexture(GL_TEXTURE_2D, MapOfTextureIDs.at(arrMapInfo[uiCurLevel][uiRow][uiCol].value));
-		glBindVertexArray(VAO);
-		//CS: Render the tile
-		quadMesh->Render();
-		glBindVertexArray(0);
+	const unsigned int uiIndex = GetTileIndex(uiRow, uiCol, bInvert);
+	cTileEvents.Schedule(time + dDelay, uiIndex / cSettings->NUM_TILES_XAXIS, uiIndex % cSettings->NUM_TILES_XAXIS, iValue);
+}
+
+/**
+ @brief Set current level
+ */
+void CMap2D::SetCurrentLevel(unsigned int uiCurLevel)
+{
+	if (uiCurLevel < uiNumLevels)
+	{
+		this->uiCurLevel = uiCurLevel;
+		MarkTileChunksDirty();
+		ResetTileChanges();
+		RebuildValueIndices();
+		BuildNavGrid();
+		cTileEvents.Clear();
 	}
 }
+/**
+ @brief Get current level
+ */
+unsigned int CMap2D::GetCurrentLevel(void) const
+{
+	return uiCurLevel;
+}
 
 /**
- @brief Find a path
+ @brief Create the chunks for the size of the tile map
  */
-std::vector<glm::vec2> CMap2D::PathFind(const glm::vec2& startPos, const glm::vec2& targetPos, HeuristicFunction heuristicFunc, int weight)
+void CMap2D::InitTileChunks(void)
 {
-	// Check if the startPos and targetPost are blocked
-	if (isBlocked(startPos.y, startPos.x) ||
-		(isBlocked(targetPos.y, targetPos.x)))
+	while (vecBuiltChunks.size() > 0)
+		ReleaseTileChunk(vecBuiltChunks.back());
+
+	uiNumChunksX = (cSettings->NUM_TILES_XAXIS + TILE_CHUNK_SIZE - 1) / TILE_CHUNK_SIZE;
+	uiNumChunksY = (cSettings->NUM_TILES_YAXIS + TILE_CHUNK_SIZE - 1) / TILE_CHUNK_SIZE;
+	tileChunks.assign(uiNumChunksX * uiNumChunksY, TileChunk());
+}
+
+/**
+ @brief Build the vertex buffer of a chunk from the tiles in the current level.
+		Each tile has a background quad followed by a foreground quad, so that the item is drawn on top.
+		The UV coordinates of each quad come from cTileAtlas, so the whole chunk is drawn in one draw call.
+ @param uiChunk A const unsigned int variable containing the index of the chunk in tileChunks
+ */
+void CMap2D::BuildTileChunk(const unsigned int uiChunk)
+{
+	TileChunk& chunk = tileChunks[uiChunk];
+	if (chunk.batch == NULL)
 	{
-		cout << "Invalid start or target position." << endl;
-		// Return an empty path
-		std::vector<glm::vec2> path;
-		return path;
+		chunk.batch = new CQuadBatch();
+		vecBuiltChunks.push_back(uiChunk);
+	}
+
+	const unsigned int uiFirstCol = (uiChunk % uiNumChunksX) * TILE_CHUNK_SIZE;
+	const unsigned int uiFirstRow = (uiChunk / uiNumChunksX) * TILE_CHUNK_SIZE;
+	const unsigned int uiLastCol = glm::min(uiFirstCol + TILE_CHUNK_SIZE, cSettings->NUM_TILES_XAXIS);
+	const unsigned int uiLastRow = glm::min(uiFirstRow + TILE_CHUNK_SIZE, cSettings->NUM_TILES_YAXIS);
+
+	// Reserve an empty background quad and foreground quad for every tile in the chunk
+	chunk.batch->Clear();
+	for (unsigned int i = 0; i < TILE_CHUNK_SIZE * TILE_CHUNK_SIZE * 2; i++)
+		chunk.batch->AddQuad(glm::vec2(0.0f), glm::vec2(0.0f));
+
+	for (unsigned int uiRow = uiFirstRow; uiRow < uiLastRow; uiRow++)
+	{
+		for (unsigned int uiCol = uiFirstCol; uiCol < uiLastCol; uiCol++)
+			SetTileQuads(chunk, uiRow, uiCol);
 	}
+	chunk.batch->Upload();
 
-	// Set up the variables and lists
-	m_startPos = startPos;
-	m_targetPos = targetPos;
-	m_weight = weight;
-	m_heuristic = std::bind(heuristicFunc, _1, _2, _3);
+	chunk.bDirty = false;
+	chunk.vecDirtyTiles.clear();
+}
 
-	// Reset AStar lists
-	ResetAStarLists();
+/**
+ @brief Re-upload the quads of the changed tiles in a chunk
+ @param uiChunk A const unsigned int variable containing the index of the chunk in tileChunks
+ */
+void CMap2D::UpdateTileChunk(const unsigned int uiChunk)
+{
+	TileChunk& chunk = tileChunks[uiChunk];
 
-	// Add the start pos to 2 lists
-	m_cameFromList[ConvertTo1D(m_startPos)].parent = m_startPos;
-	m_openList.push(Grid(m_startPos, 0));
+	const unsigned int uiFirstCol = (uiChunk % uiNumChunksX) * TILE_CHUNK_SIZE;
+	const unsigned int uiFirstRow = (uiChunk / uiNumChunksX) * TILE_CHUNK_SIZE;
+	for (unsigned int i = 0; i < chunk.vecDirtyTiles.size(); i++)
+	{
+		const unsigned int uiTile = chunk.vecDirtyTiles[i];
+		SetTileQuads(chunk, uiFirstRow + uiTile / TILE_CHUNK_SIZE, uiFirstCol + uiTile % TILE_CHUNK_SIZE);
+		chunk.batch->UploadQuads(uiTile, 1);
+		chunk.batch->UploadQuads(TILE_CHUNK_SIZE * TILE_CHUNK_SIZE + uiTile, 1);
+	}
+	chunk.vecDirtyTiles.clear();
+}
 
-	unsigned int fNew, gNew, hNew;
-	glm::vec2 currentPos;
+/**
+ @brief Set the quads of a tile in the vertex buffer of its chunk. Quads which are not needed are set to an empty size
+ @param chunk A TileChunk& variable containing the chunk of the tile
+ @param uiRow A const unsigned int variable containing the row of the tile, counted from the top of the map
+ @param uiCol A const unsigned int variable containing the column of the tile
+ */
+void CMap2D::SetTileQuads(TileChunk& chunk, const unsigned int uiRow, const unsigned int uiCol)
+{
+	const unsigned int uiIndex = uiRow * cSettings->NUM_TILES_XAXIS + uiCol;
+	const unsigned int uiTile = (uiRow % TILE_CHUNK_SIZE) * TILE_CHUNK_SIZE + (uiCol % TILE_CHUNK_SIZE);
+
+	// The values to draw in the background and foreground layers of this tile.
+	// Background tiles and the spawn points are only drawn in the background layer
+	const TileValue value = arrMapInfo[uiCurLevel][uiIndex];
+	TileValue arrLayers[2] = { arrBackgroundInfo[uiCurLevel][uiIndex], 0 };
+	if ((value > 3) && (value < 200))
+		arrLayers[1] = value;
+
+	const glm::vec2 vec2Position = glm::vec2(cSettings->ConvertIndexToUVSpace(cSettings->x, uiCol, false, 0),
+											 cSettings->ConvertIndexToUVSpace(cSettings->y, uiRow, true, 0));
+	const glm::vec2 vec2TileSize = glm::vec2(cSettings->TILE_WIDTH, cSettings->TILE_HEIGHT);
+	glm::vec2 vec2UVMin, vec2UVMax;
+	for (unsigned int uiLayer = 0; uiLayer < 2; uiLayer++)
+	{
+		const unsigned int uiQuad = uiLayer * TILE_CHUNK_SIZE * TILE_CHUNK_SIZE + uiTile;
+		if ((arrLayers[uiLayer] != 0) && (cTileAtlas->GetUVRect(arrLayers[uiLayer], vec2UVMin, vec2UVMax)))
+			chunk.batch->SetQuad(uiQuad, vec2Position, vec2TileSize, vec2UVMin, vec2UVMax);
+		else
+			chunk.batch->SetQuad(uiQuad, vec2Position, glm::vec2(0.0f));
+	}
+}
 
-	// Start the path finding...
-	while (!m_openList.empty())
+/**
+ @brief Build the background layer of a level from its tiles, using the rules in TileRules::BuildBackgroundRow()
+ @param uiLevel A const unsigned int variable containing the level to build the background layer for
+ */
+void CMap2D::BuildBackgroundLayer(const unsigned int uiLevel)
+{
+	for (unsigned int uiRow = 0; uiRow < cSettings->NUM_TILES_YAXIS; uiRow++)
 	{
-		// Get the node with the least f value
-		currentPos = m_openList.top().pos;
-		//cout << endl << "*** New position to check: " << currentPos.x << ", " << currentPos.y << endl;
-		//cout << "*** targetPos: " << m_targetPos.x << ", " << m_targetPos.y << endl;
+		TileRules::BuildBackgroundRow(	arrMapInfo[uiLevel] + uiRow * cSettings->NUM_TILES_XAXIS,
+										arrBackgroundInfo[uiLevel] + uiRow * cSettings->NUM_TILES_XAXIS,
+										cSettings->NUM_TILES_XAXIS);
+	}
+}
 
-		// If the targetPos was reached, then quit this loop
-		if (currentPos == m_targetPos)
+/**
+ @brief Delete the vertex buffer of a chunk
+ @param uiChunk A const unsigned int variable containing the index of the chunk in tileChunks
+ */
+void CMap2D::ReleaseTileChunk(const unsigned int uiChunk)
+{
+	TileChunk& chunk = tileChunks[uiChunk];
+	if (chunk.batch == NULL)
+		return;
+
+	delete chunk.batch;
+	chunk.batch = NULL;
+	chunk.bDirty = true;
+
+	// Remove it from vecBuiltChunks by moving the last element into its place
+	for (unsigned int i = 0; i < vecBuiltChunks.size(); i++)
+	{
+		if (vecBuiltChunks[i] == uiChunk)
 		{
-			//cout << "=== Found the targetPos: " << m_targetPos.x << ", " << m_targetPos.y << endl;
-			while (m_openList.size() != 0)
-				m_openList.pop();
+			vecBuiltChunks[i] = vecBuiltChunks.back();
+			vecBuiltChunks.pop_back();
 			break;
 		}
+	}
+}
+
+/**
+ @brief Mark all the chunks to be rebuilt, e.g. when the level is changed
+ */
+void CMap2D::MarkTileChunksDirty(void)
+{
+	for (unsigned int i = 0; i < vecBuiltChunks.size(); i++)
+		tileChunks[vecBuiltChunks[i]].bDirty = true;
+}
+
+/**
+ @brief Record a change of a tile value and update the cached data which depends on it.
+		This is called for every tile changed with SetMapInfo()
+ @param uiRow A const unsigned int variable containing the row of the tile, counted from the top of the map
+ @param uiCol A const unsigned int variable containing the column of the tile
+ @param oldValue A const TileValue variable containing the value of the tile before the change
+ @param newValue A const TileValue variable containing the value of the tile after the change
+ */
+void CMap2D::OnTileChanged(const unsigned int uiRow, const unsigned int uiCol, const TileValue oldValue, const TileValue newValue)
+{
+	// Add the change to the change list, dropping the older half of the list when it is full
+	if (vecTileChanges.size() >= MAX_TILE_CHANGES)
+	{
+		vecTileChanges.erase(vecTileChanges.begin(), vecTileChanges.begin() + MAX_TILE_CHANGES / 2);
+		uiTileChangesBase += MAX_TILE_CHANGES / 2;
+	}
+	TileChange change;
+	change.uiRow = uiRow;
+	change.uiCol = uiCol;
+	change.oldValue = oldValue;
+	change.newValue = newValue;
+	vecTileChanges.push_back(change);
+	uiMapRevision++;
+
+	// Keep the positions of the indexed values up to date
+	const unsigned int uiIndex = uiRow * cSettings->NUM_TILES_XAXIS + uiCol;
+	if (TileRules::IsIndexed(oldValue))
+		mapOfValueIndices[oldValue].erase(uiIndex);
+	if (TileRules::IsIndexed(newValue))
+		mapOfValueIndices[newValue].insert(uiIndex);
+
+	// Record the tile in the distance fields of both values, so that they are updated in place when they are next used
+	const unsigned int uiCell = cNavGrid.GetCell(uiCol, cSettings->NUM_TILES_YAXIS - uiRow - 1);
+	std::map<TileValue, ValueField>::iterator itField = mapOfValueFields.find(oldValue);
+	if ((itField != mapOfValueFields.end()) && (!itField->second.bRebuild))
+		itField->second.vecChangedCells.push_back(std::make_pair(uiCell, false));
+	itField = mapOfValueFields.find(newValue);
+	if ((itField != mapOfValueFields.end()) && (!itField->second.bRebuild))
+		itField->second.vecChangedCells.push_back(std::make_pair(uiCell, true));
+
+	// Respawn a live after it has been picked up
+	static const double LIVE_RESPAWN_TIME = 5.0;
+	if ((oldValue == 5) && (newValue != 5))
+		cTileEvents.Schedule(time + LIVE_RESPAWN_TIME, uiRow, uiCol, 5);
+
+	// Setting a background tile replaces the background drawn in this tile
+	if ((newValue > 0) && (newValue <= 3))
+		arrBackgroundInfo[uiCurLevel][uiIndex] = newValue;
+
+	// A tile decides if it can be entered, and if the tile above it can be stood in
+	const unsigned int uiNavY = cSettings->NUM_TILES_YAXIS - uiRow - 1;
+	UpdateNavCell(uiCol, uiNavY);
+	if (uiNavY + 1 < cSettings->NUM_TILES_YAXIS)
+		UpdateNavCell(uiCol, uiNavY + 1);
+
+	// Update the quads of the chunk containing this tile
+	TileChunk& chunk = tileChunks[(uiRow / TILE_CHUNK_SIZE) * uiNumChunksX + uiCol / TILE_CHUNK_SIZE];
+	if (!chunk.bDirty)
+		chunk.vecDirtyTiles.push_back((uiRow % TILE_CHUNK_SIZE) * TILE_CHUNK_SIZE + (uiCol % TILE_CHUNK_SIZE));
+}
 
-		m_openList.pop();
-		m_closedList[ConvertTo1D(currentPos)] = true;
+/**
+ @brief Rebuild mapOfValueIndices from the tiles in the current level.
+		This scans the level once, so that finding the spawn points and items afterwards does not scan it again
+ */
+void CMap2D::RebuildValueIndices(void)
+{
+	mapOfValueIndices.clear();
+	mapOfValueFields.clear();
 
-		// Check the neighbors of the current node
-		for (unsigned int i = 0; i < m_nrOfDirections; ++i)
+	const TileValue* pLevel = arrMapInfo[uiCurLevel];
+	const unsigned int uiNumTiles = cSettings->NUM_TILES_YAXIS * cSettings->NUM_TILES_XAXIS;
+	for (unsigned int uiIndex = 0; uiIndex < uiNumTiles; uiIndex++)
+	{
+		if (TileRules::IsIndexed(pLevel[uiIndex]))
 		{
-			const auto neighborPos = currentPos + m_directions[i];
-			const auto neighborIndex = ConvertTo1D(neighborPos);
+			// The indices are visited in order, so they are appended at the end of the set
+			std::set<unsigned int>& setOfIndices = mapOfValueIndices[pLevel[uiIndex]];
+			setOfIndices.insert(setOfIndices.end(), uiIndex);
+		}
+	}
+}
 
-			//cout << "\t#" << i << ": Check this: " << neighborPos.x << ", " << neighborPos.y << ":\t";
-			if (!isValid(neighborPos) ||
-				isBlocked(neighborPos.y, neighborPos.x) ||
-				m_closedList[neighborIndex] == true)
-			{
-				//cout << "This position is not valid. Going to next neighbour." << endl;
-				continue;
-			}
+/**
+ @brief Build mapOfValueIndices from the spawn table of a binary map file of the current level. 
+		Each listed tile must have its value, and the number of tiles found for each indexed value must match 
+		the count stored in the file, so a table which misses tiles is not used. Files before version 3 have no counts, 
+		so they are not used either. The caller scans the tiles with RebuildValueIndices() when this fails
+ @param cMapFile A const CMapFile& variable containing the open map file
+ @return true if mapOfValueIndices was built, otherwise false
+ */
+bool CMap2D::LoadValueIndices(const CMapFile& cMapFile)
+{
+	if (cMapFile.GetVersion() < 3)
+		return false;
 
-			gNew = m_cameFromList[ConvertTo1D(currentPos)].g + 1;
-			hNew = m_heuristic(neighborPos, m_targetPos, m_weight);
-			fNew = gNew + hNew;
+	mapOfValueIndices.clear();
+	mapOfValueFields.clear();
 
-			if (m_cameFromList[neighborIndex].f == 0 || fNew < m_cameFromList[neighborIndex].f)
-			{
-				//cout << "Adding to Open List: " << neighborPos.x << ", " << neighborPos.y;
-				// cout << ". [ f : " << fNew << ", g : " << gNew << ", h : " << hNew << "]" << endl;
-				m_openList.push(Grid(neighborPos, fNew));
-				m_cameFromList[neighborIndex] = { neighborPos, currentPos, fNew, gNew, hNew };
-			}
-			else
-			{
-				//cout << "Not adding this" << endl;
-			}
+	const TileValue* pLevel = arrMapInfo[uiCurLevel];
+	const MapFileSpawn* pSpawns = cMapFile.GetSpawns();
+	for (unsigned int i = 0; i < cMapFile.GetNumSpawns(); i++)
+	{
+		const MapFileSpawn& spawn = pSpawns[i];
+		const unsigned int uiIndex = spawn.uiRow * cSettings->NUM_TILES_XAXIS + spawn.uiCol;
+		if ((spawn.uiRow >= cSettings->NUM_TILES_YAXIS) || (spawn.uiCol >= cSettings->NUM_TILES_XAXIS) ||
+			(pLevel[uiIndex] != spawn.usValue) || (!TileRules::IsIndexed(spawn.usValue)))
+		{
+			cout << "The spawn table of the binary map does not match its tiles." << endl;
+			return false;
+		}
+		mapOfValueIndices[spawn.usValue].insert(uiIndex);
+	}
+
+	// Every indexed value must have a count, and the distinct tiles listed must be as many as the count
+	const MapFileValueCount* pValueCounts = cMapFile.GetValueCounts();
+	for (unsigned int i = 0; i < TileRules::NUM_INDEXED_VALUES; i++)
+	{
+		const TileValue value = TileRules::INDEXED_VALUES[i];
+		unsigned int j = 0;
+		while ((j < cMapFile.GetNumValueCounts()) && (pValueCounts[j].usValue != value))
+			j++;
+
+		std::map<TileValue, std::set<unsigned int>>::const_iterator it = mapOfValueIndices.find(value);
+		const size_t numListed = (it != mapOfValueIndices.end() ? it->second.size() : 0);
+		if ((j == cMapFile.GetNumValueCounts()) || (pValueCounts[j].uiCount != numListed))
+		{
+			cout << "The spawn table of the binary map is missing tiles of value " << value << "." << endl;
+			return false;
 		}
-		//system("pause");
 	}
 
-	return BuildPath();
+	return true;
+}
+
+/**
+ @brief Discard the recorded tile changes, when the whole level has been replaced.
+		The revision is increased, so callers of GetTileChangesSince() know that they have to rebuild their data
+ */
+void CMap2D::ResetTileChanges(void)
+{
+	vecTileChanges.clear();
+	uiMapRevision++;
+	uiTileChangesBase = uiMapRevision;
 }
 
 /**
- @brief Build a path
+ @brief Find a path
  */
-std::vector<glm::vec2> CMap2D::BuildPath() const
+std::vector<glm::vec2> CMap2D::PathFind(const glm::vec2& startPos, const glm::vec2& targetPos, HeuristicFunction heuristicFunc, int weight)
 {
 	std::vector<glm::vec2> path;
-	auto currentPos = m_targetPos;
-	auto currentIndex = ConvertTo1D(currentPos);
+	PathFind(startPos, targetPos, heuristicFunc, weight, path);
+	return path;
+}
+
+/**
+ @brief Find a path, storing it in a vector which can be reused between searches
+ @param startPos A const glm::vec2& variable containing the start tile, with the row counted from the bottom of the map
+ @param targetPos A const glm::vec2& variable containing the target tile, with the row counted from the bottom of the map
+ @param heuristicFunc A HeuristicFunction variable which estimates the cost from a tile to the target
+ @param weight A const int variable containing the weight passed to heuristicFunc
+ @param path A std::vector<glm::vec2>& variable to store the tiles of the path, excluding the start tile
+ @return true if the target can be reached, otherwise false
+ */
+bool CMap2D::PathFind(	const glm::vec2& startPos,
+						const glm::vec2& targetPos,
+						HeuristicFunction heuristicFunc,
+						const int weight,
+						std::vector<glm::vec2>& path)
+{
+	path.clear();
 
-	while (!(m_cameFromList[currentIndex].parent == currentPos))
+	// Check if the startPos and targetPost are blocked
+	if (isBlocked(startPos.y, startPos.x) ||
+		(isBlocked(targetPos.y, targetPos.x)))
 	{
-		path.push_back(currentPos);
-		currentPos = m_cameFromList[currentIndex].parent;
-		currentIndex = ConvertTo1D(currentPos);
+		cout << "Invalid start or target position." << endl;
+		return false;
 	}
 
-	// If the path has only 1 entry, then it is the the target position
-	if (path.size() == 1)
+	// Reuse the result of an earlier search in the same revision of cNavGrid
+	CPathCache::Key key;
+	key.uiStart = cNavGrid.GetCell(startPos.x, startPos.y);
+	key.uiGoal = cNavGrid.GetCell(targetPos.x, targetPos.y);
+	key.uiHeuristic = reinterpret_cast<size_t>(heuristicFunc);
+	key.iWeight = weight;
+	key.uiNumDirections = m_nrOfDirections;
+	cPathCache.SetRevision(cNavGrid.GetRevision());
+	bool bFound = false;
+	if (cPathCache.Find(key, bFound, vecPathCells))
+	{
+		GetPathFromCells(path);
+		return bFound;
+	}
+
+	// Run a search compiled for the heuristic, if it is one of the heuristics in the heuristic namespace
+	if (heuristicFunc == heuristic::euclidean)
+		bFound = PathFind<Heuristics::Euclidean>(startPos, targetPos, weight, path);
+	else if (heuristicFunc == heuristic::manhattan)
+		bFound = PathFind<Heuristics::Manhattan>(startPos, targetPos, weight, path);
+	else if (heuristicFunc == heuristic::octile)
+		bFound = PathFind<Heuristics::Octile>(startPos, targetPos, weight, path);
+	else if (heuristicFunc == heuristic::zero)
+		bFound = PathFind<Heuristics::Zero>(startPos, targetPos, weight, path);
+	else
 	{
-		// if m_startPos is next to m_targetPos, then having 1 path point is OK
-		if (m_nrOfDirections == 4)
-		{
-			if (abs(m_targetPos.y - m_startPos.y) + abs(m_targetPos.x - m_startPos.x) > 1)
-				path.clear();
-		}
-		else
+		// Otherwise call the heuristic through its pointer
+		const CNavGrid& cGrid = cNavGrid;
+		auto heuristicToTarget = [&](const unsigned int uiCell)
 		{
-			if (abs(m_targetPos.y - m_startPos.y) + abs(m_targetPos.x - m_startPos.x) > 2)
-				path.clear();
-			else if (abs(m_targetPos.y - m_startPos.y) + abs(m_targetPos.x - m_startPos.x) > 1)
-				path.clear();
-		}
+			return heuristicFunc(glm::vec2(cGrid.GetX(uiCell), cGrid.GetY(uiCell)), targetPos, weight);
+		};
+		bFound = PathFindWith(startPos, targetPos, heuristicToTarget, path);
 	}
-	else
-		std::reverse(path.begin(), path.end());
 
-	/*
-	std::cout << m_startPos.y << ", " << m_startPos.x << std::endl;
-	std::cout << m_targetPos.y << ", " << m_targetPos.x << std::endl;
-	std::cout << "     1  2  3  4  5  6  7  8  9  10 11 12 13 14 15 16 17 18 19 20 21 22 23 24 25 26 27 28 29 30 31 32" << std::endl;
-	for (unsigned y = 0; y < cSettings->NUM_TILES_YAXIS; ++y)
+	cPathCache.Add(key, bFound, vecPathCells);
+	return bFound;
+}
+
+/**
+ @brief Check if a cell of cNavGrid may reach another. 
+		cReachability is updated first if the tiles have changed since it was last used, 
+		so a target which cannot be reached is found without a search
+ @param uiStart A const unsigned int variable containing the start cell
+ @param uiTarget A const unsigned int variable containing the target cell
+ @return false if the target cannot be reached, or true if it may be reached
+ */
+bool CMap2D::CanReach(const unsigned int uiStart, const unsigned int uiTarget)
+{
+	cReachability.Update(cNavGrid, m_nrOfDirections);
+	return cReachability.CanReach(uiStart, uiTarget);
+}
+
+/**
+ @brief Convert the cells in vecPathCells into the tiles of a path
+ @param path A std::vector<glm::vec2>& variable to store the tiles, with the rows counted from the bottom of the map
+ */
+void CMap2D::GetPathFromCells(std::vector<glm::vec2>& path) const
+{
+	path.clear();
+	path.reserve(vecPathCells.size());
+	for (unsigned int i = 0; i < vecPathCells.size(); i++)
+		path.push_back(glm::vec2(cNavGrid.GetX(vecPathCells[i]), cNavGrid.GetY(vecPathCells[i])));
+}
+
+/**
+ @brief Get the next tile to move to from a tile towards a target. 
+		The distance field from the target is only rebuilt when the target has moved to another tile 
+		or the walkable tiles have changed, so all the callers chasing the same target share one search
+ @param targetPos A const glm::vec2& variable containing the target tile, with the row counted from the bottom of the map
+ @param currentPos A const glm::vec2& variable containing the tile to move from
+ @param nextPos A glm::vec2& variable to store the next tile
+ @return true if there is a next tile, or false if the current tile is the target or cannot reach it
+ */
+bool CMap2D::GetNextStepTo(const glm::vec2& targetPos, const glm::vec2& currentPos, glm::vec2& nextPos)
+{
+	PrepareChaseField(targetPos);
+	return GetNextStepInChaseField(targetPos, currentPos, nextPos);
+}
+
+/**
+ @brief Build the distance field from a target for GetNextStepTo(), unless it is already up to date, 
+		so that it can then be read by GetNextStepInChaseField() on other threads until the target or the tiles change
+ @param targetPos A const glm::vec2& variable containing the target tile, with the row counted from the bottom of the map
+ @return true if the target can be moved to, otherwise false
+ */
+bool CMap2D::PrepareChaseField(const glm::vec2& targetPos)
+{
+	if (isBlocked(targetPos.y, targetPos.x))
+		return false;
+
+	const unsigned int uiTarget = cNavGrid.GetCell(targetPos.x, targetPos.y);
+	if ((!cChaseField.IsUpToDate(cNavGrid, m_nrOfDirections)) ||
+		(cChaseField.GetSources().size() != 1) || (cChaseField.GetSources()[0] != uiTarget))
 	{
-		std::cout << y + 1 << ((y < 9) ? ("  | ") : (" | "));
-		for (unsigned x = 0; x < cSettings->NUM_TILES_XAXIS; ++x)
-		{
-			bool valueFound = false;
-			for (unsigned i = 0; i < path.size(); ++i)
-			{
-				if ((path[i].y == y) && (path[i].x == x))
-				{
-					valueFound = true;
-					std::cout << "1, ";
-					break;
-				}
-			}
-			if (valueFound == false)
-				std::cout << "0, ";
-		}
-		std::cout << std::endl;
+		vecChaseSources.assign(1, uiTarget);
+		cChaseField.Build(cNavGrid, vecChaseSources, m_nrOfDirections);
 	}
-	std::cout << std::endl;
-	*/
+	return true;
+}
 
-	return path;
+/**
+ @brief Get the next tile to move to from a tile towards a target, from the distance field as it was left by PrepareChaseField().
+		The map is not changed, so this can be called on several threads at once
+ @param targetPos A const glm::vec2& variable containing the target tile, with the row counted from the bottom of the map
+ @param currentPos A const glm::vec2& variable containing the tile to move from
+ @param nextPos A glm::vec2& variable to store the next tile
+ @return true if there is a next tile, or false if the current tile is the target, cannot reach it, 
+		or the field has not been prepared for the target
+ */
+bool CMap2D::GetNextStepInChaseField(const glm::vec2& targetPos, const glm::vec2& currentPos, glm::vec2& nextPos) const
+{
+	if (isBlocked(currentPos.y, currentPos.x) ||
+		(isBlocked(targetPos.y, targetPos.x)))
+		return false;
+
+	const unsigned int uiTarget = cNavGrid.GetCell(targetPos.x, targetPos.y);
+	if ((!cChaseField.IsUpToDate(cNavGrid, m_nrOfDirections)) ||
+		(cChaseField.GetSources().size() != 1) || (cChaseField.GetSources()[0] != uiTarget))
+		return false;
+
+	unsigned int uiNext = 0;
+	if (!cChaseField.GetNextCell(cNavGrid.GetCell(currentPos.x, currentPos.y), uiNext))
+		return false;
+	nextPos = glm::vec2(cNavGrid.GetX(uiNext), cNavGrid.GetY(uiNext));
+	return true;
+}
+
+/**
+ @brief Find a path with the caller's own incremental planner. 
+		The planner keeps its search between calls, so following a path, moving the target by a tile, 
+		or changing a few tiles only searches again where the costs of the path have changed
+ @param cPlanner A CDStarLite& variable containing the planner of the caller, which must not be shared with other callers
+ @param startPos A const glm::vec2& variable containing the start tile, with the row counted from the bottom of the map
+ @param targetPos A const glm::vec2& variable containing the target tile
+ @param path A std::vector<glm::vec2>& variable to store the tiles of the path, excluding the start tile
+ @return true if the target can be reached, otherwise false
+ */
+bool CMap2D::PathFindIncremental(	CDStarLite& cPlanner,
+									const glm::vec2& startPos,
+									const glm::vec2& targetPos,
+									std::vector<glm::vec2>& path)
+{
+	path.clear();
+	if ((!IsWithinMap(startPos.y, startPos.x)) || (!IsWithinMap(targetPos.y, targetPos.x)) ||
+		(isBlocked(targetPos.y, targetPos.x)))
+		return false;
+
+	const unsigned int uiStart = cNavGrid.GetCell(startPos.x, startPos.y);
+	const unsigned int uiTarget = cNavGrid.GetCell(targetPos.x, targetPos.y);
+	if ((!CanReach(uiStart, uiTarget)) ||
+		(!cPlanner.Plan(cNavGrid, uiStart, uiTarget, m_nrOfDirections, vecPathCells)))
+		return false;
+
+	GetPathFromCells(path);
+	return true;
+}
+
+/**
+ @brief Submit a request for a path, which is found on a worker thread and delivered on a later frame. 
+		The workers search a copy of the current level, so the map can keep changing while they run. 
+		The copy is brought up to date with only the cells which changed since an earlier copy
+ @param startPos A const glm::vec2& variable containing the start tile, with the row counted from the bottom of the map
+ @param targetPos A const glm::vec2& variable containing the target tile
+ @param pPlanner A const std::shared_ptr<CDStarLite>& variable containing the planner of the caller to repair its last path, 
+		or NULL to search with A*. It must not be used while IsPlannerBusy() is true
+ @return The ID of the request, or CPathJobQueue::JOB_NONE if the request is invalid or the target cannot be reached
+ */
+unsigned int CMap2D::RequestPath(const glm::vec2& startPos, const glm::vec2& targetPos, const std::shared_ptr<CDStarLite>& pPlanner)
+{
+	if ((!IsWithinMap(startPos.y, startPos.x)) || (!IsWithinMap(targetPos.y, targetPos.x)) ||
+		(isBlocked(targetPos.y, targetPos.x)))
+		return CPathJobQueue::JOB_NONE;
+
+	const unsigned int uiStart = cNavGrid.GetCell(startPos.x, startPos.y);
+	const unsigned int uiTarget = cNavGrid.GetCell(targetPos.x, targetPos.y);
+	if (!CanReach(uiStart, uiTarget))
+		return CPathJobQueue::JOB_NONE;
+
+	return cPathJobQueue.Submit(cNavGridSnapshot.Get(cNavGrid), uiStart, uiTarget, m_nrOfDirections, pPlanner);
+}
+
+/**
+ @brief Take the path of a request once it has been delivered
+ @param uiRequest A const unsigned int variable containing the ID from RequestPath()
+ @param path A std::vector<glm::vec2>& variable to store the tiles of the path, excluding the start tile. 
+		It is cleared if the target cannot be reached, and is not changed while the request is pending
+ @return The state of the request
+ */
+CPathJobQueue::JOB_STATUS CMap2D::CollectPath(const unsigned int uiRequest, std::vector<glm::vec2>& path)
+{
+	const CPathJobQueue::JOB_STATUS eStatus = cPathJobQueue.GetResult(uiRequest, vecPathCells);
+	if (eStatus == CPathJobQueue::JOB_FOUND)
+		GetPathFromCells(path);
+	else if (eStatus == CPathJobQueue::JOB_NOT_FOUND)
+		path.clear();
+	return eStatus;
+}
+
+/**
+ @brief Cancel a request whose path is no longer needed. This does not wait for a search which is running, 
+		so the planner of the request may still be busy when this returns
+ @param uiRequest A const unsigned int variable containing the ID from RequestPath()
+ */
+void CMap2D::CancelPath(const unsigned int uiRequest)
+{
+	cPathJobQueue.Cancel(uiRequest);
+}
+
+/**
+ @brief Check if a planner is still used by a request, including a cancelled request whose search has not finished
+ @param pPlanner A const CDStarLite* variable containing the planner
+ */
+bool CMap2D::IsPlannerBusy(const CDStarLite* pPlanner) const
+{
+	return cPathJobQueue.IsPlannerBusy(pPlanner);
 }
 
 /**
@@ -848,7 +1467,7 @@ void CMap2D::PrintSelf(void) const
 			{
 				cout.fill('0');
 				cout.width(3);
-				cout << arrMapInfo[uiLevel][uiRow][uiCol].value;
+				cout << arrMapInfo[uiLevel][uiRow * cSettings->NUM_TILES_XAXIS + uiCol];
 				if (uiCol != cSettings->NUM_TILES_XAXIS - 1)
 					cout << ", ";
 				else
@@ -857,120 +1476,86 @@ void CMap2D::PrintSelf(void) const
 		}
 	}
 
-	cout << "m_openList: " << m_openList.size() << endl;
-	cout << "m_cameFromList: " << m_cameFromList.size() << endl;
-	cout << "m_closedList: " << m_closedList.size() << endl;
+	cout << "cNavGrid: " << cNavGrid.GetWidth() << " x " << cNavGrid.GetHeight() << endl;
+	cout << "Cells expanded by the last search: " << cAStar.GetNumExpanded() << endl;
+	cout << "HPA* clusters: " << cHPAStar.GetNumClusters() << ", built: " << cHPAStar.GetNumClusterBuilds() << endl;
+	cout << "Path cache hits: " << cPathCache.GetNumHits() << ", misses: " << cPathCache.GetNumMisses() << endl;
 
 	cout << "===== AStar::PrintSelf() =====" << endl;
 }
 
 /**
- @brief Check if a position is valid
+ @brief Check if a grid is blocked
  */
-bool CMap2D::isValid(const glm::vec2& pos) const
+bool CMap2D::isBlocked(const unsigned int uiRow, const unsigned int uiCol, const bool bInvert) const
 {
-	//return (pos.x >= 0) && (pos.x < m_dimensions.x) &&
-	//	(pos.y >= 0) && (pos.y < m_dimensions.y);
-	unsigned currTileVal = arrMapInfo[uiCurLevel][cSettings->NUM_TILES_YAXIS - static_cast<unsigned>(pos.y) - 1][static_cast<unsigned>(pos.x)].value;
-	unsigned tileValBelow = arrMapInfo[uiCurLevel][cSettings->NUM_TILES_YAXIS - static_cast<unsigned>(pos.y)][static_cast<unsigned>(pos.x)].value;
-	return (pos.x >= 0) && (pos.x < cSettings->NUM_TILES_XAXIS) &&
-		   (pos.y >= 0) && (pos.y < cSettings->NUM_TILES_YAXIS) &&
-		   ( (tileValBelow == 30) || ((tileValBelow >= 100) && (tileValBelow <= 120)) ||
-			 ((currTileVal >= 5) && (currTileVal <= 60)) );
+	if (!IsWithinMap(uiRow, uiCol))
+		return true;
+
+	return TileRules::IsBlocked(arrMapInfo[uiCurLevel][GetTileIndex(uiRow, uiCol, bInvert)]);
 }
 
 /**
- @brief Check if a grid is blocked
+ @brief Build cNavGrid from the tiles in the current level
  */
-bool CMap2D::isBlocked(const unsigned int uiRow, const unsigned int uiCol, const bool bInvert) const
+void CMap2D::BuildNavGrid(void)
 {
-	if (bInvert == true)
-	{
-		if ((arrMapInfo[uiCurLevel][cSettings->NUM_TILES_YAXIS - uiRow - 1][uiCol].value >= 100) &&
-			(arrMapInfo[uiCurLevel][cSettings->NUM_TILES_YAXIS - uiRow - 1][uiCol].value < 200))
-			return true;
-		else
-			return false;
-	}
-	else
+	cNavGrid.Init(cSettings->NUM_TILES_XAXIS, cSettings->NUM_TILES_YAXIS);
+	for (unsigned int uiY = 0; uiY < cSettings->NUM_TILES_YAXIS; uiY++)
 	{
-		if ((arrMapInfo[uiCurLevel][uiRow][uiCol].value >= 100) &&
-			(arrMapInfo[uiCurLevel][uiRow][uiCol].value < 200))
-			return true;
-		else
-			return false;
+		for (unsigned int uiX = 0; uiX < cSettings->NUM_TILES_XAXIS; uiX++)
+			UpdateNavCell(uiX, uiY);
 	}
+	// Build the clusters now, so that the first long path does not stall a frame to build them
+	cHPAStar.Init(cNavGrid);
+	cHPAStar.Build(cNavGrid);
 }
 
 /**
- @brief Returns a 1D index based on a 2D coordinate using row-major layout
+ @brief Update a cell of cNavGrid from the tiles in the current level, see TileRules::GetNavCellType()
+ @param uiX A const unsigned int variable containing the column of the cell
+ @param uiY A const unsigned int variable containing the row of the cell, counted from the bottom of the map
  */
-int CMap2D::ConvertTo1D(const glm::vec2& pos) const
+void CMap2D::UpdateNavCell(const unsigned int uiX, const unsigned int uiY)
 {
-	//return (pos.y * m_dimensions.x) + pos.x;
-	return (pos.y * cSettings->NUM_TILES_XAXIS) + pos.x;
+	const TileValue value = arrMapInfo[uiCurLevel][GetTileIndex(uiY, uiX)];
+	const TileValue valueBelow = (uiY > 0) ? arrMapInfo[uiCurLevel][GetTileIndex(uiY - 1, uiX)] : 0;
+	const unsigned int uiRevision = cNavGrid.GetRevision();
+	cNavGrid.SetCell(uiX, uiY, TileRules::GetNavCellType(value, valueBelow), TileRules::GetNavPenalty(value));
+	if (cNavGrid.GetRevision() != uiRevision)
+		cHPAStar.OnCellChanged(uiX, uiY);
 }
 
 /**
- @brief Delete AStar lists
+ @brief manhattan calculation method for calculation of h
  */
-bool CMap2D::DeleteAStarLists(void)
+unsigned int heuristic::manhattan(const glm::vec2& v1, const glm::vec2& v2, int weight)
 {
-	// Delete m_openList
-	while (m_openList.size() != 0)
-		m_openList.pop();
-	// Delete m_cameFromList
-	m_cameFromList.clear();
-	// Delete m_closedList
-	m_closedList.clear();
-
-	return true;
+	return Heuristics::Manhattan::Get((int)abs(v2.x - v1.x), (int)abs(v2.y - v1.y), weight);
 }
 
-
 /**
- @brief Reset AStar lists
+ @brief euclidean calculation method for calculation of h
  */
-bool CMap2D::ResetAStarLists(void)
+unsigned int heuristic::euclidean(const glm::vec2& v1, const glm::vec2& v2, int weight)
 {
-	// Delete m_openList
-	while (m_openList.size() != 0)
-		m_openList.pop();
-	// Reset m_cameFromList
-	for (int i = 0; i < m_cameFromList.size(); i++)
-	{
-		m_cameFromList[i].pos = glm::vec2(0, 0);
-		m_cameFromList[i].parent = glm::vec2(0, 0);
-		m_cameFromList[i].f = 0;
-		m_cameFromList[i].g = 0;
-		m_cameFromList[i].h = 0;
-	}
-	// Reset m_closedList
-	for (int i = 0; i < m_closedList.size(); i++)
-	{
-		m_closedList[i] = false;
-	}
-
-	return true;
+	return Heuristics::Euclidean::Get((int)abs(v2.x - v1.x), (int)abs(v2.y - v1.y), weight);
 }
 
-
 /**
- @brief manhattan calculation method for calculation of h
+ @brief octile calculation method for calculation of h
  */
-unsigned int heuristic::manhattan(const glm::vec2& v1, const glm::vec2& v2, int weight)
+unsigned int heuristic::octile(const glm::vec2& v1, const glm::vec2& v2, int weight)
 {
-	glm::vec2 delta = v2 - v1;
-	return static_cast<unsigned int>(weight * (delta.x + delta.y));
+	return Heuristics::Octile::Get((int)abs(v2.x - v1.x), (int)abs(v2.y - v1.y), weight);
 }
 
 /**
- @brief euclidean calculation method for calculation of h
+ @brief zero calculation method for calculation of h, which turns AStar into Dijkstra's algorithm
  */
-unsigned int heuristic::euclidean(const glm::vec2& v1, const glm::vec2& v2, int weight)
+unsigned int heuristic::zero(const glm::vec2& v1, const glm::vec2& v2, int weight)
 {
-	glm::vec2 delta = v2 - v1;
-	return static_cast<unsigned int>(weight * sqrt((delta.x * delta.x) + (delta.y * delta.y)));
+	return 0;
 }
 
 void CMap2D::SetEnemyCount(const unsigned value)
@@ -983,30 +1568,19 @@ const unsigned& CMap2D::GetEnemyCount() const
 	return enemyCount;
 }
 
-map<pair<float, float>, double>& CMap2D::GetLiveMap()
-{
-	return liveMap;
-}
-
 const double& CMap2D::GetTime() const
 {
 	return time;
 }
 
-void CMap2D::RespawnLives()
+/**
+ @brief Make the tile changes which are due. Only the events which are due are visited
+ */
+void CMap2D::ProcessTileEvents(void)
 {
-	static const double LIVE_RESPAWN_TIME = 5.0;
-
-	for (auto iter = liveMap.begin(); iter != liveMap.end(); ++iter)
+	TileEvent event;
+	while (cTileEvents.PopDueEvent(time, event))
 	{
-		if (iter->second != -10.0)
-		{
-			if (time > (iter->second + LIVE_RESPAWN_TIME))
-			{
-				iter->second = -10.0;
-						   // y				 , x
-				SetMapInfo(iter->first.second, iter->first.first, 5);
-			}
-		}
+		SetMapInfo(event.uiRow, event.uiCol, event.iValue, false);
 	}
 }
\ No newline at end of file
@@ -22,11 +22,14 @@
 
 // Include the RapidCSV
 #include "System/rapidcsv.h"
+// Include the binary map format
+#include "System/MapFile.h"
 // Include map storage
 #include <map>
 
 #include <queue>
-#include <functional>
+#include <set>
+#include <iostream>
 
 // Include Settings
 #include "GameControl\Settings.h"
@@ -34,40 +37,91 @@
 // Include Entity2D
 #include "Primitives/Entity2D.h"
 
+// Include QuadBatch
+#include "Primitives/QuadBatch.h"
+
+// Include TextureAtlas
+#include "System/TextureAtlas.h"
+
+// Include Camera2D
+#include "Camera2D.h"
+
+// Include TileRules
+#include "TileRules.h"
+
+// Include TileEventScheduler
+#include "TileEventScheduler.h"
+
+// Include the path finding
+#include "Pathfinding/NavGrid.h"
+#include "Pathfinding/AStar.h"
+#include "Pathfinding/PathCache.h"
+#include "Pathfinding/DistanceField.h"
+#include "Pathfinding/HPAStar.h"
+#include "Pathfinding/DStarLite.h"
+#include "Pathfinding/PathJobQueue.h"
+#include "Pathfinding/NavGridSnapshot.h"
+#include "Pathfinding/Reachability.h"
+
 // A structure storing information about Map Sizes
 struct MapSize {
 	unsigned int uiRowSize;
 	unsigned int uiColSize;
 };
 
-// A structure storing information about a map grid
-// It includes data to be used for A* Path Finding
-struct Grid {
-	unsigned int value;
-
-	Grid() 
-		: value(0), pos(0, 0), parent(-1, -1), f(0), g(0), h(0) {}
-	Grid(	const glm::vec2& pos, unsigned int f) 
-		: value(0), pos(pos), parent(-1, 1), f(f), g(0), h(0) {}
-	Grid(	const glm::vec2& pos, const glm::vec2& parent, 
-			unsigned int f, unsigned int g, unsigned int h) 
-		: value(0), pos(pos), parent(parent), f(f), g(g), h(h) {}
-
-	glm::vec2 pos;
-	glm::vec2 parent;
-	unsigned int f;
-	unsigned int g;
-	unsigned int h;
+// The number of tiles along each side of a chunk of the tile map
+const unsigned int TILE_CHUNK_SIZE = 32;
+
+// The number of tile changes kept by CMap2D for GetTileChangesSince()
+const unsigned int MAX_TILE_CHANGES = 4096;
+
+// The distance in tiles between the start and the target from which PathFind() uses hierarchical path finding
+const unsigned int HPA_MIN_DISTANCE = 64;
+
+// A square block of tiles whose quads are cached in a vertex buffer.
+// Only the chunks in the view are rendered, so the cost of rendering does not grow with the map size.
+// The batch holds the background quads of all the tiles followed by their foreground quads, 
+// so that the background layer is drawn first and a changed tile can be re-uploaded on its own
+struct TileChunk {
+	TileChunk()
+		: batch(NULL), bDirty(true) {}
+
+	// The quads of the tiles in this chunk, or NULL if the chunk has not been built
+	CQuadBatch* batch;
+	// Indicate if batch has to be rebuilt before rendering
+	bool bDirty;
+	// The tiles, indexed within this chunk, whose quads have to be re-uploaded before rendering
+	std::vector<unsigned int> vecDirtyTiles;
+};
+
+// A change of a tile value in the current level.
+// The row is counted from the top of the map, the same as the rows in arrMapInfo
+struct TileChange {
+	unsigned int uiRow;
+	unsigned int uiCol;
+	TileValue oldValue;
+	TileValue newValue;
 };
 
-using HeuristicFunction = std::function<unsigned int(const glm::vec2&, const glm::vec2&, int)>;
-// Reverse std::priority_queue to get the largest f value on top
-inline bool operator< (const Grid& a, const Grid& b) { return b.f < a.f; }
+// The distances to the tiles of an indexed value, for finding the nearest of them by path
+struct ValueField {
+	CDistanceField cField;
+	// Set when the field has to be built from mapOfValueIndices, e.g. before it is first used
+	bool bRebuild;
+	// The cells of the tiles of the value which were added (true) or removed (false) since the field was updated, in order
+	std::vector<std::pair<unsigned int, bool>> vecChangedCells;
+};
+
+// A heuristic for CMap2D::PathFind(). The heuristics in the heuristic namespace are recognised by PathFind(),
+// which then runs a search compiled for the matching type in Pathfinding/Heuristics.h
+typedef unsigned int (*HeuristicFunction)(const glm::vec2&, const glm::vec2&, int);
 
 namespace heuristic
 {
 	unsigned int manhattan(const glm::vec2& v1, const glm::vec2& v2, int weight);
 	unsigned int euclidean(const glm::vec2& v1, const glm::vec2& v2, int weight);
+	unsigned int octile(const glm::vec2& v1, const glm::vec2& v2, int weight);
+	unsigned int zero(const glm::vec2& v1, const glm::vec2& v2, int weight);
 }
 
 class CMap2D : public CSingletonTemplate<CMap2D>, public CEntity2D
@@ -105,15 +159,49 @@ public:
 	// Get the value at certain indices in the arrMapInfo
 	int GetMapInfo(const unsigned int uiRow, const unsigned int uiCol, const bool bInvert = true) const;
 
+	// Get the background value at certain indices in the arrBackgroundInfo
+	int GetBackgroundInfo(const unsigned int uiRow, const unsigned int uiCol, const bool bInvert = true) const;
+
 	// Load a map
 	bool LoadMap(string filename, const unsigned int uiLevel = 0);
 
 	// Save a tilemap
 	bool SaveMap(string filename, const unsigned int uiLevel = 0);
 
+	// Get the revision of the current level, which increases whenever a tile is changed
+	unsigned int GetMapRevision(void) const;
+
+	// Get the revision of the navigation grid, which increases whenever a tile changes how it can be walked through
+	unsigned int GetNavRevision(void) const;
+
+	// Get the tile changes made after a revision of the current level
+	bool GetTileChangesSince(const unsigned int uiRevision, std::vector<TileChange>& vecChanges) const;
+
 	// Find the indices of a certain value in arrMapInfo
 	bool FindValue(const int iValue, unsigned int& uirRow, unsigned int& uirCol, const bool bInvert = true);
 
+	// Get the number of tiles with a certain value in the current level. Only indexed values are counted
+	unsigned int GetValueCount(const int iValue) const;
+
+	// Find the nearest tile with a certain value to a position. Only indexed values can be found
+	bool FindNearestValue(const int iValue, const glm::vec2& vec2Position, glm::vec2& vec2Nearest, const bool bInvert = true) const;
+
+	// Find the nearest tile with a certain value to a tile, by the cost of the path to it. Only indexed values can be found
+	bool FindNearestValueByPath(const int iValue, const glm::vec2& currentPos, glm::vec2& nearestPos);
+
+	// Get the next tile to move to from a tile, towards the nearest tile with a certain value by path. Only indexed values can be found
+	bool GetNextStepToValue(const int iValue, const glm::vec2& currentPos, glm::vec2& nextPos);
+
+	// Bring the distance field of an indexed value up to date, so that it can be read on other threads until the tiles change
+	bool PrepareValueField(const int iValue);
+	// Find the nearest tile with a certain value by path, and the next tile towards it, from the field left by PrepareValueField().
+	// These do not change the map, so they can be called on several threads at once
+	bool FindNearestValueInField(const int iValue, const glm::vec2& currentPos, glm::vec2& nearestPos) const;
+	bool GetNextStepInValueField(const int iValue, const glm::vec2& currentPos, glm::vec2& nextPos) const;
+
+	// Schedule a tile to be set to a value after a delay
+	void ScheduleTileEvent(const double dDelay, const unsigned int uiRow, const unsigned int uiCol, const int iValue, const bool bInvert = true);
+
 	// Set current level
 	void SetCurrentLevel(unsigned int uiCurLevel);
 	// Get current level
@@ -126,14 +214,46 @@ public:
 										const glm::vec2& targetPos,
 										HeuristicFunction heuristicFunc,
 										const int weight = 1);
+	// Find a path, storing it in a vector which can be reused between searches.
+	// For a distant target, only the first part of the path may be returned, so find the path again when it has been used up
+	bool PathFind(	const glm::vec2& startPos,
+					const glm::vec2& targetPos,
+					HeuristicFunction heuristicFunc,
+					const int weight,
+					std::vector<glm::vec2>& path);
+	// Find a path with a heuristic from Pathfinding/Heuristics.h, which is chosen at compile time
+	template <typename Distance>
+	bool PathFind(	const glm::vec2& startPos,
+					const glm::vec2& targetPos,
+					const int weight,
+					std::vector<glm::vec2>& path);
+	// Get the next tile to move to from a tile towards a target, using a distance field shared by all the callers with the same target
+	bool GetNextStepTo(const glm::vec2& targetPos, const glm::vec2& currentPos, glm::vec2& nextPos);
+	// Build the distance field from a target for GetNextStepTo(), so that it can be read on other threads until the target or the tiles change
+	bool PrepareChaseField(const glm::vec2& targetPos);
+	// Get the next tile to move to from a tile towards a target, from the field left by PrepareChaseField().
+	// This does not change the map, so it can be called on several threads at once
+	bool GetNextStepInChaseField(const glm::vec2& targetPos, const glm::vec2& currentPos, glm::vec2& nextPos) const;
+	// Find a path with the caller's own incremental planner, which repairs its last path after the start, the target or the tiles change
+	bool PathFindIncremental(	CDStarLite& cPlanner,
+								const glm::vec2& startPos,
+								const glm::vec2& targetPos,
+								std::vector<glm::vec2>& path);
+	// Submit a request for a path, which is found on a worker thread and delivered on a later frame.
+	// With a planner, the planner repairs its last path. The planner must not be used while IsPlannerBusy() is true
+	unsigned int RequestPath(const glm::vec2& startPos, const glm::vec2& targetPos, const std::shared_ptr<CDStarLite>& pPlanner = std::shared_ptr<CDStarLite>());
+	// Take the path of a request once it has been delivered. The path is only changed if the request is not pending
+	CPathJobQueue::JOB_STATUS CollectPath(const unsigned int uiRequest, std::vector<glm::vec2>& path);
+	// Cancel a request whose path is no longer needed, without waiting for its search
+	void CancelPath(const unsigned int uiRequest);
+	// Check if a planner is still used by a request, including a cancelled request whose search has not finished
+	bool IsPlannerBusy(const CDStarLite* pPlanner) const;
 	// Set if AStar PathFinding will consider diagonal movement
 	void SetDiagonalMovement(const bool bEnable);
 
 	void SetEnemyCount(const unsigned value);
 	const unsigned& GetEnemyCount() const;
 
-	map<pair<float, float>, double>& GetLiveMap();
-
 	const double& GetTime() const;
 
 protected:
@@ -143,8 +263,13 @@ protected:
 	// We will load the CSV file's content into this Document
 	rapidcsv::Document doc;
 
-	// A 3-D array which stores the values of the tile map
-	Grid*** arrMapInfo;
+	// An array of levels, each storing the values of the tile map in one contiguous row-major block.
+	// A tile is at arrMapInfo[uiLevel][uiRow * NUM_TILES_XAXIS + uiCol]
+	TileValue** arrMapInfo;
+
+	// An array of levels, each storing the background tile to draw under each tile of arrMapInfo.
+	// It is built when a map is loaded, and has the same layout as arrMapInfo
+	TileValue** arrBackgroundInfo;
 
 	// The current level
 	unsigned int uiCurLevel;
@@ -154,14 +279,33 @@ protected:
 	// A 1-D array which stores the map sizes for each level
 	MapSize* arrMapSizes;
 
-	// Map containing texture IDs
-	map<int, int> MapOfTextureIDs;
-
-	//CS: The quadMesh for drawing the tiles
-	CMesh* quadMesh;
+	// The atlas containing the textures of all the tiles, identified by the tile values
+	CTextureAtlas* cTileAtlas;
+
+	// The chunks of the tile map, indexed by [uiChunkRow * uiNumChunksX + uiChunkCol].
+	// Chunk rows are counted from the top of the map, the same as the rows in arrMapInfo
+	std::vector<TileChunk> tileChunks;
+	unsigned int uiNumChunksX;
+	unsigned int uiNumChunksY;
+	// The indices of the chunks which have a vertex buffer
+	std::vector<unsigned int> vecBuiltChunks;
+
+	// Handler to the camera which determines the visible chunks
+	CCamera2D* cCamera2D;
+
+	// The latest tile changes in the current level, oldest first
+	std::vector<TileChange> vecTileChanges;
+	// The revision of the current level before the first change in vecTileChanges
+	unsigned int uiTileChangesBase;
+	// The revision of the current level
+	unsigned int uiMapRevision;
+
+	// The positions of the tiles in the current level whose values are indexed, see TileRules::IsIndexed().
+	// The positions are the indices in arrMapInfo, so they are sorted in the same order that FindValue() scans the map
+	std::map<TileValue, std::set<unsigned int>> mapOfValueIndices;
 	
-	// vector2, currTime (double)
-	map <pair<float, float>, double> liveMap;
+	// The tile changes waiting to be made, e.g. respawning the lives which have been picked up
+	CTileEventScheduler cTileEvents;
 
 	// Constructor
 	CMap2D(void);
@@ -169,40 +313,168 @@ protected:
 	// Destructor
 	virtual ~CMap2D(void);
 
-	// Render a tile
-	void RenderTile(const unsigned int uiRow, const unsigned int uiCol);
+	// Create the chunks for the size of the tile map
+	void InitTileChunks(void);
+	// Build the vertex buffer of a chunk from the tiles in the current level
+	void BuildTileChunk(const unsigned int uiChunk);
+	// Delete the vertex buffer of a chunk
+	void ReleaseTileChunk(const unsigned int uiChunk);
+	// Re-upload the quads of the changed tiles in a chunk
+	void UpdateTileChunk(const unsigned int uiChunk);
+	// Set the quads of a tile in the vertex buffer of its chunk
+	void SetTileQuads(TileChunk& chunk, const unsigned int uiRow, const unsigned int uiCol);
+	// Build the background layer of a level from its tiles
+	void BuildBackgroundLayer(const unsigned int uiLevel);
+
+	// Load a map from a CSV file
+	bool LoadCSVMap(const string& filename, const unsigned int uiLevel);
+	// Load a map from a binary map file
+	bool LoadBinaryMap(const string& filename, const unsigned int uiLevel, bool& bIndexed);
+	// Save a map to a binary map file
+	bool SaveBinaryMap(const string& filename, const unsigned int uiLevel);
+	// Mark all the chunks to be rebuilt, e.g. when the level is changed
+	void MarkTileChunksDirty(void);
+
+	// Record a change of a tile value and update the cached data which depends on it
+	void OnTileChanged(const unsigned int uiRow, const unsigned int uiCol, const TileValue oldValue, const TileValue newValue);
+	// Discard the recorded tile changes, when the whole level has been replaced
+	void ResetTileChanges(void);
+	// Rebuild mapOfValueIndices from the tiles in the current level
+	void RebuildValueIndices(void);
+	// Build mapOfValueIndices from the spawn table of a binary map file of the current level
+	bool LoadValueIndices(const CMapFile& cMapFile);
+
+	// Get the 1D index of a tile in a level of arrMapInfo
+	inline unsigned int GetTileIndex(const unsigned int uiRow, const unsigned int uiCol, const bool bInvert = true) const
+	{
+		if (bInvert)
+			return (cSettings->NUM_TILES_YAXIS - uiRow - 1) * cSettings->NUM_TILES_XAXIS + uiCol;
+		return uiRow * cSettings->NUM_TILES_XAXIS + uiCol;
+	}
+	// Check if the indices are within the tile map
+	inline bool IsWithinMap(const unsigned int uiRow, const unsigned int uiCol) const
+	{
+		return (uiRow < cSettings->NUM_TILES_YAXIS) && (uiCol < cSettings->NUM_TILES_XAXIS);
+	}
 
-	int m_weight;
-	//int m_size;
 	unsigned int m_nrOfDirections;
-	//glm::vec2 m_dimensions;
-	glm::vec2 m_startPos;
-	glm::vec2 m_targetPos;
-
-	std::priority_queue<Grid> m_openList;
-	std::vector<bool> m_closedList;
-	std::vector<Grid> m_cameFromList;
-	//std::vector<int> m_grid;
-	std::vector<glm::vec2> m_directions;
-	HeuristicFunction m_heuristic;
 
 	// For AStar PathFinding
-	// Build a path from m_cameFromList after calling PathFind()
-	std::vector<glm::vec2> BuildPath() const;
-	// Check if a grid is valid
-	bool isValid(const glm::vec2& pos) const;
+	// The cells which can be entered in the current level, with the rows counted from the bottom of the map
+	CNavGrid cNavGrid;
+	// The search data, which is reused by every search
+	CAStar cAStar;
+	// The cells of the last path found
+	std::vector<unsigned int> vecPathCells;
+	// The clusters of cNavGrid for hierarchical path finding, and the waypoints of the last hierarchical path
+	CHPAStar cHPAStar;
+	// The workers which find the paths of RequestPath(), and the copies of cNavGrid which they search.
+	// A copy is only updated when cNavGrid has changed since the last request, and then only with the changed cells
+	CPathJobQueue cPathJobQueue;
+	CNavGridSnapshot cNavGridSnapshot;
+	std::vector<unsigned int> vecPathWaypoints;
+	// Which cells of cNavGrid can reach which, so that a search for a target which cannot be reached fails at once
+	CReachability cReachability;
+	// The paths found in the current revision of cNavGrid, shared by all the callers of PathFind()
+	CPathCache cPathCache;
+	// The distances to the target of GetNextStepTo(), which is rebuilt when the target moves to another tile
+	CDistanceField cChaseField;
+	std::vector<unsigned int> vecChaseSources;
+	// The distances to the tiles of the indexed values which have been searched by path, in the current level
+	std::map<TileValue, ValueField> mapOfValueFields;
+
+	// Get the distance field of an indexed value, building it or adding the new tiles of the value to it first
+	CDistanceField* GetValueField(const int iValue);
+	// Get the distance field of an indexed value if it is up to date, without changing it
+	const CDistanceField* GetPreparedValueField(const int iValue) const;
+
+	// Find a path with a heuristic function object, for the number of directions in m_nrOfDirections
+	template <typename Heuristic>
+	bool PathFindWith(	const glm::vec2& startPos,
+						const glm::vec2& targetPos,
+						const Heuristic& heuristic,
+						std::vector<glm::vec2>& path);
+	// Check if a cell of cNavGrid may reach another, updating cReachability first if the tiles have changed
+	bool CanReach(const unsigned int uiStart, const unsigned int uiTarget);
+	// Convert the cells in vecPathCells into the tiles of a path
+	void GetPathFromCells(std::vector<glm::vec2>& path) const;
 	// Check if a grid is blocked
 	bool isBlocked(const unsigned int uiRow,
 		const unsigned int uiCol,
 		const bool bInvert = true) const;
-	// Convert a position to a 1D position in the array
-	int ConvertTo1D(const glm::vec2& pos) const;
+	// Build cNavGrid from the tiles in the current level
+	void BuildNavGrid(void);
+	// Update a cell of cNavGrid from the tiles in the current level
+	void UpdateNavCell(const unsigned int uiX, const unsigned int uiY);
 
-	// Delete AStar lists
-	bool DeleteAStarLists(void);
-	// Reset AStar lists
-	bool ResetAStarLists(void);
-
-	void RespawnLives();
+	// Make the tile changes which are due
+	void ProcessTileEvents(void);
 };
 
+/**
+ @brief Find a path with a heuristic from Pathfinding/Heuristics.h, which is chosen at compile time
+ @param startPos A const glm::vec2& variable containing the start tile, with the row counted from the bottom of the map
+ @param targetPos A const glm::vec2& variable containing the target tile, with the row counted from the bottom of the map
+ @param weight A const int variable containing the weight of the heuristic
+ @param path A std::vector<glm::vec2>& variable to store the tiles of the path, excluding the start tile
+ @return true if the target can be reached, otherwise false
+ */
+template <typename Distance>
+bool CMap2D::PathFind(	const glm::vec2& startPos,
+						const glm::vec2& targetPos,
+						const int weight,
+						std::vector<glm::vec2>& path)
+{
+	return PathFindWith(startPos, targetPos,
+						Heuristics::CGoalHeuristic<Distance>(cNavGrid, (int)targetPos.x, (int)targetPos.y, weight),
+						path);
+}
+
+/**
+ @brief Find a path with a heuristic function object, for the number of directions in m_nrOfDirections
+ */
+template <typename Heuristic>
+bool CMap2D::PathFindWith(	const glm::vec2& startPos,
+							const glm::vec2& targetPos,
+							const Heuristic& heuristic,
+							std::vector<glm::vec2>& path)
+{
+	path.clear();
+
+	// Check if the startPos and targetPost are blocked
+	if (isBlocked(startPos.y, startPos.x) ||
+		(isBlocked(targetPos.y, targetPos.x)))
+	{
+		std::cout << "Invalid start or target position." << std::endl;
+		return false;
+	}
+
+	const unsigned int uiStart = cNavGrid.GetCell(startPos.x, startPos.y);
+	const unsigned int uiTarget = cNavGrid.GetCell(targetPos.x, targetPos.y);
+	if (!CanReach(uiStart, uiTarget))
+		return false;
+
+	// A distant target in another cluster is found with hierarchical path finding instead, which does not use the heuristic.
+	// Only the first part of the path is refined into tiles, and the caller finds the path again when it has been used up
+	if ((m_nrOfDirections == 4) &&
+		(fabs(targetPos.x - startPos.x) + fabs(targetPos.y - startPos.y) >= HPA_MIN_DISTANCE) &&
+		(!cHPAStar.IsSameCluster(uiStart, uiTarget)))
+	{
+		if (!cHPAStar.FindAbstractPath(cNavGrid, uiStart, uiTarget, vecPathWaypoints))
+			return false;
+		cHPAStar.RefinePath(cNavGrid, uiStart, vecPathWaypoints, cHPAStar.GetClusterSize(), vecPathCells);
+		GetPathFromCells(path);
+		return true;
+	}
+
+	bool bFound = false;
+	if (m_nrOfDirections == 8)
+		bFound = cAStar.Search<8>(cNavGrid, uiStart, uiTarget, heuristic, vecPathCells);
+	else
+		bFound = cAStar.Search<4>(cNavGrid, uiStart, uiTarget, heuristic, vecPathCells);
+	if (!bFound)
+		return false;
+
+	GetPathFromCells(path);
+	return true;
+}
@@ -21,6 +21,9 @@ using namespace std;
 
 #include "GameManager.h"
 
+// Include Camera2D to render the player in the view
+#include "Camera2D.h"
+
 /**
  @brief Constructor This constructor has protected access modifier as this class will be a Singleton
  */
@@ -386,7 +389,7 @@ void CPlayer2D::Render(void)
 	unsigned int colorLoc = glGetUniformLocation(CShaderManager::GetInstance().activeShader->ID, "runtimeColour");
 	glUniformMatrix4fv(transformLoc, 1, GL_FALSE, glm::value_ptr(transform));
 
-	transform = glm::mat4(1.0f); // make sure to initialize matrix to identity matrix first
+	transform = CCamera2D::GetInstance().GetViewMatrix(); // start from the view of the camera, as the map may be larger than the view
 	transform = glm::translate(transform, glm::vec3(vec2UVCoordinate.x,
 													vec2UVCoordinate.y,
 													0.0f));
@@ -463,15 +466,8 @@ void CPlayer2D::Constraint(DIRECTION eDirection)
 
 void CPlayer2D::SetTileValue() const
 {
-	for (unsigned col = 0; col < cSettings->NUM_TILES_XAXIS; col++)
-	{
-		int tileValue = cMap2D->GetMapInfo(vec2Index.y, col);
-		if (tileValue <= 3)
-		{
-			cMap2D->SetMapInfo(vec2Index.y, vec2Index.x, tileValue);
-			return;
-		}
-	}
+	// Restore the background of the tile
+	cMap2D->SetMapInfo(vec2Index.y, vec2Index.x, cMap2D->GetBackgroundInfo(vec2Index.y, vec2Index.x));
 }
 
 void CPlayer2D::InteractWithMap(void)
@@ -481,7 +477,6 @@ void CPlayer2D::InteractWithMap(void)
 	switch (cMap2D->GetMapInfo(vec2Index.y, vec2Index.x))
 	{
 	case 5:
-		cMap2D->GetLiveMap()[make_pair(vec2Index.x, vec2Index.y)] = cMap2D->GetTime();
 		cInventoryItem = cInventoryManager->GetItem("Player Live");
 		break;
 
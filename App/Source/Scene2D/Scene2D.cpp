@@ -19,6 +19,8 @@ using namespace std;
 CScene2D::CScene2D(void)
 	: cMap2D(NULL)
 	, cPlayer2D(NULL)
+	, cCamera2D(NULL)
+	, cEnemySystem2D(NULL)
 	, cKeyboardController(NULL)
 	, cGUI_Scene2D(NULL)
 	, cGameManager(NULL)
@@ -43,13 +45,8 @@ CScene2D::~CScene2D(void)
 		cKeyboardController = NULL;
 	}
 
-	// Destroy the enemies
-	for (auto iter = enemyVector.begin(); iter != enemyVector.end(); ++iter)
-	{
-		delete (*iter);
-		(*iter) = NULL;
-	}
-	enemyVector.clear();
+	// We won't delete this since it was created elsewhere
+	cEnemySystem2D = NULL;
 }
 
 /**
@@ -74,6 +71,10 @@ bool CScene2D::Init(void)
 	cGameManager = &CGameManager::GetInstance();
 	cGameManager->Init();
 
+	// Create and initialise the camera which scrolls the view across the map
+	cCamera2D = &CCamera2D::GetInstance();
+	cCamera2D->Init();
+
 	// Create and initialise the Map 2D
 	cMap2D = &CMap2D::GetInstance();
 	// Set a shader to this class
@@ -106,33 +107,18 @@ bool CScene2D::Init(void)
 		return false;
 	}
 
-	// Create and initialise the CEnemy2D
-	enemyVector.clear();
-	while (true)
+	// Create and initialise the enemies at the enemy spawn points
+	cEnemySystem2D = &CEnemySystem2D::GetInstance();
+	// Pass shader to cEnemySystem2D
+	cEnemySystem2D->SetShader("Shader2D_Colour");
+	// Initialise the instance
+	if (cEnemySystem2D->Init() == false)
 	{
-		CEnemy2D* cEnemy2D = new CEnemy2D();
-		// Pass shader to cEnemy2D
-		cEnemy2D->SetShader("Shader2D_Colour");
-		// Initialise the instance
-		if (cEnemy2D->Init() == true)
-		{
-			cEnemy2D->SetEnemyNum((int)enemyVector.size());
-			enemyVector.push_back(cEnemy2D);
-		}
-		else
-		{
-			// Break out of this loop if the enemy has all been loaded
-			break;
-		}
+		cout << "Failed to load CEnemySystem2D" << endl;
+		return false;
 	}
 
-	for (auto iter = enemyVector.begin(); iter != enemyVector.end(); ++iter)
-		(*iter)->SetEnemyVector(enemyVector);
-
-	//enemyVector[0]->SetFSM("KnockOut");
-
 	cGUI_Scene2D = &CGUI_Scene2D::GetInstance();
-	cGUI_Scene2D->SetEnemyVector(enemyVector);
 	if (cGUI_Scene2D->Init() == false)
 	{
 		cout << "Failed to load CGUI_Scene2D" << endl;
@@ -158,24 +144,12 @@ bool CScene2D::Update(const double dElapsedTime)
 		// as we want to capture the inputs before map2D update
 		cPlayer2D->Update(dElapsedTime, time);
 
-		// Call all the cEnemy2D's update method before Map2D
+		// Scroll the view to follow the player
+		cCamera2D->Update(cPlayer2D->vec2UVCoordinate);
+
+		// Call the cEnemySystem2D's update method before Map2D
 		// as we want to capture the updates before map2D update
-		for (auto iter = enemyVector.begin(); iter != enemyVector.end(); ++iter)
-		{
-			(*iter)->Update(dElapsedTime);
-			if (((*iter)->isKnockedOut) && (!(*iter)->gotSupport))
-			{
-				for (auto iter2 = enemyVector.begin(); iter2 != enemyVector.end(); ++iter2)
-				{
-					if (!(*iter2)->isKnockedOut)
-					{
-						(*iter)->gotSupport = true;
-						(*iter2)->SetFSM("Support", (*iter)->vec2Index);
-						break;
-					}
-				}
-			}
-		}
+		cEnemySystem2D->Update(dElapsedTime);
 	}
 
 	// Call the cGUI_Scene2D's update method
@@ -282,15 +256,12 @@ void CScene2D::Render(void)
 	// Call the Map2D's PostRender()
 	cMap2D->PostRender(); // [To unset some OpenGL settings called in CMap2D::PreRender() method]
 
-	for (auto iter = enemyVector.begin(); iter != enemyVector.end(); ++iter)
-	{
-		// Call the CEnemy2D's PreRender()
-		(*iter)->PreRender();
-		// Call the CEnemy2D's Render()
-		(*iter)->Render();
-		// Call the CEnemy2D's PostRender()
-		(*iter)->PostRender();
-	}
+	// Call the CEnemySystem2D's PreRender()
+	cEnemySystem2D->PreRender();
+	// Call the CEnemySystem2D's Render()
+	cEnemySystem2D->Render();
+	// Call the CEnemySystem2D's PostRender()
+	cEnemySystem2D->PostRender();
 
 	// Call the CPlayer2D's PreRender()
 	cPlayer2D->PreRender();
@@ -32,11 +32,14 @@
 // Include the Map2D as we will use it to check the player's  movements and actions
 #include "Map2D.h"
 
+// Include Camera2D
+#include "Camera2D.h"
+
 //Include CPlayer2D
 #include "Player2D.h"
 
-// Include CEnemy2D
-#include "Enemy2D.h"
+// Include CEnemySystem2D
+#include "EnemySystem2D.h"
 
 // Include GUI_Scene2D
 #include "GUI_Scene2D.h"
@@ -78,8 +81,11 @@ protected:
 	// The handler containing the instance of CPlayer2D
 	CPlayer2D* cPlayer2D;
 
-	// A vector containing the instance of CEnemy2Ds
-	std::vector<CEnemy2D*> enemyVector;
+	// The handler containing the instance of CCamera2D
+	CCamera2D* cCamera2D;
+
+	// The handler containing the instance of CEnemySystem2D, which updates and renders all the enemies
+	CEnemySystem2D* cEnemySystem2D;
 
 	// The handler containing the instance of GUI_Scene2D
 	CGUI_Scene2D* cGUI_Scene2D;
@@ -0,0 +1,75 @@
+/**
+ CTileEventScheduler
+ @brief A class which stores tile changes to be made at a later time, e.g. respawning an item.
+		The events are kept in a min-heap ordered by their due time, so each update only touches 
+		the events which are due, no matter how many events are waiting
+ By: JH Chong
+ Date: Aug 2022
+ */
+#include "TileEventScheduler.h"
+
+/**
+ @brief Constructor
+ */
+CTileEventScheduler::CTileEventScheduler(void)
+	: uiNextOrder(0)
+{
+}
+
+/**
+ @brief Destructor
+ */
+CTileEventScheduler::~CTileEventScheduler(void)
+{
+}
+
+/**
+ @brief Schedule a tile to be set to a value at a certain time
+ @param dDueTime A const double variable containing the time to set the tile
+ @param uiRow A const unsigned int variable containing the row of the tile, counted from the top of the map
+ @param uiCol A const unsigned int variable containing the column of the tile
+ @param iValue A const int variable containing the value to set the tile to
+ */
+void CTileEventScheduler::Schedule(const double dDueTime, const unsigned int uiRow, const unsigned int uiCol, const int iValue)
+{
+	TileEvent event;
+	event.dDueTime = dDueTime;
+	event.uiRow = uiRow;
+	event.uiCol = uiCol;
+	event.iValue = iValue;
+	event.uiOrder = uiNextOrder++;
+	queueOfEvents.push(event);
+}
+
+/**
+ @brief Remove the earliest event which is due at dTime
+ @param dTime A const double variable containing the current time
+ @param event A TileEvent& variable to store the removed event
+ @return true if an event was due, otherwise false
+ */
+bool CTileEventScheduler::PopDueEvent(const double dTime, TileEvent& event)
+{
+	if ((queueOfEvents.empty()) || (queueOfEvents.top().dDueTime > dTime))
+		return false;
+
+	event = queueOfEvents.top();
+	queueOfEvents.pop();
+	return true;
+}
+
+/**
+ @brief Remove all the events
+ */
+void CTileEventScheduler::Clear(void)
+{
+	queueOfEvents = std::priority_queue<TileEvent, std::vector<TileEvent>, LaterEvent>();
+	uiNextOrder = 0;
+}
+
+/**
+ @brief Get the number of events waiting to be processed
+ */
+unsigned int CTileEventScheduler::GetNumEvents(void) const
+{
+	return (unsigned int)queueOfEvents.size();
+}
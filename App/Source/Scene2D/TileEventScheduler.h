@@ -0,0 +1,62 @@
+/**
+ CTileEventScheduler
+ @brief A class which stores tile changes to be made at a later time, e.g. respawning an item.
+		The events are kept in a min-heap ordered by their due time, so each update only touches 
+		the events which are due, no matter how many events are waiting
+ By: JH Chong
+ Date: Aug 2022
+ */
+#pragma once
+
+#include <queue>
+#include <vector>
+
+// A tile change to be made at a certain time.
+// The row is counted from the top of the map, the same as the rows in CMap2D::arrMapInfo
+struct TileEvent {
+	double dDueTime;
+	unsigned int uiRow;
+	unsigned int uiCol;
+	int iValue;
+	// The order in which the event was scheduled, so that events due at the same time are processed in that order
+	unsigned int uiOrder;
+};
+
+class CTileEventScheduler
+{
+public:
+	// Constructor
+	CTileEventScheduler(void);
+
+	// Destructor
+	~CTileEventScheduler(void);
+
+	// Schedule a tile to be set to a value at a certain time
+	void Schedule(const double dDueTime, const unsigned int uiRow, const unsigned int uiCol, const int iValue);
+
+	// Remove the earliest event which is due at dTime
+	bool PopDueEvent(const double dTime, TileEvent& event);
+
+	// Remove all the events
+	void Clear(void);
+
+	// Get the number of events waiting to be processed
+	unsigned int GetNumEvents(void) const;
+
+protected:
+	// Orders the heap so that the earliest event is on top
+	struct LaterEvent {
+		bool operator()(const TileEvent& a, const TileEvent& b) const
+		{
+			if (a.dDueTime != b.dDueTime)
+				return a.dDueTime > b.dDueTime;
+			return a.uiOrder > b.uiOrder;
+		}
+	};
+
+	// The events waiting to be processed
+	std::priority_queue<TileEvent, std::vector<TileEvent>, LaterEvent> queueOfEvents;
+
+	// The order of the next event to be scheduled
+	unsigned int uiNextOrder;
+};
@@ -0,0 +1,130 @@
+/**
+ TileRules
+ @brief The meaning of the tile values in the tile map. 
+		This file does not depend on OpenGL, so that tools which process the maps can share these rules with the game
+ By: JH Chong
+ Date: Aug 2022
+ */
+#pragma once
+
+// Include NavGrid, for the types of the nav cells of the tiles
+#include "Pathfinding/NavGrid.h"
+
+// The type used to store the value of a tile in the tile map.
+// Tile values go up to 300, so 16 bits is enough and keeps a whole level compact
+typedef unsigned short TileValue;
+
+namespace TileRules
+{
+	// The tile values which are used as spawn points
+	const TileValue PLAYER_SPAWN = 200;
+	const TileValue ENEMY_SPAWN = 300;
+
+	// The extra cost of entering a spike tile along a path, which is as much as walking 4 tiles
+	const unsigned int SPIKE_PENALTY = 4 * CNavGrid::COST_STRAIGHT;
+
+	// Check if a tile value is a background tile
+	inline bool IsBackground(const TileValue value)
+	{
+		return (value > 0) && (value <= 3);
+	}
+
+	// Check if a tile value is a spawn point
+	inline bool IsSpawn(const TileValue value)
+	{
+		return (value == PLAYER_SPAWN) || (value == ENEMY_SPAWN);
+	}
+
+	// The tile values whose positions are indexed by CMap2D, so that they can be found without scanning the map.
+	// These are the spawn points, and the items which the game searches for: lives, keys and the treasure chest
+	const TileValue INDEXED_VALUES[] = { 5, 10, 25, PLAYER_SPAWN, ENEMY_SPAWN };
+	const unsigned int NUM_INDEXED_VALUES = sizeof(INDEXED_VALUES) / sizeof(INDEXED_VALUES[0]);
+
+	// Check if the positions of a tile value are indexed by CMap2D, see INDEXED_VALUES
+	inline bool IsIndexed(const TileValue value)
+	{
+		return (value == 5) || (value == 10) || (value == 25) || IsSpawn(value);
+	}
+
+	// Check if a tile value blocks movement
+	inline bool IsBlocked(const TileValue value)
+	{
+		return (value >= 100) && (value < 200);
+	}
+
+	// Check if a tile can be stood in, given the tile below it.
+	// It is either on top of a ladder or a solid tile, or it holds onto an item, ladder, zipline or spike
+	inline bool IsStandable(const TileValue value, const TileValue valueBelow)
+	{
+		return (valueBelow == 30) || ((valueBelow >= 100) && (valueBelow <= 120)) ||
+			((value >= 5) && (value <= 60));
+	}
+
+	// Check if a tile value is a ladder, which can be climbed up and down
+	inline bool IsLadder(const TileValue value)
+	{
+		return (value >= 30) && (value <= 36);
+	}
+
+	// Check if a tile value is a spike, which hurts whoever enters it
+	inline bool IsSpike(const TileValue value)
+	{
+		return (value == 55) || (value == 60);
+	}
+
+	/**
+	 @brief Get the type of the nav cell of a tile, given the tile below it.
+			A tile is a ladder, a cell which can be stood in, or air which can only be fallen through
+	 @param value A const TileValue variable containing the tile
+	 @param valueBelow A const TileValue variable containing the tile below it, or 0 on the bottom row
+	 @return The type of the nav cell
+	 */
+	inline CNavGrid::CELL_TYPE GetNavCellType(const TileValue value, const TileValue valueBelow)
+	{
+		if (IsBlocked(value))
+			return CNavGrid::CELL_BLOCKED;
+		if (IsLadder(value))
+			return CNavGrid::CELL_LADDER;
+		if (IsStandable(value, valueBelow))
+			return CNavGrid::CELL_STANDABLE;
+		return CNavGrid::CELL_AIR;
+	}
+
+	// Get the extra cost of entering the nav cell of a tile. Spikes can be crossed, but paths avoid them when there is a cheaper way around
+	inline unsigned int GetNavPenalty(const TileValue value)
+	{
+		return IsSpike(value) ? SPIKE_PENALTY : 0;
+	}
+
+	/**
+	 @brief Build the background layer of a row of tiles.
+			A background tile is its own background. Other tiles use the first background tile in their row,
+			except for the invisibility potion which is always drawn over the sky
+	 @param pRow A const TileValue* variable containing the tiles in the row
+	 @param pBackgroundRow A TileValue* variable to store the background of each tile in the row
+	 @param uiNumCols A const unsigned int variable containing the number of tiles in the row
+	 */
+	inline void BuildBackgroundRow(const TileValue* pRow, TileValue* pBackgroundRow, const unsigned int uiNumCols)
+	{
+		// Search the same row to find similar background, break if found
+		TileValue rowBackground = 0;
+		for (unsigned int uiCol = 0; uiCol < uiNumCols; uiCol++)
+		{
+			if (IsBackground(pRow[uiCol]))
+			{
+				rowBackground = pRow[uiCol];
+				break;
+			}
+		}
+
+		for (unsigned int uiCol = 0; uiCol < uiNumCols; uiCol++)
+		{
+			if (pRow[uiCol] <= 3)
+				pBackgroundRow[uiCol] = pRow[uiCol];
+			else if (pRow[uiCol] == 20)
+				pBackgroundRow[uiCol] = 1;
+			else
+				pBackgroundRow[uiCol] = rowBackground;
+		}
+	}
+}
@@ -0,0 +1,326 @@
+/**
+ CAIScheduler
+ @brief A scheduler which limits the time spent on updating many agents, such as all the enemies of a scene.
+		Each agent is put in a tier by its distance from the player. The agents in the near tier are updated
+		every frame and the agents in the further tiers every few frames, staggered so that they are not
+		all updated in the same frame. Replans, such as path requests, are queued and started in order
+		while fewer than a number of them are running in the background, and until the time spent starting them
+		in the frame reaches a budget, and the rest wait for a later frame.
+		The time of each frame is kept so that it can be shown in the HUD.
+ By: JH Chong
+ Date: Aug 2022
+ */
+#include "AIScheduler.h"
+
+#include <algorithm>
+
+/**
+ @brief Constructor. The agents within 8 tiles are updated every frame, within 16 tiles every 2 frames,
+		and further every 4 frames, with 500 microseconds of starting replans in each frame and at most 8 replans in flight
+ */
+CAIScheduler::CAIScheduler(void)
+	: uiReplanBudget(500)
+	, uiMaxReplansInFlight(8)
+	, uiFrame(0)
+	, dFrameTime(0.0)
+	, dAverageFrameTime(0.0)
+	, uiNextQueueNumber(0)
+	, uiNumQueued(0)
+	, dReplanTime(0.0)
+	, uiNumReplans(0)
+	, uiNumInFlight(0)
+{
+	arrTierDistances[TIER_NEAR] = 8.0f;
+	arrTierDistances[TIER_MID] = 16.0f;
+	arrTierDistances[TIER_FAR] = 0.0f;
+	arrTierIntervals[TIER_NEAR] = 1;
+	arrTierIntervals[TIER_MID] = 2;
+	arrTierIntervals[TIER_FAR] = 4;
+}
+
+/**
+ @brief Destructor
+ */
+CAIScheduler::~CAIScheduler(void)
+{
+}
+
+/**
+ @brief Set the number of agents, which are all put in TIER_NEAR, and remove the queued replans and the replans in flight
+ @param uiNumAgents A const unsigned int variable containing the number of agents, which are numbered from 0
+ */
+void CAIScheduler::Init(const unsigned int uiNumAgents)
+{
+	arrTiers.assign(uiNumAgents, static_cast<unsigned char>(TIER_NEAR));
+	arrQueued.assign(uiNumAgents, false);
+	arrQueueNumbers.assign(uiNumAgents, 0);
+	uiNextQueueNumber = 0;
+	dequeReplans.clear();
+	uiNumQueued = 0;
+	dReplanTime = 0.0;
+	uiNumReplans = 0;
+	arrInFlight.assign(uiNumAgents, false);
+	uiNumInFlight = 0;
+}
+
+/**
+ @brief Set the furthest distance of the agents in a tier. TIER_FAR has all the agents which are further than TIER_MID
+ @param eTier A const TIER variable containing the tier
+ @param fDistance A const float variable containing the furthest distance
+ */
+void CAIScheduler::SetTierDistance(const TIER eTier, const float fDistance)
+{
+	if (eTier < NUM_TIERS)
+		arrTierDistances[eTier] = fDistance;
+}
+
+/**
+ @brief Set the number of frames between the updates of the agents in a tier
+ @param eTier A const TIER variable containing the tier
+ @param uiInterval A const unsigned int variable containing the number of frames, which is at least 1
+ */
+void CAIScheduler::SetTierInterval(const TIER eTier, const unsigned int uiInterval)
+{
+	if (eTier < NUM_TIERS)
+		arrTierIntervals[eTier] = (uiInterval > 0) ? uiInterval : 1;
+}
+
+/**
+ @brief Set the time which may be spent on starting replans in each frame
+ @param uiMicroseconds A const unsigned int variable containing the time in microseconds
+ */
+void CAIScheduler::SetReplanBudget(const unsigned int uiMicroseconds)
+{
+	uiReplanBudget = uiMicroseconds;
+}
+
+/**
+ @brief Set the number of replans which may be running in the background at once
+ @param uiMaxReplans A const unsigned int variable containing the number of replans, which is at least 1
+ */
+void CAIScheduler::SetMaxReplansInFlight(const unsigned int uiMaxReplans)
+{
+	uiMaxReplansInFlight = (uiMaxReplans > 0) ? uiMaxReplans : 1;
+}
+
+/**
+ @brief Start the time of a frame, and the time and number of replans in it
+ */
+void CAIScheduler::BeginFrame(void)
+{
+	uiFrame++;
+	frameStartTime = std::chrono::steady_clock::now();
+	dReplanTime = 0.0;
+	uiNumReplans = 0;
+}
+
+/**
+ @brief End the time of a frame, and add it to the average over the recent frames
+ */
+void CAIScheduler::EndFrame(void)
+{
+	dFrameTime = GetMicrosecondsSince(frameStartTime);
+	dAverageFrameTime = (uiFrame <= 1) ? dFrameTime : dAverageFrameTime * 0.9 + dFrameTime * 0.1;
+}
+
+/**
+ @brief Put an agent in the tier of its distance.
+		Only the tier of the agent is changed, so different agents can be put in their tiers on several threads at once
+ @param uiAgent A const unsigned int variable containing the agent
+ @param fDistance A const float variable containing the distance of the agent, such as from the player
+ */
+void CAIScheduler::SetDistance(const unsigned int uiAgent, const float fDistance)
+{
+	if (fDistance <= arrTierDistances[TIER_NEAR])
+		arrTiers[uiAgent] = TIER_NEAR;
+	else if (fDistance <= arrTierDistances[TIER_MID])
+		arrTiers[uiAgent] = TIER_MID;
+	else
+		arrTiers[uiAgent] = TIER_FAR;
+}
+
+/**
+ @brief Get the tier of an agent
+ @param uiAgent A const unsigned int variable containing the agent
+ */
+CAIScheduler::TIER CAIScheduler::GetTier(const unsigned int uiAgent) const
+{
+	return (TIER)arrTiers[uiAgent];
+}
+
+/**
+ @brief Get the number of frames between the updates of an agent, which is the number of frames which an update makes up for
+ @param uiAgent A const unsigned int variable containing the agent
+ */
+unsigned int CAIScheduler::GetInterval(const unsigned int uiAgent) const
+{
+	return arrTierIntervals[arrTiers[uiAgent]];
+}
+
+/**
+ @brief Check if an agent is updated in this frame.
+		The agents of a tier are staggered by their numbers, so that an equal share of them is updated in each frame
+ @param uiAgent A const unsigned int variable containing the agent
+ */
+bool CAIScheduler::IsDue(const unsigned int uiAgent) const
+{
+	return ((uiFrame + uiAgent) % GetInterval(uiAgent)) == 0;
+}
+
+/**
+ @brief Queue a replan of an agent at the back of the queue, unless it is already queued.
+		The cancelled entries are removed when they are more than the agents, so that an agent which keeps
+		being cancelled and queued again does not grow the queue
+ @param uiAgent A const unsigned int variable containing the agent
+ */
+void CAIScheduler::QueueReplan(const unsigned int uiAgent)
+{
+	if (arrQueued[uiAgent])
+		return;
+
+	if (dequeReplans.size() >= 2 * arrQueued.size())
+	{
+		std::deque<std::pair<unsigned int, unsigned int>>::iterator itEnd = std::remove_if(dequeReplans.begin(), dequeReplans.end(),
+			[this](const std::pair<unsigned int, unsigned int>& entry)
+			{
+				return (!arrQueued[entry.first]) || (arrQueueNumbers[entry.first] != entry.second);
+			});
+		dequeReplans.erase(itEnd, dequeReplans.end());
+	}
+
+	arrQueued[uiAgent] = true;
+	arrQueueNumbers[uiAgent] = uiNextQueueNumber;
+	uiNumQueued++;
+	dequeReplans.push_back(std::make_pair(uiAgent, uiNextQueueNumber));
+	uiNextQueueNumber++;
+}
+
+/**
+ @brief Remove the queued replan of an agent. Its entry is left in the queue, and skipped when it is reached,
+		as its number is no longer the number of the latest queueing of the agent
+ @param uiAgent A const unsigned int variable containing the agent
+ */
+void CAIScheduler::CancelReplan(const unsigned int uiAgent)
+{
+	if (!arrQueued[uiAgent])
+		return;
+
+	arrQueued[uiAgent] = false;
+	uiNumQueued--;
+}
+
+/**
+ @brief Mark the replan of an agent which was running in the background as finished or cancelled, 
+		so that another replan can be started
+ @param uiAgent A const unsigned int variable containing the agent
+ */
+void CAIScheduler::FinishReplan(const unsigned int uiAgent)
+{
+	if (!arrInFlight[uiAgent])
+		return;
+
+	arrInFlight[uiAgent] = false;
+	uiNumInFlight--;
+}
+
+/**
+ @brief Get the number of agents in a tier
+ @param eTier A const TIER variable containing the tier
+ */
+unsigned int CAIScheduler::GetNumAgents(const TIER eTier) const
+{
+	unsigned int uiNumAgents = 0;
+	for (unsigned int i = 0; i < arrTiers.size(); i++)
+	{
+		if (arrTiers[i] == eTier)
+			uiNumAgents++;
+	}
+	return uiNumAgents;
+}
+
+/**
+ @brief Get the number of agents which are updated in this frame
+ */
+unsigned int CAIScheduler::GetNumDueAgents(void) const
+{
+	unsigned int uiNumAgents = 0;
+	for (unsigned int i = 0; i < arrTiers.size(); i++)
+	{
+		if (IsDue(i))
+			uiNumAgents++;
+	}
+	return uiNumAgents;
+}
+
+/**
+ @brief Get the time of the last frame in microseconds
+ */
+double CAIScheduler::GetFrameTime(void) const
+{
+	return dFrameTime;
+}
+
+/**
+ @brief Get the average time of the recent frames in microseconds
+ */
+double CAIScheduler::GetAverageFrameTime(void) const
+{
+	return dAverageFrameTime;
+}
+
+/**
+ @brief Get the time spent on starting replans in this frame in microseconds
+ */
+double CAIScheduler::GetReplanTime(void) const
+{
+	return dReplanTime;
+}
+
+/**
+ @brief Get the time in microseconds which may be spent on starting replans in each frame
+ */
+unsigned int CAIScheduler::GetReplanBudget(void) const
+{
+	return uiReplanBudget;
+}
+
+/**
+ @brief Get the number of replans started in this frame
+ */
+unsigned int CAIScheduler::GetNumReplans(void) const
+{
+	return uiNumReplans;
+}
+
+/**
+ @brief Get the number of replans which are waiting for a later frame
+ */
+unsigned int CAIScheduler::GetNumQueuedReplans(void) const
+{
+	return uiNumQueued;
+}
+
+/**
+ @brief Get the number of replans running in the background
+ */
+unsigned int CAIScheduler::GetNumReplansInFlight(void) const
+{
+	return uiNumInFlight;
+}
+
+/**
+ @brief Get the most replans which may be running in the background at once
+ */
+unsigned int CAIScheduler::GetMaxReplansInFlight(void) const
+{
+	return uiMaxReplansInFlight;
+}
+
+/**
+ @brief Get the time since a time point in microseconds
+ @param timePoint A const std::chrono::steady_clock::time_point& variable containing the time point
+ */
+double CAIScheduler::GetMicrosecondsSince(const std::chrono::steady_clock::time_point& timePoint)
+{
+	return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - timePoint).count();
+}
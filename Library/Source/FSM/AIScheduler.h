@@ -0,0 +1,156 @@
+/**
+ CAIScheduler
+ @brief A scheduler which limits the time spent on updating many agents, such as all the enemies of a scene.
+		Each agent is put in a tier by its distance from the player. The agents in the near tier are updated
+		every frame and the agents in the further tiers every few frames, staggered so that they are not
+		all updated in the same frame. Replans, such as path requests, are queued and started in order
+		while fewer than a number of them are running in the background, and until the time spent starting them
+		in the frame reaches a budget, and the rest wait for a later frame.
+		The time of each frame is kept so that it can be shown in the HUD.
+ By: JH Chong
+ Date: Aug 2022
+ */
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <chrono>
+#include <utility>
+
+class CAIScheduler
+{
+public:
+	// The tiers of the agents, from the nearest
+	enum TIER
+	{
+		TIER_NEAR = 0,
+		TIER_MID,
+		TIER_FAR,
+		NUM_TIERS
+	};
+
+	// Constructor
+	CAIScheduler(void);
+
+	// Destructor
+	virtual ~CAIScheduler(void);
+
+	// Set the number of agents, which are all put in TIER_NEAR, and remove the queued replans
+	void Init(const unsigned int uiNumAgents);
+
+	// Set the furthest distance of the agents in a tier. TIER_FAR has all the agents which are further
+	void SetTierDistance(const TIER eTier, const float fDistance);
+	// Set the number of frames between the updates of the agents in a tier
+	void SetTierInterval(const TIER eTier, const unsigned int uiInterval);
+	// Set the time in microseconds which may be spent on starting replans in each frame
+	void SetReplanBudget(const unsigned int uiMicroseconds);
+	// Set the number of replans which may be running in the background at once
+	void SetMaxReplansInFlight(const unsigned int uiMaxReplans);
+
+	// Start the time of a frame
+	void BeginFrame(void);
+	// End the time of a frame
+	void EndFrame(void);
+
+	// Put an agent in the tier of its distance
+	void SetDistance(const unsigned int uiAgent, const float fDistance);
+	// Get the tier of an agent
+	TIER GetTier(const unsigned int uiAgent) const;
+	// Get the number of frames between the updates of an agent
+	unsigned int GetInterval(const unsigned int uiAgent) const;
+	// Check if an agent is updated in this frame
+	bool IsDue(const unsigned int uiAgent) const;
+
+	// Queue a replan of an agent, unless it is already queued
+	void QueueReplan(const unsigned int uiAgent);
+	// Remove the queued replan of an agent
+	void CancelReplan(const unsigned int uiAgent);
+	// Start the queued replans in order until the budget of this frame is spent, or too many are running
+	template <typename Replan>
+	void RunReplans(const Replan& replan);
+	// Mark the replan of an agent which was running in the background as finished or cancelled
+	void FinishReplan(const unsigned int uiAgent);
+
+	// Get the number of agents in a tier
+	unsigned int GetNumAgents(const TIER eTier) const;
+	// Get the number of agents which are updated in this frame
+	unsigned int GetNumDueAgents(void) const;
+	// Get the time of the last frame, and its average over the recent frames, in microseconds
+	double GetFrameTime(void) const;
+	double GetAverageFrameTime(void) const;
+	// Get the time spent on starting replans in this frame in microseconds, and the budget
+	double GetReplanTime(void) const;
+	unsigned int GetReplanBudget(void) const;
+	// Get the number of replans started in this frame, and the number which are waiting
+	unsigned int GetNumReplans(void) const;
+	unsigned int GetNumQueuedReplans(void) const;
+	// Get the number of replans running in the background, and the most which may be running
+	unsigned int GetNumReplansInFlight(void) const;
+	unsigned int GetMaxReplansInFlight(void) const;
+
+protected:
+	// The furthest distance and the interval of each tier
+	float arrTierDistances[NUM_TIERS];
+	unsigned int arrTierIntervals[NUM_TIERS];
+	unsigned int uiReplanBudget;
+	unsigned int uiMaxReplansInFlight;
+
+	// The number of frames which have begun
+	unsigned int uiFrame;
+	std::chrono::steady_clock::time_point frameStartTime;
+	double dFrameTime;
+	double dAverageFrameTime;
+
+	// The tier of each agent
+	std::vector<unsigned char> arrTiers;
+
+	// The agents with queued replans in order, each with the number of the queueing, and whether each agent is queued
+	// with the number of its latest queueing. An entry whose number is not the latest of its agent was cancelled,
+	// so an agent which is queued again after a cancel waits behind the agents queued before it
+	std::deque<std::pair<unsigned int, unsigned int>> dequeReplans;
+	std::vector<unsigned char> arrQueued;
+	std::vector<unsigned int> arrQueueNumbers;
+	unsigned int uiNextQueueNumber;
+	unsigned int uiNumQueued;
+	double dReplanTime;
+	unsigned int uiNumReplans;
+	// Whether the replan of each agent is running in the background, and the number which are
+	std::vector<unsigned char> arrInFlight;
+	unsigned int uiNumInFlight;
+
+	// Get the time since a time point in microseconds
+	static double GetMicrosecondsSince(const std::chrono::steady_clock::time_point& timePoint);
+};
+
+/**
+ @brief Start the queued replans in order until the time spent on starting them in this frame reaches the budget,
+		or the number of replans running in the background reaches the most which may be running.
+		The budget only times this thread, so the cap on the replans in flight is what limits the work of the workers.
+		At least one replan is started in each frame if there is room, so the queue keeps moving even if a replan takes longer than the budget
+ @param replan A const Replan& variable containing a function object which is called with the agent to replan,
+		and returns true if the replan keeps running in the background until FinishReplan() is called for the agent
+ */
+template <typename Replan>
+void CAIScheduler::RunReplans(const Replan& replan)
+{
+	while ((!dequeReplans.empty()) && (uiNumInFlight < uiMaxReplansInFlight) &&
+		((uiNumReplans == 0) || (dReplanTime < uiReplanBudget)))
+	{
+		const unsigned int uiAgent = dequeReplans.front().first;
+		const unsigned int uiQueueNumber = dequeReplans.front().second;
+		dequeReplans.pop_front();
+		if ((!arrQueued[uiAgent]) || (arrQueueNumbers[uiAgent] != uiQueueNumber))
+			continue;
+		arrQueued[uiAgent] = false;
+		uiNumQueued--;
+
+		const std::chrono::steady_clock::time_point replanStartTime = std::chrono::steady_clock::now();
+		if ((replan(uiAgent)) && (!arrInFlight[uiAgent]))
+		{
+			arrInFlight[uiAgent] = true;
+			uiNumInFlight++;
+		}
+		dReplanTime += GetMicrosecondsSince(replanStartTime);
+		uiNumReplans++;
+	}
+}
@@ -0,0 +1,194 @@
+/**
+ CStateMachine
+ @brief A finite state machine which is shared by many instances, such as all the enemies of a scene.
+		The states, events and transitions are numbers which are declared once as a table, and each instance
+		only stores its current state. Events which are raised for an instance are turned into transitions
+		by ApplyTransitions(), so the instances in each state can be updated together as a batch
+		without the batches changing while they are being updated.
+ By: JH Chong
+ Date: Aug 2022
+ */
+#include "StateMachine.h"
+
+/**
+ @brief Constructor
+ */
+CStateMachine::CStateMachine(void)
+	: uiNumStates(0)
+	, uiNumEvents(0)
+{
+}
+
+/**
+ @brief Destructor
+ */
+CStateMachine::~CStateMachine(void)
+{
+}
+
+/**
+ @brief Declare the states, events and transitions, and remove all the instances.
+		A transition which is declared more than once uses its last declaration
+ @param uiNumStates A const unsigned int variable containing the number of states, which are numbered from 0
+ @param uiNumEvents A const unsigned int variable containing the number of events, which are numbered from 0
+ @param arrTransitions A const Transition* variable containing the transitions
+ @param uiNumTransitions A const unsigned int variable containing the number of transitions
+ */
+void CStateMachine::Init(	const unsigned int uiNumStates,
+							const unsigned int uiNumEvents,
+							const Transition* arrTransitions,
+							const unsigned int uiNumTransitions)
+{
+	this->uiNumStates = uiNumStates;
+	this->uiNumEvents = uiNumEvents;
+
+	arrTransitionTable.assign(uiNumStates * uiNumEvents, static_cast<unsigned int>(STATE_NONE));
+	for (unsigned int i = 0; i < uiNumTransitions; i++)
+	{
+		const Transition& transition = arrTransitions[i];
+		if ((transition.uiFrom < uiNumStates) && (transition.uiEvent < uiNumEvents) && (transition.uiTo < uiNumStates))
+			arrTransitionTable[transition.uiFrom * uiNumEvents + transition.uiEvent] = transition.uiTo;
+	}
+
+	arrStateInstances.assign(uiNumStates, std::vector<unsigned int>());
+	Clear();
+}
+
+/**
+ @brief Remove all the instances
+ */
+void CStateMachine::Clear(void)
+{
+	arrStates.clear();
+	arrStateSlots.clear();
+	for (unsigned int i = 0; i < arrStateInstances.size(); i++)
+		arrStateInstances[i].clear();
+	arrNextStates.clear();
+	vecRaisedInstances.clear();
+	vecStateChanges.clear();
+}
+
+/**
+ @brief Add an instance in a state
+ @param uiState A const unsigned int variable containing the state of the instance
+ @return The number of the instance, which is the number of instances before it was added
+ */
+unsigned int CStateMachine::AddInstance(const unsigned int uiState)
+{
+	const unsigned int uiInstance = (unsigned int)arrStates.size();
+	arrStates.push_back(static_cast<unsigned int>(STATE_NONE));
+	arrStateSlots.push_back(0);
+	arrNextStates.push_back(static_cast<unsigned int>(STATE_NONE));
+	MoveInstance(uiInstance, uiState);
+	return uiInstance;
+}
+
+/**
+ @brief Get the number of instances
+ */
+unsigned int CStateMachine::GetNumInstances(void) const
+{
+	return (unsigned int)arrStates.size();
+}
+
+/**
+ @brief Get the state of an instance
+ @param uiInstance A const unsigned int variable containing the instance
+ */
+unsigned int CStateMachine::GetState(const unsigned int uiInstance) const
+{
+	return arrStates[uiInstance];
+}
+
+/**
+ @brief Get the state which an event changes a state to
+ @param uiState A const unsigned int variable containing the state
+ @param uiEvent A const unsigned int variable containing the event
+ @return The next state, or STATE_NONE if the event does not change the state
+ */
+unsigned int CStateMachine::GetTransition(const unsigned int uiState, const unsigned int uiEvent) const
+{
+	if ((uiState >= uiNumStates) || (uiEvent >= uiNumEvents))
+		return STATE_NONE;
+	return arrTransitionTable[uiState * uiNumEvents + uiEvent];
+}
+
+/**
+ @brief Raise an event for an instance, which changes its state at the next ApplyTransitions().
+		The transition is chosen from the state of the instance when the event is raised, and an event
+		which is raised later for the same instance replaces it
+ @param uiInstance A const unsigned int variable containing the instance
+ @param uiEvent A const unsigned int variable containing the event
+ @return true if the event changes the state of the instance, otherwise false
+ */
+bool CStateMachine::Raise(const unsigned int uiInstance, const unsigned int uiEvent)
+{
+	const unsigned int uiNextState = GetTransition(arrStates[uiInstance], uiEvent);
+	if (uiNextState == STATE_NONE)
+		return false;
+
+	if (arrNextStates[uiInstance] == STATE_NONE)
+		vecRaisedInstances.push_back(uiInstance);
+	arrNextStates[uiInstance] = uiNextState;
+	return true;
+}
+
+/**
+ @brief Change the states of the instances which have had events raised since the last call.
+		A transition to the same state is also reported, so that the state can be started again
+ @return The changes which were made, in the order that their instances were first raised,
+		which are valid until the next call
+ */
+const std::vector<CStateMachine::StateChange>& CStateMachine::ApplyTransitions(void)
+{
+	vecStateChanges.clear();
+	for (unsigned int i = 0; i < vecRaisedInstances.size(); i++)
+	{
+		const unsigned int uiInstance = vecRaisedInstances[i];
+		StateChange change;
+		change.uiInstance = uiInstance;
+		change.uiFrom = arrStates[uiInstance];
+		change.uiTo = arrNextStates[uiInstance];
+		vecStateChanges.push_back(change);
+
+		MoveInstance(uiInstance, change.uiTo);
+		arrNextStates[uiInstance] = STATE_NONE;
+	}
+	vecRaisedInstances.clear();
+	return vecStateChanges;
+}
+
+/**
+ @brief Get the instances in a state, in no particular order
+ @param uiState A const unsigned int variable containing the state
+ */
+const std::vector<unsigned int>& CStateMachine::GetInstances(const unsigned int uiState) const
+{
+	return arrStateInstances[uiState];
+}
+
+/**
+ @brief Move an instance into a state.
+		It is removed from the instances of its old state by moving the last instance of that state into its place
+ @param uiInstance A const unsigned int variable containing the instance
+ @param uiState A const unsigned int variable containing the new state
+ */
+void CStateMachine::MoveInstance(const unsigned int uiInstance, const unsigned int uiState)
+{
+	const unsigned int uiOldState = arrStates[uiInstance];
+	if (uiOldState == uiState)
+		return;
+
+	if (uiOldState != STATE_NONE)
+	{
+		std::vector<unsigned int>& vecOldInstances = arrStateInstances[uiOldState];
+		const unsigned int uiLast = vecOldInstances.back();
+		vecOldInstances[arrStateSlots[uiInstance]] = uiLast;
+		arrStateSlots[uiLast] = arrStateSlots[uiInstance];
+		vecOldInstances.pop_back();
+	}
+
+	arrStates[uiInstance] = uiState;
+	arrStateSlots[uiInstance] = (unsigned int)arrStateInstances[uiState].size();
+	arrStateInstances[uiState].push_back(uiInstance);
+}
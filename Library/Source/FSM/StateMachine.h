@@ -0,0 +1,94 @@
+/**
+ CStateMachine
+ @brief A finite state machine which is shared by many instances, such as all the enemies of a scene.
+		The states, events and transitions are numbers which are declared once as a table, and each instance
+		only stores its current state. Events which are raised for an instance are turned into transitions
+		by ApplyTransitions(), so the instances in each state can be updated together as a batch
+		without the batches changing while they are being updated.
+ By: JH Chong
+ Date: Aug 2022
+ */
+#pragma once
+
+#include <vector>
+
+class CStateMachine
+{
+public:
+	// The state of an instance without a state, and the result of a transition which is not in the table
+	static const unsigned int STATE_NONE = 0xFFFFFFFF;
+
+	// A transition from a state to another when an event is raised
+	struct Transition
+	{
+		unsigned int uiFrom;
+		unsigned int uiEvent;
+		unsigned int uiTo;
+	};
+
+	// A transition which was made by ApplyTransitions()
+	struct StateChange
+	{
+		unsigned int uiInstance;
+		unsigned int uiFrom;
+		unsigned int uiTo;
+	};
+
+	// Constructor
+	CStateMachine(void);
+
+	// Destructor
+	virtual ~CStateMachine(void);
+
+	// Declare the states, events and transitions, and remove all the instances
+	void Init(	const unsigned int uiNumStates,
+				const unsigned int uiNumEvents,
+				const Transition* arrTransitions,
+				const unsigned int uiNumTransitions);
+
+	// Remove all the instances
+	void Clear(void);
+
+	// Add an instance in a state, and return its number
+	unsigned int AddInstance(const unsigned int uiState);
+
+	// Get the number of instances
+	unsigned int GetNumInstances(void) const;
+
+	// Get the state of an instance
+	unsigned int GetState(const unsigned int uiInstance) const;
+
+	// Get the state which an event changes a state to, or STATE_NONE if the event does not change it
+	unsigned int GetTransition(const unsigned int uiState, const unsigned int uiEvent) const;
+
+	// Raise an event for an instance, which changes its state at the next ApplyTransitions()
+	bool Raise(const unsigned int uiInstance, const unsigned int uiEvent);
+
+	// Change the states of the instances which have had events raised, and get the changes which were made
+	const std::vector<StateChange>& ApplyTransitions(void);
+
+	// Get the instances in a state
+	const std::vector<unsigned int>& GetInstances(const unsigned int uiState) const;
+
+protected:
+	unsigned int uiNumStates;
+	unsigned int uiNumEvents;
+	// The state which each event changes each state to, at [state * uiNumEvents + event]
+	std::vector<unsigned int> arrTransitionTable;
+
+	// The state of each instance, and its position in the instances of its state
+	std::vector<unsigned int> arrStates;
+	std::vector<unsigned int> arrStateSlots;
+	// The instances in each state
+	std::vector<std::vector<unsigned int>> arrStateInstances;
+
+	// The state which each instance changes to at the next ApplyTransitions(), or STATE_NONE,
+	// and the instances which have a state to change to
+	std::vector<unsigned int> arrNextStates;
+	std::vector<unsigned int> vecRaisedInstances;
+	// The changes made by the last ApplyTransitions()
+	std::vector<StateChange> vecStateChanges;
+
+	// Move an instance into a state
+	void MoveInstance(const unsigned int uiInstance, const unsigned int uiState);
+};
@@ -8,6 +8,8 @@ CSettings::CSettings(void)
 	, logl_root(NULL)
 	, NUM_TILES_XAXIS(32)
 	, NUM_TILES_YAXIS(24)
+	, NUM_VIEW_TILES_XAXIS(32)
+	, NUM_VIEW_TILES_YAXIS(24)
 	, TILE_WIDTH(0.0625f)
 	, TILE_HEIGHT(0.08333f)
 	, NUM_STEPS_PER_TILE_XAXIS(16.f)
@@ -35,8 +37,9 @@ float CSettings::ConvertIndexToUVSpace(const AXIS sAxis, const int iIndex, const
 	}
 	else if (sAxis == y)
 	{
+		// Inverted indices count from the top row of the map, which may be above the view
 		if (bInvert)
-			fResult = 1.0f - (float)(iIndex + 1)*TILE_HEIGHT + TILE_HEIGHT / 2.0f + fOffset;
+			fResult = -1.0f + (float)((int)NUM_TILES_YAXIS - iIndex - 1)*TILE_HEIGHT + TILE_HEIGHT / 2.0f + fOffset;
 		else
 			fResult = -1.0f + (float)iIndex*TILE_HEIGHT + TILE_HEIGHT / 2.0f + fOffset;
 	}
@@ -54,8 +57,9 @@ float CSettings::ConvertIndexToUVSpace(const AXIS sAxis, const int iIndex, const
 // Update the specifications of the map
 void CSettings::UpdateSpecifications(void)
 {
-	TILE_WIDTH = 2.0f / NUM_TILES_XAXIS;	// 0.0625f;
-	TILE_HEIGHT = 2.0f / NUM_TILES_YAXIS;	// 0.08333f;
+	// The tiles are sized to the view, so that maps larger than the view are scrolled instead of shrunk
+	TILE_WIDTH = 2.0f / (NUM_TILES_XAXIS < NUM_VIEW_TILES_XAXIS ? NUM_TILES_XAXIS : NUM_VIEW_TILES_XAXIS);	// 0.0625f;
+	TILE_HEIGHT = 2.0f / (NUM_TILES_YAXIS < NUM_VIEW_TILES_YAXIS ? NUM_TILES_YAXIS : NUM_VIEW_TILES_YAXIS);	// 0.08333f;
 
 	MICRO_STEP_XAXIS = TILE_WIDTH / NUM_STEPS_PER_TILE_XAXIS;
 	MICRO_STEP_YAXIS = TILE_HEIGHT / NUM_STEPS_PER_TILE_YAXIS;
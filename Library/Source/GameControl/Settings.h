@@ -50,6 +50,10 @@ public:
 	const unsigned char FPS = 30; // FPS of this game
 	const unsigned int frameTime = 1000 / FPS; // time for each frame
 
+	// AI Information
+	unsigned int AI_REPLAN_BUDGET = 500; // time in microseconds for the enemies to request paths in each frame
+	unsigned int AI_MAX_ROUTES_IN_FLIGHT = 8; // number of path requests of the enemies which may be searched at once
+
 	// Input control
 	//const bool bActivateMouseInput
 
@@ -58,6 +62,11 @@ public:
 	unsigned int NUM_TILES_XAXIS;
 	unsigned int NUM_TILES_YAXIS;
 
+	// The number of tiles which are visible in the window at once.
+	// Maps which are larger than this will scroll with the camera
+	unsigned int NUM_VIEW_TILES_XAXIS;
+	unsigned int NUM_VIEW_TILES_YAXIS;
+
 	float TILE_WIDTH;
 	float TILE_HEIGHT;
 
@@ -0,0 +1,152 @@
+/**
+ CAStar
+ @brief A class which finds the shortest path between 2 cells of a CNavGrid.
+		The search data of the cells are kept between searches and stamped with the generation 
+		of the search which wrote them, so starting a search does not reset every cell.
+		The open list is a binary heap which stores the position of each cell in the heap, 
+		so the cost of a cell can be lowered in place instead of pushing a duplicate.
+ By: JH Chong
+ Date: Aug 2022
+ */
+#include "AStar.h"
+
+/**
+ @brief Constructor
+ */
+CAStar::CAStar(void)
+	: uiGeneration(0)
+	, uiNumExpanded(0)
+{
+}
+
+/**
+ @brief Destructor
+ */
+CAStar::~CAStar(void)
+{
+}
+
+/**
+ @brief Get the number of cells which were expanded by the last search
+ */
+unsigned int CAStar::GetNumExpanded(void) const
+{
+	return uiNumExpanded;
+}
+
+/**
+ @brief Start a new search. The nodes are only resized when the grid has grown, 
+		and only reset when the generation counter wraps around
+ @param uiNumCells A const unsigned int variable containing the number of cells in the grid
+ */
+void CAStar::BeginSearch(const unsigned int uiNumCells)
+{
+	if (arrNodes.size() < uiNumCells)
+	{
+		Node node;
+		node.uiGeneration = 0;
+		node.g = COST_INFINITE;
+		node.f = COST_INFINITE;
+		node.uiParent = 0;
+		node.uiHeapIndex = NOT_IN_HEAP;
+		node.bClosed = false;
+		arrNodes.resize(uiNumCells, node);
+	}
+
+	uiGeneration++;
+	if (uiGeneration == 0)
+	{
+		for (unsigned int i = 0; i < arrNodes.size(); i++)
+			arrNodes[i].uiGeneration = 0;
+		uiGeneration = 1;
+	}
+
+	vecHeap.clear();
+	uiNumExpanded = 0;
+}
+
+/**
+ @brief Add a cell to the heap
+ */
+void CAStar::PushHeap(const unsigned int uiCell)
+{
+	arrNodes[uiCell].uiHeapIndex = vecHeap.size();
+	vecHeap.push_back(uiCell);
+	SiftUp(vecHeap.size() - 1);
+}
+
+/**
+ @brief Remove the cell with the lowest f from the heap
+ */
+unsigned int CAStar::PopHeap(void)
+{
+	const unsigned int uiCell = vecHeap.front();
+	arrNodes[uiCell].uiHeapIndex = NOT_IN_HEAP;
+
+	const unsigned int uiLast = vecHeap.back();
+	vecHeap.pop_back();
+	if (!vecHeap.empty())
+	{
+		vecHeap[0] = uiLast;
+		arrNodes[uiLast].uiHeapIndex = 0;
+		SiftDown(0);
+	}
+	return uiCell;
+}
+
+/**
+ @brief Move a cell towards the front of the heap until its parent is expanded before it
+ */
+void CAStar::SiftUp(unsigned int uiHeapIndex)
+{
+	const unsigned int uiCell = vecHeap[uiHeapIndex];
+	while (uiHeapIndex > 0)
+	{
+		const unsigned int uiParentIndex = (uiHeapIndex - 1) / 2;
+		if (!IsBefore(uiCell, vecHeap[uiParentIndex]))
+			break;
+		vecHeap[uiHeapIndex] = vecHeap[uiParentIndex];
+		arrNodes[vecHeap[uiHeapIndex]].uiHeapIndex = uiHeapIndex;
+		uiHeapIndex = uiParentIndex;
+	}
+	vecHeap[uiHeapIndex] = uiCell;
+	arrNodes[uiCell].uiHeapIndex = uiHeapIndex;
+}
+
+/**
+ @brief Move a cell towards the back of the heap until it is expanded before its children
+ */
+void CAStar::SiftDown(unsigned int uiHeapIndex)
+{
+	const unsigned int uiCell = vecHeap[uiHeapIndex];
+	const unsigned int uiSize = vecHeap.size();
+	while (true)
+	{
+		unsigned int uiChildIndex = uiHeapIndex * 2 + 1;
+		if (uiChildIndex >= uiSize)
+			break;
+		if ((uiChildIndex + 1 < uiSize) && IsBefore(vecHeap[uiChildIndex + 1], vecHeap[uiChildIndex]))
+			uiChildIndex++;
+		if (!IsBefore(vecHeap[uiChildIndex], uiCell))
+			break;
+		vecHeap[uiHeapIndex] = vecHeap[uiChildIndex];
+		arrNodes[vecHeap[uiHeapIndex]].uiHeapIndex = uiHeapIndex;
+		uiHeapIndex = uiChildIndex;
+	}
+	vecHeap[uiHeapIndex] = uiCell;
+	arrNodes[uiCell].uiHeapIndex = uiHeapIndex;
+}
+
+/**
+ @brief Build the path by following the parents from the goal to the start
+ @param uiStart A const unsigned int variable containing the start cell, which is not added to the path
+ @param uiGoal A const unsigned int variable containing the goal cell
+ @param vecPath A std::vector<unsigned int>& variable to store the path, from the start to the goal
+ */
+void CAStar::BuildPath(const unsigned int uiStart, const unsigned int uiGoal, std::vector<unsigned int>& vecPath) const
+{
+	vecPath.clear();
+	for (unsigned int uiCell = uiGoal; uiCell != uiStart; uiCell = arrNodes[uiCell].uiParent)
+		vecPath.push_back(uiCell);
+	std::reverse(vecPath.begin(), vecPath.end());
+}
@@ -0,0 +1,171 @@
+/**
+ CAStar
+ @brief A class which finds the shortest path between 2 cells of a CNavGrid.
+		The search data of the cells are kept between searches and stamped with the generation 
+		of the search which wrote them, so starting a search does not reset every cell.
+		The open list is a binary heap which stores the position of each cell in the heap, 
+		so the cost of a cell can be lowered in place instead of pushing a duplicate.
+ By: JH Chong
+ Date: Aug 2022
+ */
+#pragma once
+
+// Include NavGrid
+#include "NavGrid.h"
+// Include Heuristics
+#include "Heuristics.h"
+
+#include <vector>
+#include <algorithm>
+
+class CAStar
+{
+public:
+	// Constructor
+	CAStar(void);
+
+	// Destructor
+	virtual ~CAStar(void);
+
+	/**
+	 @brief Find the cheapest path between 2 cells, using the costs of the edges of the grid.
+			The number of directions to check, 4 or 8, and the heuristic are compile-time parameters,
+			so the loop over the neighbours is unrolled and the heuristic is inlined
+	 @param cNavGrid A const CNavGrid& variable containing the cells and their edges
+	 @param uiStart A const unsigned int variable containing the start cell
+	 @param uiGoal A const unsigned int variable containing the goal cell
+	 @param heuristic A function object which returns the estimated cost from a cell to the goal cell, 
+			e.g. Heuristics::CGoalHeuristic
+	 @param vecPath A std::vector<unsigned int>& variable to store the cells of the path from the start to the goal, 
+			excluding the start cell. It is empty if the start is the goal, or if the goal cannot be reached
+	 @return true if the goal can be reached, otherwise false
+	 */
+	template <unsigned int NUM_DIRECTIONS, typename Heuristic>
+	bool Search(const CNavGrid& cNavGrid,
+				const unsigned int uiStart,
+				const unsigned int uiGoal,
+				const Heuristic& heuristic,
+				std::vector<unsigned int>& vecPath);
+
+	// Get the number of cells which were expanded by the last search
+	unsigned int GetNumExpanded(void) const;
+
+protected:
+	// The value of a cost which has not been set
+	static const unsigned int COST_INFINITE = 0xFFFFFFFF;
+	// The heap position of a cell which is not in the open list
+	static const unsigned int NOT_IN_HEAP = 0xFFFFFFFF;
+
+	// The search data of a cell
+	struct Node
+	{
+		// The generation of the search which last wrote this node. 
+		// A node from an older generation is treated as not visited
+		unsigned int uiGeneration;
+		unsigned int g;
+		unsigned int f;
+		unsigned int uiParent;
+		// The position of this cell in the heap, or NOT_IN_HEAP
+		unsigned int uiHeapIndex;
+		bool bClosed;
+	};
+
+	std::vector<Node> arrNodes;
+	// The open list, as a binary heap of cells with the lowest f at the front
+	std::vector<unsigned int> vecHeap;
+	// The generation of the current search
+	unsigned int uiGeneration;
+	// The number of cells which were expanded by the last search
+	unsigned int uiNumExpanded;
+
+	// Start a new search on a grid with a number of cells
+	void BeginSearch(const unsigned int uiNumCells);
+	// Get the node of a cell, resetting it if it was written by an older search
+	inline Node& GetNode(const unsigned int uiCell)
+	{
+		Node& node = arrNodes[uiCell];
+		if (node.uiGeneration != uiGeneration)
+		{
+			node.uiGeneration = uiGeneration;
+			node.g = COST_INFINITE;
+			node.f = COST_INFINITE;
+			node.uiParent = uiCell;
+			node.uiHeapIndex = NOT_IN_HEAP;
+			node.bClosed = false;
+		}
+		return node;
+	}
+	// Check if cell a should be expanded before cell b. Ties on f are broken by the larger g, which is closer to the goal
+	inline bool IsBefore(const unsigned int a, const unsigned int b) const
+	{
+		if (arrNodes[a].f != arrNodes[b].f)
+			return arrNodes[a].f < arrNodes[b].f;
+		return arrNodes[a].g > arrNodes[b].g;
+	}
+	// Add a cell to the heap
+	void PushHeap(const unsigned int uiCell);
+	// Remove the cell with the lowest f from the heap
+	unsigned int PopHeap(void);
+	// Move a cell towards the front of the heap after its f was lowered
+	void SiftUp(unsigned int uiHeapIndex);
+	// Move a cell towards the back of the heap
+	void SiftDown(unsigned int uiHeapIndex);
+	// Build the path by following the parents from the goal to the start
+	void BuildPath(const unsigned int uiStart, const unsigned int uiGoal, std::vector<unsigned int>& vecPath) const;
+};
+
+template <unsigned int NUM_DIRECTIONS, typename Heuristic>
+bool CAStar::Search(const CNavGrid& cNavGrid,
+					const unsigned int uiStart,
+					const unsigned int uiGoal,
+					const Heuristic& heuristic,
+					std::vector<unsigned int>& vecPath)
+{
+	vecPath.clear();
+	BeginSearch(cNavGrid.GetNumCells());
+	if (uiStart == uiGoal)
+		return true;
+
+	Node& start = GetNode(uiStart);
+	start.g = 0;
+	start.f = heuristic(uiStart);
+	PushHeap(uiStart);
+
+	while (!vecHeap.empty())
+	{
+		const unsigned int uiCurrent = PopHeap();
+		if (uiCurrent == uiGoal)
+		{
+			BuildPath(uiStart, uiGoal, vecPath);
+			return true;
+		}
+
+		arrNodes[uiCurrent].bClosed = true;
+		uiNumExpanded++;
+		const unsigned int gCurrent = arrNodes[uiCurrent].g;
+
+		// Check the neighbours which can be entered from the current cell
+		const unsigned char ucEdges = cNavGrid.GetEdges(uiCurrent);
+		for (unsigned int uiDirection = 0; uiDirection < NUM_DIRECTIONS; uiDirection++)
+		{
+			if ((ucEdges & (1 << uiDirection)) == 0)
+				continue;
+
+			const unsigned int uiNeighbour = cNavGrid.GetNeighbour(uiCurrent, uiDirection);
+			const unsigned int gNew = gCurrent + cNavGrid.GetEdgeCost(uiCurrent, uiDirection);
+			Node& neighbour = GetNode(uiNeighbour);
+			if ((neighbour.bClosed) || (gNew >= neighbour.g))
+				continue;
+
+			neighbour.g = gNew;
+			neighbour.f = gNew + heuristic(uiNeighbour);
+			neighbour.uiParent = uiCurrent;
+			if (neighbour.uiHeapIndex == NOT_IN_HEAP)
+				PushHeap(uiNeighbour);
+			else
+				SiftUp(neighbour.uiHeapIndex);
+		}
+	}
+
+	return false;
+}
@@ -0,0 +1,380 @@
+/**
+ CDStarLite
+ @brief An incremental path finder (D* Lite) over a CNavGrid, for an entity which follows a path on a changing map.
+		It searches backwards from the goal and keeps the cost to the goal of every cell which it has searched, 
+		so when the entity moves along its path, cells change or the goal moves, the next call to Plan() only 
+		searches again where the costs have changed, instead of finding the whole path again like A*.
+		Each entity which plans this way needs its own CDStarLite.
+ By: JH Chong
+ Date: Aug 2022
+ */
+#include "DStarLite.h"
+
+// Include Heuristics
+#include "Heuristics.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+/**
+ @brief Constructor
+ */
+CDStarLite::CDStarLite(void)
+	: bPlanned(false)
+	, bFullSearch(false)
+	, uiGridRevision(0)
+	, uiNumDirections(4)
+	, uiWidth(0)
+	, uiStart(0)
+	, uiGoal(0)
+	, uiKeyModifier(0)
+	, uiNumExpanded(0)
+{
+}
+
+/**
+ @brief Destructor
+ */
+CDStarLite::~CDStarLite(void)
+{
+}
+
+/**
+ @brief Find the path from the start to the goal. 
+		If the last search was on the same grid, only the costs which are affected by the cells which changed since then, 
+		the new goal and the new start are searched again. Otherwise, the path is searched from scratch
+ @param cNavGrid A const CNavGrid& variable containing the cells and their edges
+ @param uiStart A const unsigned int variable containing the start cell
+ @param uiGoal A const unsigned int variable containing the goal cell
+ @param uiNumDirections A const unsigned int variable containing the number of directions to move in, 4 or 8
+ @param vecPath A std::vector<unsigned int>& variable to store the cells of the path, excluding the start cell
+ @return true if the goal can be reached, otherwise false
+ */
+bool CDStarLite::Plan(	const CNavGrid& cNavGrid,
+						const unsigned int uiStart,
+						const unsigned int uiGoal,
+						const unsigned int uiNumDirections,
+						std::vector<unsigned int>& vecPath)
+{
+	vecPath.clear();
+	uiNumExpanded = 0;
+	const unsigned int uiNumCells = cNavGrid.GetNumCells();
+	if ((uiStart >= uiNumCells) || (uiGoal >= uiNumCells))
+		return false;
+
+	// The last search can only be repaired if every change to the grid since then is known
+	if ((!bPlanned) || 
+		(uiNumDirections != this->uiNumDirections) || 
+		(cNavGrid.GetWidth() != uiWidth) || 
+		(arrG.size() != uiNumCells) ||
+		(!cNavGrid.GetChangedCells(uiGridRevision, vecChangedCells)))
+	{
+		Initialise(cNavGrid, uiStart, uiGoal, uiNumDirections);
+	}
+	else
+	{
+		bFullSearch = false;
+		uiGridRevision = cNavGrid.GetRevision();
+
+		if (uiStart != this->uiStart)
+		{
+			uiKeyModifier += GetHeuristic(this->uiStart, uiStart);
+			this->uiStart = uiStart;
+		}
+
+		if (uiGoal != this->uiGoal)
+		{
+			const unsigned int uiOldGoal = this->uiGoal;
+			this->uiGoal = uiGoal;
+			arrRHS[uiGoal] = 0;
+			UpdateCell(cNavGrid, uiGoal);
+			UpdateCell(cNavGrid, uiOldGoal);
+		}
+
+		// A changed cell changes its own edges, and the edges of its neighbours into it
+		for (unsigned int i = 0; i < vecChangedCells.size(); i++)
+		{
+			const unsigned int uiCell = vecChangedCells[i];
+			UpdateCell(cNavGrid, uiCell);
+			for (unsigned int uiDirection = 0; uiDirection < CNavGrid::NUM_DIRECTIONS; uiDirection++)
+			{
+				const int iX = (int)cNavGrid.GetX(uiCell) + CNavGrid::DIRECTION_X[uiDirection];
+				const int iY = (int)cNavGrid.GetY(uiCell) + CNavGrid::DIRECTION_Y[uiDirection];
+				if ((iX >= 0) && (iX < (int)cNavGrid.GetWidth()) && (iY >= 0) && (iY < (int)cNavGrid.GetHeight()))
+					UpdateCell(cNavGrid, cNavGrid.GetCell(iX, iY));
+			}
+		}
+	}
+
+	ComputeShortestPath(cNavGrid);
+	if (arrG[uiStart] == COST_INFINITE)
+		return false;
+
+	// Follow the cheapest successors from the start to the goal
+	unsigned int uiCurrent = uiStart;
+	while (uiCurrent != uiGoal)
+	{
+		const unsigned char ucEdges = cNavGrid.GetEdges(uiCurrent);
+		unsigned int uiBestCost = COST_INFINITE;
+		unsigned int uiBestCell = uiCurrent;
+		for (unsigned int uiDirection = 0; uiDirection < uiNumDirections; uiDirection++)
+		{
+			if ((ucEdges & (1 << uiDirection)) == 0)
+				continue;
+			const unsigned int uiNeighbour = cNavGrid.GetNeighbour(uiCurrent, uiDirection);
+			if (arrG[uiNeighbour] == COST_INFINITE)
+				continue;
+			const unsigned int uiCost = cNavGrid.GetEdgeCost(uiCurrent, uiDirection) + arrG[uiNeighbour];
+			if (uiCost < uiBestCost)
+			{
+				uiBestCost = uiCost;
+				uiBestCell = uiNeighbour;
+			}
+		}
+
+		if ((uiBestCost == COST_INFINITE) || (vecPath.size() >= uiNumCells))
+		{
+			vecPath.clear();
+			return false;
+		}
+		vecPath.push_back(uiBestCell);
+		uiCurrent = uiBestCell;
+	}
+
+	return true;
+}
+
+/**
+ @brief Forget the last search, so that the next call to Plan() searches from scratch
+ */
+void CDStarLite::Reset(void)
+{
+	bPlanned = false;
+}
+
+/**
+ @brief Get the number of cells which were expanded by the last call to Plan()
+ */
+unsigned int CDStarLite::GetNumExpanded(void) const
+{
+	return uiNumExpanded;
+}
+
+/**
+ @brief Check if the last call to Plan() searched from scratch
+ */
+bool CDStarLite::WasFullSearch(void) const
+{
+	return bFullSearch;
+}
+
+/**
+ @brief Start a search from scratch, with only the goal in the open list
+ @param cNavGrid A const CNavGrid& variable containing the cells and their edges
+ @param uiStart A const unsigned int variable containing the start cell
+ @param uiGoal A const unsigned int variable containing the goal cell
+ @param uiNumDirections A const unsigned int variable containing the number of directions to move in, 4 or 8
+ */
+void CDStarLite::Initialise(const CNavGrid& cNavGrid, const unsigned int uiStart, const unsigned int uiGoal, const unsigned int uiNumDirections)
+{
+	const unsigned int uiNumCells = cNavGrid.GetNumCells();
+	arrG.assign(uiNumCells, static_cast<unsigned int>(COST_INFINITE));
+	arrRHS.assign(uiNumCells, static_cast<unsigned int>(COST_INFINITE));
+	arrKeys.resize(uiNumCells);
+	arrInOpenList.assign(uiNumCells, false);
+	vecOpenList.clear();
+
+	bPlanned = true;
+	bFullSearch = true;
+	uiGridRevision = cNavGrid.GetRevision();
+	this->uiNumDirections = uiNumDirections;
+	uiWidth = cNavGrid.GetWidth();
+	this->uiStart = uiStart;
+	this->uiGoal = uiGoal;
+	uiKeyModifier = 0;
+
+	arrRHS[uiGoal] = 0;
+	UpdateCell(cNavGrid, uiGoal);
+}
+
+/**
+ @brief Expand the inconsistent cells in the order of their keys, until the start is consistent 
+		and no cell in the open list can lower its cost
+ @param cNavGrid A const CNavGrid& variable containing the cells and their edges
+ */
+void CDStarLite::ComputeShortestPath(const CNavGrid& cNavGrid)
+{
+	for (;;)
+	{
+		SkipStaleEntries();
+		if (vecOpenList.empty())
+			break;
+		if ((!IsLess(vecOpenList.front().first, CalculateKey(uiStart))) && (arrRHS[uiStart] == arrG[uiStart]))
+			break;
+
+		const Key keyOld = vecOpenList.front().first;
+		const unsigned int uiCell = vecOpenList.front().second;
+		std::pop_heap(vecOpenList.begin(), vecOpenList.end(), IsAfter);
+		vecOpenList.pop_back();
+		uiNumExpanded++;
+
+		// The start has moved since this cell was added, so add it again with its current key
+		const Key keyNew = CalculateKey(uiCell);
+		if (IsLess(keyOld, keyNew))
+		{
+			arrKeys[uiCell] = keyNew;
+			vecOpenList.push_back(std::make_pair(keyNew, uiCell));
+			std::push_heap(vecOpenList.begin(), vecOpenList.end(), IsAfter);
+			continue;
+		}
+
+		arrInOpenList[uiCell] = false;
+		if (arrG[uiCell] > arrRHS[uiCell])
+		{
+			// The cell has become cheaper, which may lower the costs of the cells which move into it
+			arrG[uiCell] = arrRHS[uiCell];
+		}
+		else
+		{
+			// The cell has become more expensive, so it and the cells which move into it find their costs again
+			arrG[uiCell] = COST_INFINITE;
+			UpdateCell(cNavGrid, uiCell);
+		}
+		UpdatePredecessors(cNavGrid, uiCell);
+	}
+}
+
+/**
+ @brief Recompute the cost of a cell from the costs of its successors, 
+		and add it to the open list if it is inconsistent, or remove it otherwise
+ @param cNavGrid A const CNavGrid& variable containing the cells and their edges
+ @param uiCell A const unsigned int variable containing the cell
+ */
+void CDStarLite::UpdateCell(const CNavGrid& cNavGrid, const unsigned int uiCell)
+{
+	if (uiCell != uiGoal)
+	{
+		unsigned int uiRHS = COST_INFINITE;
+		const unsigned char ucEdges = cNavGrid.GetEdges(uiCell);
+		for (unsigned int uiDirection = 0; uiDirection < uiNumDirections; uiDirection++)
+		{
+			if ((ucEdges & (1 << uiDirection)) == 0)
+				continue;
+			const unsigned int uiNeighbour = cNavGrid.GetNeighbour(uiCell, uiDirection);
+			if (arrG[uiNeighbour] != COST_INFINITE)
+				uiRHS = std::min(uiRHS, cNavGrid.GetEdgeCost(uiCell, uiDirection) + arrG[uiNeighbour]);
+		}
+		arrRHS[uiCell] = uiRHS;
+	}
+
+	if (arrG[uiCell] != arrRHS[uiCell])
+	{
+		arrKeys[uiCell] = CalculateKey(uiCell);
+		arrInOpenList[uiCell] = true;
+		vecOpenList.push_back(std::make_pair(arrKeys[uiCell], uiCell));
+		std::push_heap(vecOpenList.begin(), vecOpenList.end(), IsAfter);
+	}
+	else
+	{
+		arrInOpenList[uiCell] = false;
+	}
+}
+
+/**
+ @brief Update the cells which have an edge into a cell, after the cost of the cell changed
+ @param cNavGrid A const CNavGrid& variable containing the cells and their edges
+ @param uiCell A const unsigned int variable containing the cell
+ */
+void CDStarLite::UpdatePredecessors(const CNavGrid& cNavGrid, const unsigned int uiCell)
+{
+	const int iX = cNavGrid.GetX(uiCell);
+	const int iY = cNavGrid.GetY(uiCell);
+	for (unsigned int uiDirection = 0; uiDirection < uiNumDirections; uiDirection++)
+	{
+		// The cell which moves in this direction to reach this cell
+		const int iFromX = iX - CNavGrid::DIRECTION_X[uiDirection];
+		const int iFromY = iY - CNavGrid::DIRECTION_Y[uiDirection];
+		if ((iFromX < 0) || (iFromX >= (int)cNavGrid.GetWidth()) || (iFromY < 0) || (iFromY >= (int)cNavGrid.GetHeight()))
+			continue;
+
+		const unsigned int uiFrom = cNavGrid.GetCell(iFromX, iFromY);
+		if (cNavGrid.GetEdges(uiFrom) & (1 << uiDirection))
+			UpdateCell(cNavGrid, uiFrom);
+	}
+}
+
+/**
+ @brief Get the key of a cell, which orders the open list by the estimated cost of a path from the start through the cell
+ @param uiCell A const unsigned int variable containing the cell
+ @return The key of the cell
+ */
+CDStarLite::Key CDStarLite::CalculateKey(const unsigned int uiCell) const
+{
+	Key key;
+	const unsigned int uiCost = std::min(arrG[uiCell], arrRHS[uiCell]);
+	if (uiCost == COST_INFINITE)
+	{
+		key.uiPrimary = COST_INFINITE;
+		key.uiSecondary = COST_INFINITE;
+	}
+	else
+	{
+		key.uiPrimary = uiCost + GetHeuristic(uiStart, uiCell) + uiKeyModifier;
+		key.uiSecondary = uiCost;
+	}
+	return key;
+}
+
+/**
+ @brief Get the heuristic between 2 cells, which is the cost of the cheapest moves between them, 
+		ignoring the cells in the way
+ @param uiCellA A const unsigned int variable containing the first cell
+ @param uiCellB A const unsigned int variable containing the second cell
+ @return The heuristic between the cells
+ */
+unsigned int CDStarLite::GetHeuristic(const unsigned int uiCellA, const unsigned int uiCellB) const
+{
+	const unsigned int uiDX = abs((int)(uiCellA % uiWidth) - (int)(uiCellB % uiWidth));
+	const unsigned int uiDY = abs((int)(uiCellA / uiWidth) - (int)(uiCellB / uiWidth));
+	if (uiNumDirections == 4)
+		return Heuristics::Manhattan::Get(uiDX, uiDY, 1);
+	return Heuristics::Octile::Get(uiDX, uiDY, 1);
+}
+
+/**
+ @brief Remove the entries at the front of the open list whose cell has left the open list, or has been added again with another key
+ */
+void CDStarLite::SkipStaleEntries(void)
+{
+	while (!vecOpenList.empty())
+	{
+		const Key& key = vecOpenList.front().first;
+		const unsigned int uiCell = vecOpenList.front().second;
+		if ((arrInOpenList[uiCell]) &&
+			(key.uiPrimary == arrKeys[uiCell].uiPrimary) && 
+			(key.uiSecondary == arrKeys[uiCell].uiSecondary))
+			return;
+		std::pop_heap(vecOpenList.begin(), vecOpenList.end(), IsAfter);
+		vecOpenList.pop_back();
+	}
+}
+
+/**
+ @brief Compare 2 keys
+ @return true if keyA comes before keyB, otherwise false
+ */
+bool CDStarLite::IsLess(const Key& keyA, const Key& keyB)
+{
+	if (keyA.uiPrimary != keyB.uiPrimary)
+		return keyA.uiPrimary < keyB.uiPrimary;
+	return keyA.uiSecondary < keyB.uiSecondary;
+}
+
+/**
+ @brief Compare 2 entries of the open list, so that the heap has the lowest key at the front
+ @return true if entryA comes after entryB, otherwise false
+ */
+bool CDStarLite::IsAfter(const std::pair<Key, unsigned int>& entryA, const std::pair<Key, unsigned int>& entryB)
+{
+	return IsLess(entryB.first, entryA.first);
+}
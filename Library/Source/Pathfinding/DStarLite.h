@@ -0,0 +1,97 @@
+/**
+ CDStarLite
+ @brief An incremental path finder (D* Lite) over a CNavGrid, for an entity which follows a path on a changing map.
+		It searches backwards from the goal and keeps the cost to the goal of every cell which it has searched, 
+		so when the entity moves along its path, cells change or the goal moves, the next call to Plan() only 
+		searches again where the costs have changed, instead of finding the whole path again like A*.
+		Each entity which plans this way needs its own CDStarLite.
+ By: JH Chong
+ Date: Aug 2022
+ */
+#pragma once
+
+// Include NavGrid
+#include "NavGrid.h"
+
+#include <vector>
+#include <utility>
+
+class CDStarLite
+{
+public:
+	// The cost of a cell which cannot reach the goal
+	static const unsigned int COST_INFINITE = 0xFFFFFFFF;
+
+	// Constructor
+	CDStarLite(void);
+
+	// Destructor
+	virtual ~CDStarLite(void);
+
+	// Find the path from the start to the goal, repairing the last search if there is one
+	bool Plan(	const CNavGrid& cNavGrid,
+				const unsigned int uiStart,
+				const unsigned int uiGoal,
+				const unsigned int uiNumDirections,
+				std::vector<unsigned int>& vecPath);
+
+	// Forget the last search, so that the next call to Plan() searches from scratch
+	void Reset(void);
+
+	// Get the number of cells which were expanded by the last call to Plan()
+	unsigned int GetNumExpanded(void) const;
+	// Check if the last call to Plan() searched from scratch
+	bool WasFullSearch(void) const;
+
+protected:
+	// The priority of a cell in the open list. Keys are compared by uiPrimary, and then by uiSecondary
+	struct Key
+	{
+		unsigned int uiPrimary;
+		unsigned int uiSecondary;
+	};
+
+	// The cost to the goal of each cell, and the cost which is found from its successors.
+	// A cell is consistent when they are equal, and only the inconsistent cells are in the open list
+	std::vector<unsigned int> arrG;
+	std::vector<unsigned int> arrRHS;
+	// The key with which each cell is in the open list, which is only valid if it is in the open list
+	std::vector<Key> arrKeys;
+	std::vector<bool> arrInOpenList;
+	// The open list, as a heap of (key, cell) with the lowest key at the front.
+	// A cell whose key changes is pushed again, and entries which do not match arrKeys are skipped when they are popped
+	std::vector<std::pair<Key, unsigned int>> vecOpenList;
+	std::vector<unsigned int> vecChangedCells;
+
+	bool bPlanned;
+	bool bFullSearch;
+	unsigned int uiGridRevision;
+	unsigned int uiNumDirections;
+	unsigned int uiWidth;
+	unsigned int uiStart;
+	unsigned int uiGoal;
+	// The total of the heuristic between each start and the next, which is added to the keys
+	// so that the keys in the open list stay valid after the start moves
+	unsigned int uiKeyModifier;
+	unsigned int uiNumExpanded;
+
+	// Start a search from scratch
+	void Initialise(const CNavGrid& cNavGrid, const unsigned int uiStart, const unsigned int uiGoal, const unsigned int uiNumDirections);
+	// Expand the inconsistent cells until the cost of the start is known
+	void ComputeShortestPath(const CNavGrid& cNavGrid);
+	// Recompute the cost of a cell from its successors, and add it to or remove it from the open list
+	void UpdateCell(const CNavGrid& cNavGrid, const unsigned int uiCell);
+	// Update the cells which can move into a cell
+	void UpdatePredecessors(const CNavGrid& cNavGrid, const unsigned int uiCell);
+	// Get the key of a cell
+	Key CalculateKey(const unsigned int uiCell) const;
+	// Get the heuristic between 2 cells
+	unsigned int GetHeuristic(const unsigned int uiCellA, const unsigned int uiCellB) const;
+	// Remove the entries at the front of the open list which are no longer valid
+	void SkipStaleEntries(void);
+
+	// Compare 2 keys
+	static bool IsLess(const Key& keyA, const Key& keyB);
+	// Compare 2 entries of the open list, so that the heap has the lowest key at the front
+	static bool IsAfter(const std::pair<Key, unsigned int>& entryA, const std::pair<Key, unsigned int>& entryB);
+};
@@ -0,0 +1,256 @@
+/**
+ CDistanceField
+ @brief The distance from every cell of a CNavGrid to the nearest of a set of source cells,
+		the next cell to move to from every cell to get there, and which source it leads to.
+		It is built with one search backwards from the sources, using the costs of the edges of the grid, 
+		so any number of entities heading to the same sources can each read their next step in constant time.
+ By: JH Chong
+ Date: Aug 2022
+ */
+#include "DistanceField.h"
+
+#include <algorithm>
+#include <functional>
+
+/**
+ @brief Constructor
+ */
+CDistanceField::CDistanceField(void)
+	: bBuilt(false)
+	, uiGridRevision(0)
+	, uiNumDirections(4)
+{
+}
+
+/**
+ @brief Destructor
+ */
+CDistanceField::~CDistanceField(void)
+{
+}
+
+/**
+ @brief Build the field from a set of source cells, with a search from all of them at once
+ @param cNavGrid A const CNavGrid& variable containing the cells and their edges
+ @param vecSources A const std::vector<unsigned int>& variable containing the source cells
+ @param uiNumDirections A const unsigned int variable containing the number of directions to move in, 4 or 8
+ */
+void CDistanceField::Build(const CNavGrid& cNavGrid, const std::vector<unsigned int>& vecSources, const unsigned int uiNumDirections)
+{
+	const unsigned int uiNumCells = cNavGrid.GetNumCells();
+	arrDistances.assign(uiNumCells, static_cast<unsigned int>(DISTANCE_INFINITE));
+	arrNextCells.resize(uiNumCells);
+	arrSourceCells.resize(uiNumCells);
+	this->vecSources = vecSources;
+	this->uiNumDirections = uiNumDirections;
+	uiGridRevision = cNavGrid.GetRevision();
+	bBuilt = true;
+
+	vecQueue.clear();
+	for (unsigned int i = 0; i < vecSources.size(); i++)
+	{
+		const unsigned int uiSource = vecSources[i];
+		if ((uiSource >= uiNumCells) || (arrDistances[uiSource] == 0))
+			continue;
+		arrDistances[uiSource] = 0;
+		arrNextCells[uiSource] = uiSource;
+		arrSourceCells[uiSource] = uiSource;
+		vecQueue.push_back(std::make_pair(0u, uiSource));
+	}
+
+	Propagate(cNavGrid);
+}
+
+/**
+ @brief Add a source to the field. 
+		Only the cells which are now closer to a source than before are updated, 
+		so this costs much less than building the field again
+ @param cNavGrid A const CNavGrid& variable containing the cells and their edges, which must be unchanged since Build()
+ @param uiSource A const unsigned int variable containing the new source cell
+ */
+void CDistanceField::AddSource(const CNavGrid& cNavGrid, const unsigned int uiSource)
+{
+	if ((uiSource >= arrDistances.size()) || (arrDistances[uiSource] == 0))
+		return;
+
+	vecSources.push_back(uiSource);
+	arrDistances[uiSource] = 0;
+	arrNextCells[uiSource] = uiSource;
+	arrSourceCells[uiSource] = uiSource;
+
+	vecQueue.clear();
+	vecQueue.push_back(std::make_pair(0u, uiSource));
+	Propagate(cNavGrid);
+}
+
+/**
+ @brief Remove a source from the field. 
+		Only the cells whose nearest source it was are updated: they are cleared, each is given the cheapest distance 
+		through a neighbour which still leads to another source, and these distances are spread among them, 
+		so this costs much less than building the field again
+ @param cNavGrid A const CNavGrid& variable containing the cells and their edges, which must be unchanged since Build()
+ @param uiSource A const unsigned int variable containing the source cell to remove
+ */
+void CDistanceField::RemoveSource(const CNavGrid& cNavGrid, const unsigned int uiSource)
+{
+	std::vector<unsigned int>::iterator it = std::find(vecSources.begin(), vecSources.end(), uiSource);
+	if (it == vecSources.end())
+		return;
+	vecSources.erase(it);
+
+	const int iWidth = cNavGrid.GetWidth();
+	const int iHeight = cNavGrid.GetHeight();
+
+	// Clear the cells which lead to the source. They are found backwards from the source, 
+	// as each of them moves into a cell which leads to the same source
+	vecInvalidCells.clear();
+	vecInvalidCells.push_back(uiSource);
+	arrDistances[uiSource] = DISTANCE_INFINITE;
+	for (unsigned int i = 0; i < vecInvalidCells.size(); i++)
+	{
+		const unsigned int uiCell = vecInvalidCells[i];
+		const int iX = cNavGrid.GetX(uiCell);
+		const int iY = cNavGrid.GetY(uiCell);
+		for (unsigned int uiDirection = 0; uiDirection < uiNumDirections; uiDirection++)
+		{
+			const int iFromX = iX - CNavGrid::DIRECTION_X[uiDirection];
+			const int iFromY = iY - CNavGrid::DIRECTION_Y[uiDirection];
+			if ((iFromX < 0) || (iFromX >= iWidth) || (iFromY < 0) || (iFromY >= iHeight))
+				continue;
+
+			const unsigned int uiFrom = cNavGrid.GetCell(iFromX, iFromY);
+			if ((cNavGrid.GetEdges(uiFrom) & (1 << uiDirection)) == 0)
+				continue;
+			if ((arrDistances[uiFrom] == DISTANCE_INFINITE) || (arrSourceCells[uiFrom] != uiSource))
+				continue;
+			arrDistances[uiFrom] = DISTANCE_INFINITE;
+			vecInvalidCells.push_back(uiFrom);
+		}
+	}
+
+	// Seed each cleared cell from the cheapest of its neighbours which still lead to a source
+	vecQueue.clear();
+	for (unsigned int i = 0; i < vecInvalidCells.size(); i++)
+	{
+		const unsigned int uiCell = vecInvalidCells[i];
+		const unsigned char ucEdges = cNavGrid.GetEdges(uiCell);
+		for (unsigned int uiDirection = 0; uiDirection < uiNumDirections; uiDirection++)
+		{
+			if ((ucEdges & (1 << uiDirection)) == 0)
+				continue;
+			const unsigned int uiNext = cNavGrid.GetNeighbour(uiCell, uiDirection);
+			if (arrDistances[uiNext] == DISTANCE_INFINITE)
+				continue;
+			const unsigned int uiDistance = arrDistances[uiNext] + cNavGrid.GetEdgeCost(uiCell, uiDirection);
+			if (arrDistances[uiCell] <= uiDistance)
+				continue;
+			arrDistances[uiCell] = uiDistance;
+			arrNextCells[uiCell] = uiNext;
+			arrSourceCells[uiCell] = arrSourceCells[uiNext];
+		}
+		if (arrDistances[uiCell] != DISTANCE_INFINITE)
+			vecQueue.push_back(std::make_pair(arrDistances[uiCell], uiCell));
+	}
+
+	Propagate(cNavGrid);
+}
+
+/**
+ @brief Lower the distances of the cells which can reach the cells in vecQueue, cheapest first. 
+		The search runs backwards: a cell is reached from a neighbour if the cell has an edge into that neighbour
+ @param cNavGrid A const CNavGrid& variable containing the cells and their edges
+ */
+void CDistanceField::Propagate(const CNavGrid& cNavGrid)
+{
+	const int iWidth = cNavGrid.GetWidth();
+	const int iHeight = cNavGrid.GetHeight();
+	std::make_heap(vecQueue.begin(), vecQueue.end(), std::greater<std::pair<unsigned int, unsigned int>>());
+	while (!vecQueue.empty())
+	{
+		std::pop_heap(vecQueue.begin(), vecQueue.end(), std::greater<std::pair<unsigned int, unsigned int>>());
+		const unsigned int uiCell = vecQueue.back().second;
+		const unsigned int uiCellDistance = vecQueue.back().first;
+		vecQueue.pop_back();
+		if (uiCellDistance > arrDistances[uiCell])
+			continue;
+
+		const int iX = cNavGrid.GetX(uiCell);
+		const int iY = cNavGrid.GetY(uiCell);
+		for (unsigned int uiDirection = 0; uiDirection < uiNumDirections; uiDirection++)
+		{
+			// The cell which moves in this direction to reach the current cell
+			const int iFromX = iX - CNavGrid::DIRECTION_X[uiDirection];
+			const int iFromY = iY - CNavGrid::DIRECTION_Y[uiDirection];
+			if ((iFromX < 0) || (iFromX >= iWidth) || (iFromY < 0) || (iFromY >= iHeight))
+				continue;
+
+			const unsigned int uiFrom = cNavGrid.GetCell(iFromX, iFromY);
+			if ((cNavGrid.GetEdges(uiFrom) & (1 << uiDirection)) == 0)
+				continue;
+			const unsigned int uiDistance = uiCellDistance + cNavGrid.GetEdgeCost(uiFrom, uiDirection);
+			if (arrDistances[uiFrom] <= uiDistance)
+				continue;
+
+			arrDistances[uiFrom] = uiDistance;
+			arrNextCells[uiFrom] = uiCell;
+			arrSourceCells[uiFrom] = arrSourceCells[uiCell];
+			vecQueue.push_back(std::make_pair(uiDistance, uiFrom));
+			std::push_heap(vecQueue.begin(), vecQueue.end(), std::greater<std::pair<unsigned int, unsigned int>>());
+		}
+	}
+}
+
+/**
+ @brief Check if the field was built from the current revision of a grid, moving in a number of directions
+ */
+bool CDistanceField::IsUpToDate(const CNavGrid& cNavGrid, const unsigned int uiNumDirections) const
+{
+	return bBuilt && (uiGridRevision == cNavGrid.GetRevision()) && (this->uiNumDirections == uiNumDirections);
+}
+
+/**
+ @brief Get the sources which the field was built from
+ */
+const std::vector<unsigned int>& CDistanceField::GetSources(void) const
+{
+	return vecSources;
+}
+
+/**
+ @brief Get the cost of the cheapest path from a cell to the nearest source, or DISTANCE_INFINITE if it cannot reach a source
+ */
+unsigned int CDistanceField::GetDistance(const unsigned int uiCell) const
+{
+	if (uiCell >= arrDistances.size())
+		return DISTANCE_INFINITE;
+	return arrDistances[uiCell];
+}
+
+/**
+ @brief Get the next cell to move to from a cell, to get closer to the nearest source
+ @param uiCell A const unsigned int variable containing the cell to move from
+ @param uiNextCell An unsigned int& variable to store the next cell
+ @return true if there is a next cell, or false if the cell is a source or cannot reach a source
+ */
+bool CDistanceField::GetNextCell(const unsigned int uiCell, unsigned int& uiNextCell) const
+{
+	const unsigned int uiDistance = GetDistance(uiCell);
+	if ((uiDistance == 0) || (uiDistance == DISTANCE_INFINITE))
+		return false;
+	uiNextCell = arrNextCells[uiCell];
+	return true;
+}
+
+/**
+ @brief Get the source which is the cheapest to reach from a cell
+ @param uiCell A const unsigned int variable containing the cell
+ @param uiSource An unsigned int& variable to store the source
+ @return true if the cell can reach a source, otherwise false
+ */
+bool CDistanceField::GetNearestSource(const unsigned int uiCell, unsigned int& uiSource) const
+{
+	if (GetDistance(uiCell) == DISTANCE_INFINITE)
+		return false;
+	uiSource = arrSourceCells[uiCell];
+	return true;
+}
@@ -0,0 +1,71 @@
+/**
+ CDistanceField
+ @brief The distance from every cell of a CNavGrid to the nearest of a set of source cells,
+		the next cell to move to from every cell to get there, and which source it leads to.
+		It is built with one search backwards from the sources, using the costs of the edges of the grid, 
+		so any number of entities heading to the same sources can each read their next step in constant time.
+ By: JH Chong
+ Date: Aug 2022
+ */
+#pragma once
+
+// Include NavGrid
+#include "NavGrid.h"
+
+#include <vector>
+#include <utility>
+
+class CDistanceField
+{
+public:
+	// The distance of a cell which cannot reach a source
+	static const unsigned int DISTANCE_INFINITE = 0xFFFFFFFF;
+
+	// Constructor
+	CDistanceField(void);
+
+	// Destructor
+	virtual ~CDistanceField(void);
+
+	// Build the field from a set of source cells, moving in 4 or 8 directions
+	void Build(const CNavGrid& cNavGrid, const std::vector<unsigned int>& vecSources, const unsigned int uiNumDirections);
+
+	// Add a source to the field, updating only the cells which are now closer to a source
+	void AddSource(const CNavGrid& cNavGrid, const unsigned int uiSource);
+
+	// Remove a source from the field, updating only the cells whose nearest source it was
+	void RemoveSource(const CNavGrid& cNavGrid, const unsigned int uiSource);
+
+	// Check if the field was built from the current revision of a grid, moving in a number of directions
+	bool IsUpToDate(const CNavGrid& cNavGrid, const unsigned int uiNumDirections) const;
+
+	// Get the sources which the field was built from
+	const std::vector<unsigned int>& GetSources(void) const;
+
+	// Get the cost of the cheapest path from a cell to the nearest source
+	unsigned int GetDistance(const unsigned int uiCell) const;
+
+	// Get the next cell to move to from a cell, to get closer to the nearest source
+	bool GetNextCell(const unsigned int uiCell, unsigned int& uiNextCell) const;
+
+	// Get the source which is the cheapest to reach from a cell
+	bool GetNearestSource(const unsigned int uiCell, unsigned int& uiSource) const;
+
+protected:
+	std::vector<unsigned int> arrDistances;
+	std::vector<unsigned int> arrNextCells;
+	std::vector<unsigned int> arrSourceCells;
+	std::vector<unsigned int> vecSources;
+	// The cells waiting to be expanded, as a heap of (distance, cell) with the lowest distance at the front.
+	// A cell whose distance is lowered is pushed again, and the older entry is skipped when it is popped
+	std::vector<std::pair<unsigned int, unsigned int>> vecQueue;
+	// The cells whose nearest source was removed by RemoveSource()
+	std::vector<unsigned int> vecInvalidCells;
+
+	bool bBuilt;
+	unsigned int uiGridRevision;
+	unsigned int uiNumDirections;
+
+	// Lower the distances of the cells which can reach the cells in vecQueue
+	void Propagate(const CNavGrid& cNavGrid);
+};
@@ -0,0 +1,720 @@
+/**
+ CHPAStar
+ @brief Hierarchical path finding (HPA*) over a CNavGrid, for long paths on large maps.
+		The grid is divided into square clusters. Along each cluster border, the runs of cells which can cross it
+		get an entrance node at their middle, or at both ends of a long run, and the cost of the cheapest path 
+		between the entrance nodes of each cluster is precomputed. A long path is found by searching this small graph 
+		of entrance nodes, and only the first part of it is refined into cells, when it is needed. The path may cost
+		a little more than the cheapest, as it crosses each run at an entrance node.
+		The clusters are all built by Build() after Init(), e.g. when a map is loaded. When a cell changes, 
+		only its cluster, and the clusters across a border which it lies on, are rebuilt by the next search.
+		Only the 4 straight directions are supported.
+ By: JH Chong
+ Date: Aug 2022
+ */
+#include "HPAStar.h"
+
+#include <algorithm>
+#include <functional>
+
+// The cost of a path which has not been found
+static const unsigned int COST_INFINITE = 0xFFFFFFFF;
+// The length of a run of transitions from which entrances are placed at both ends of the run instead of at its middle
+static const unsigned int LONG_ENTRANCE_LENGTH = 6;
+
+/**
+ @brief Constructor
+ */
+CHPAStar::CHPAStar(void)
+	: uiClusterSize(16)
+	, uiWidth(0)
+	, uiHeight(0)
+	, uiNumClustersX(0)
+	, uiNumClustersY(0)
+	, uiNumClusterBuilds(0)
+	, uiSearchGeneration(0)
+{
+}
+
+/**
+ @brief Destructor
+ */
+CHPAStar::~CHPAStar(void)
+{
+}
+
+/**
+ @brief Init the clusters for the size of a grid, which are all marked to be built. 
+		Call Build() after the cells of the grid are set, so that the first search does not build every cluster
+ @param cNavGrid A const CNavGrid& variable containing the grid
+ @param uiClusterSize A const unsigned int variable containing the number of cells along each side of a cluster
+ */
+void CHPAStar::Init(const CNavGrid& cNavGrid, const unsigned int uiClusterSize)
+{
+	this->uiClusterSize = uiClusterSize;
+	uiWidth = cNavGrid.GetWidth();
+	uiHeight = cNavGrid.GetHeight();
+	uiNumClustersX = (uiWidth + uiClusterSize - 1) / uiClusterSize;
+	uiNumClustersY = (uiHeight + uiClusterSize - 1) / uiClusterSize;
+	uiNumClusterBuilds = 0;
+
+	vecClusters.assign(uiNumClustersX * uiNumClustersY, Cluster());
+	vecDirtyClusters.clear();
+	for (unsigned int i = 0; i < vecClusters.size(); i++)
+	{
+		vecClusters[i].bDirty = false;
+		MarkClusterDirty(i);
+	}
+
+	const unsigned int uiNumVerticalBorders = (uiNumClustersX > 0) ? (uiNumClustersX - 1) * uiNumClustersY : 0;
+	const unsigned int uiNumHorizontalBorders = (uiNumClustersY > 0) ? uiNumClustersX * (uiNumClustersY - 1) : 0;
+	vecVerticalBorders.assign(uiNumVerticalBorders, std::vector<Transition>());
+	vecVerticalBordersDirty.assign(uiNumVerticalBorders, false);
+	vecDirtyVerticalBorders.clear();
+	for (unsigned int i = 0; i < uiNumVerticalBorders; i++)
+		MarkBorderDirty(true, i);
+	vecHorizontalBorders.assign(uiNumHorizontalBorders, std::vector<Transition>());
+	vecHorizontalBordersDirty.assign(uiNumHorizontalBorders, false);
+	vecDirtyHorizontalBorders.clear();
+	for (unsigned int i = 0; i < uiNumHorizontalBorders; i++)
+		MarkBorderDirty(false, i);
+
+	arrLocalDistances.resize(uiClusterSize * uiClusterSize);
+	arrSearchNodeOfCell.assign(uiWidth * uiHeight, 0);
+	arrSearchGeneration.assign(uiWidth * uiHeight, 0);
+	uiSearchGeneration = 0;
+}
+
+/**
+ @brief Build the borders and clusters which are marked to be built, e.g. all of them after Init(). 
+		A search also builds them first, so this only moves the time of building them, such as to when a map is loaded
+ @param cNavGrid A const CNavGrid& variable containing the cells and their edges
+ */
+void CHPAStar::Build(const CNavGrid& cNavGrid)
+{
+	UpdateDirtyClusters(cNavGrid);
+}
+
+/**
+ @brief Mark the clusters which depend on a cell to be rebuilt, after the cell changed.
+		A cell on the edge of its cluster also changes the entrances across that border
+ @param uiX A const unsigned int variable containing the column of the cell
+ @param uiY A const unsigned int variable containing the row of the cell
+ */
+void CHPAStar::OnCellChanged(const unsigned int uiX, const unsigned int uiY)
+{
+	if ((uiX >= uiWidth) || (uiY >= uiHeight))
+		return;
+
+	const unsigned int uiClusterX = uiX / uiClusterSize;
+	const unsigned int uiClusterY = uiY / uiClusterSize;
+	MarkClusterDirty(uiClusterY * uiNumClustersX + uiClusterX);
+
+	const unsigned int uiLocalX = uiX % uiClusterSize;
+	const unsigned int uiLocalY = uiY % uiClusterSize;
+	if ((uiLocalX == 0) && (uiClusterX > 0))
+		MarkBorderDirty(true, uiClusterY * (uiNumClustersX - 1) + uiClusterX - 1);
+	if ((uiLocalX == uiClusterSize - 1) && (uiClusterX + 1 < uiNumClustersX))
+		MarkBorderDirty(true, uiClusterY * (uiNumClustersX - 1) + uiClusterX);
+	if ((uiLocalY == 0) && (uiClusterY > 0))
+		MarkBorderDirty(false, (uiClusterY - 1) * uiNumClustersX + uiClusterX);
+	if ((uiLocalY == uiClusterSize - 1) && (uiClusterY + 1 < uiNumClustersY))
+		MarkBorderDirty(false, uiClusterY * uiNumClustersX + uiClusterX);
+}
+
+/**
+ @brief Check if 2 cells are in the same cluster
+ */
+bool CHPAStar::IsSameCluster(const unsigned int uiCellA, const unsigned int uiCellB) const
+{
+	if (uiWidth == 0)
+		return true;
+	return ((uiCellA % uiWidth) / uiClusterSize == (uiCellB % uiWidth) / uiClusterSize) &&
+		((uiCellA / uiWidth) / uiClusterSize == (uiCellB / uiWidth) / uiClusterSize);
+}
+
+/**
+ @brief Find the entrance nodes which a short path from the start to the goal passes through.
+		The start and the goal are connected to the entrance nodes of their clusters with a search 
+		which stays in each cluster, and then the graph of entrance nodes is searched with A*.
+		Every run of cells across a border has an entrance node, so a path is found if the goal can be reached,
+		but it may cost a little more than the cheapest path in the grid
+ @param cNavGrid A const CNavGrid& variable containing the cells and their edges
+ @param uiStart A const unsigned int variable containing the start cell
+ @param uiGoal A const unsigned int variable containing the goal cell
+ @param vecWaypoints A std::vector<unsigned int>& variable to store the cells to pass through, 
+		excluding the start and ending with the goal
+ @return true if the goal can be reached, otherwise false
+ */
+bool CHPAStar::FindAbstractPath(const CNavGrid& cNavGrid,
+								const unsigned int uiStart,
+								const unsigned int uiGoal,
+								std::vector<unsigned int>& vecWaypoints)
+{
+	vecWaypoints.clear();
+	if (uiStart == uiGoal)
+		return true;
+	if (!cNavGrid.IsPassable(uiGoal))
+		return false;
+
+	UpdateDirtyClusters(cNavGrid);
+
+	const unsigned int uiStartCluster = GetCluster(cNavGrid, uiStart);
+	const unsigned int uiGoalCluster = GetCluster(cNavGrid, uiGoal);
+	const unsigned int uiGoalX = cNavGrid.GetX(uiGoal);
+	const unsigned int uiGoalY = cNavGrid.GetY(uiGoal);
+
+	// The costs to the goal are found backwards from it, and the costs from the start are found last,
+	// so that the cost to the goal without leaving the cluster of the start is left in arrLocalDistances
+	SearchCluster(cNavGrid, uiGoalCluster, uiGoal, true, vecGoalCosts);
+	SearchCluster(cNavGrid, uiStartCluster, uiStart, false, vecStartCosts);
+	unsigned int uiDirectCost = COST_INFINITE;
+	if (uiStartCluster == uiGoalCluster)
+		uiDirectCost = GetLocalDistance(cNavGrid, uiStartCluster, uiGoal);
+
+	vecSearchNodes.clear();
+	vecOpenList.clear();
+	uiSearchGeneration++;
+	if (uiSearchGeneration == 0)
+	{
+		std::fill(arrSearchGeneration.begin(), arrSearchGeneration.end(), 0);
+		uiSearchGeneration = 1;
+	}
+	Relax(COST_INFINITE, uiStart, 0, uiGoalX, uiGoalY, cNavGrid);
+
+	while (!vecOpenList.empty())
+	{
+		std::pop_heap(vecOpenList.begin(), vecOpenList.end(), std::greater<std::pair<unsigned int, unsigned int>>());
+		const unsigned int uiCurrentNode = vecOpenList.back().second;
+		vecOpenList.pop_back();
+		if (vecSearchNodes[uiCurrentNode].bClosed)
+			continue;
+		vecSearchNodes[uiCurrentNode].bClosed = true;
+
+		const unsigned int uiCurrent = vecSearchNodes[uiCurrentNode].uiCell;
+		const unsigned int g = vecSearchNodes[uiCurrentNode].g;
+		if (uiCurrent == uiGoal)
+		{
+			for (unsigned int uiNode = uiCurrentNode; vecSearchNodes[uiNode].uiCell != uiStart; uiNode = vecSearchNodes[uiNode].uiParent)
+				vecWaypoints.push_back(vecSearchNodes[uiNode].uiCell);
+			std::reverse(vecWaypoints.begin(), vecWaypoints.end());
+			return true;
+		}
+
+		// The start moves to the entrance nodes of its cluster
+		if (uiCurrent == uiStart)
+		{
+			const Cluster& cluster = vecClusters[uiStartCluster];
+			for (unsigned int j = 0; j < cluster.vecNodeCells.size(); j++)
+			{
+				if (vecStartCosts[j] != COST_INFINITE)
+					Relax(uiCurrentNode, cluster.vecNodeCells[j], g + vecStartCosts[j], uiGoalX, uiGoalY, cNavGrid);
+			}
+			if (uiDirectCost != COST_INFINITE)
+				Relax(uiCurrentNode, uiGoal, g + uiDirectCost, uiGoalX, uiGoalY, cNavGrid);
+		}
+
+		// An entrance node moves to the other entrance nodes of its cluster, across its borders, and to the goal
+		const unsigned int uiCluster = GetCluster(cNavGrid, uiCurrent);
+		const Cluster& cluster = vecClusters[uiCluster];
+		const unsigned int uiNumNodes = cluster.vecNodeCells.size();
+		const unsigned int i = GetNodeIndex(cluster, uiCurrent);
+		if (i == uiNumNodes)
+			continue;
+		for (unsigned int j = 0; j < uiNumNodes; j++)
+		{
+			const unsigned int uiCost = cluster.arrCosts[i * uiNumNodes + j];
+			if ((j != i) && (uiCost != COST_INFINITE))
+				Relax(uiCurrentNode, cluster.vecNodeCells[j], g + uiCost, uiGoalX, uiGoalY, cNavGrid);
+		}
+		for (unsigned int j = 0; j < cluster.vecNodePartners[i].size(); j++)
+			Relax(uiCurrentNode, cluster.vecNodePartners[i][j].first, g + cluster.vecNodePartners[i][j].second, uiGoalX, uiGoalY, cNavGrid);
+		if ((uiCluster == uiGoalCluster) && (vecGoalCosts[i] != COST_INFINITE))
+			Relax(uiCurrentNode, uiGoal, g + vecGoalCosts[i], uiGoalX, uiGoalY, cNavGrid);
+	}
+
+	return false;
+}
+
+/**
+ @brief Refine the first part of a path through a list of waypoints into cells.
+		The waypoints are refined in order, until the path has at least a number of cells.
+		The path between 2 waypoints in a cluster is found with a search which stays in the cluster, 
+		as the costs between the entrance nodes were, so it only visits the cells of that cluster
+ @param cNavGrid A const CNavGrid& variable containing the cells and their edges
+ @param uiStart A const unsigned int variable containing the start cell
+ @param vecWaypoints A const std::vector<unsigned int>& variable containing the waypoints from FindAbstractPath()
+ @param uiMinCells A const unsigned int variable containing the number of cells to refine before stopping
+ @param vecPath A std::vector<unsigned int>& variable to store the cells of the path, excluding the start cell
+ */
+void CHPAStar::RefinePath(	const CNavGrid& cNavGrid,
+							const unsigned int uiStart,
+							const std::vector<unsigned int>& vecWaypoints,
+							const unsigned int uiMinCells,
+							std::vector<unsigned int>& vecPath)
+{
+	vecPath.clear();
+	unsigned int uiFrom = uiStart;
+	for (unsigned int i = 0; (i < vecWaypoints.size()) && (vecPath.size() < uiMinCells); i++)
+	{
+		const unsigned int uiTo = vecWaypoints[i];
+		if (GetCluster(cNavGrid, uiFrom) != GetCluster(cNavGrid, uiTo))
+		{
+			// A move across a border
+			vecPath.push_back(uiTo);
+		}
+		else
+		{
+			// A path within a cluster, followed down the costs to the waypoint
+			const unsigned int uiCluster = GetCluster(cNavGrid, uiTo);
+			SearchCluster(cNavGrid, uiCluster, uiTo, true, vecRefineNodeCosts);
+			if (!FollowLocalDistances(cNavGrid, uiCluster, uiFrom, vecPath))
+				return;
+		}
+		uiFrom = uiTo;
+	}
+}
+
+/**
+ @brief Get the number of clusters
+ */
+unsigned int CHPAStar::GetNumClusters(void) const
+{
+	return vecClusters.size();
+}
+
+/**
+ @brief Get the number of cells along each side of a cluster
+ */
+unsigned int CHPAStar::GetClusterSize(void) const
+{
+	return uiClusterSize;
+}
+
+/**
+ @brief Get the number of clusters which have been built since Init()
+ */
+unsigned int CHPAStar::GetNumClusterBuilds(void) const
+{
+	return uiNumClusterBuilds;
+}
+
+/**
+ @brief Mark a border to be rebuilt, and add it to its dirty list if it is not already marked
+ @param bVertical A const bool variable which is true for the border on the right of a cluster, or false for the border above it
+ @param uiBorder A const unsigned int variable containing the index of the border
+ */
+void CHPAStar::MarkBorderDirty(const bool bVertical, const unsigned int uiBorder)
+{
+	std::vector<bool>& vecBordersDirty = bVertical ? vecVerticalBordersDirty : vecHorizontalBordersDirty;
+	if (vecBordersDirty[uiBorder])
+		return;
+	vecBordersDirty[uiBorder] = true;
+	(bVertical ? vecDirtyVerticalBorders : vecDirtyHorizontalBorders).push_back(uiBorder);
+}
+
+/**
+ @brief Mark a cluster to be rebuilt, and add it to the dirty list if it is not already marked
+ @param uiCluster A const unsigned int variable containing the cluster
+ */
+void CHPAStar::MarkClusterDirty(const unsigned int uiCluster)
+{
+	if (vecClusters[uiCluster].bDirty)
+		return;
+	vecClusters[uiCluster].bDirty = true;
+	vecDirtyClusters.push_back(uiCluster);
+}
+
+/**
+ @brief Rebuild the borders and clusters in the dirty lists, so that a search after a few changes 
+		does not visit every border and cluster. 
+		The clusters on both sides of a rebuilt border are rebuilt, as their entrance nodes may have changed
+ */
+void CHPAStar::UpdateDirtyClusters(const CNavGrid& cNavGrid)
+{
+	for (unsigned int i = 0; i < vecDirtyVerticalBorders.size(); i++)
+	{
+		const unsigned int uiBorder = vecDirtyVerticalBorders[i];
+		BuildBorder(cNavGrid, true, uiBorder);
+		const unsigned int uiClusterX = uiBorder % (uiNumClustersX - 1);
+		const unsigned int uiClusterY = uiBorder / (uiNumClustersX - 1);
+		MarkClusterDirty(uiClusterY * uiNumClustersX + uiClusterX);
+		MarkClusterDirty(uiClusterY * uiNumClustersX + uiClusterX + 1);
+		vecVerticalBordersDirty[uiBorder] = false;
+	}
+	vecDirtyVerticalBorders.clear();
+	for (unsigned int i = 0; i < vecDirtyHorizontalBorders.size(); i++)
+	{
+		const unsigned int uiBorder = vecDirtyHorizontalBorders[i];
+		BuildBorder(cNavGrid, false, uiBorder);
+		MarkClusterDirty(uiBorder);
+		MarkClusterDirty(uiBorder + uiNumClustersX);
+		vecHorizontalBordersDirty[uiBorder] = false;
+	}
+	vecDirtyHorizontalBorders.clear();
+	for (unsigned int i = 0; i < vecDirtyClusters.size(); i++)
+		BuildCluster(cNavGrid, vecDirtyClusters[i]);
+	vecDirtyClusters.clear();
+}
+
+/**
+ @brief Build the transitions across a border. The pairs of cells across the border with edges between them are split 
+		into runs, in which each pair crosses in the same directions as the next, and the cells of each side can move 
+		to and from the next cell of that side along the border. A short run gets one transition at its middle, 
+		and a long run one at each end. Any crossing in a run can then be replaced by moving along the border 
+		to a transition of the run, so no path is lost, but the path found may cost a little more than the cheapest
+ @param cNavGrid A const CNavGrid& variable containing the cells and their edges
+ @param bVertical A const bool variable which is true for the border on the right of a cluster, or false for the border above it
+ @param uiBorder A const unsigned int variable containing the index of the border
+ */
+void CHPAStar::BuildBorder(const CNavGrid& cNavGrid, const bool bVertical, const unsigned int uiBorder)
+{
+	std::vector<Transition>& vecTransitions = bVertical ? vecVerticalBorders[uiBorder] : vecHorizontalBorders[uiBorder];
+	vecTransitions.clear();
+
+	// The first cell on side A of the border, the step along the border, the directions across and along it, and its length
+	unsigned int uiFirstCell = 0, uiStepAlong = 0, uiLength = 0;
+	unsigned int uiDirectionAB = 0, uiDirectionBA = 0, uiDirectionAlong = 0, uiDirectionBack = 0;
+	if (bVertical)
+	{
+		const unsigned int uiClusterX = uiBorder % (uiNumClustersX - 1);
+		const unsigned int uiClusterY = uiBorder / (uiNumClustersX - 1);
+		uiFirstCell = cNavGrid.GetCell((uiClusterX + 1) * uiClusterSize - 1, uiClusterY * uiClusterSize);
+		uiStepAlong = uiWidth;
+		uiLength = std::min(uiClusterSize, uiHeight - uiClusterY * uiClusterSize);
+		uiDirectionAB = CNavGrid::DIRECTION_RIGHT;
+		uiDirectionBA = CNavGrid::DIRECTION_LEFT;
+		uiDirectionAlong = CNavGrid::DIRECTION_UP;
+		uiDirectionBack = CNavGrid::DIRECTION_DOWN;
+	}
+	else
+	{
+		const unsigned int uiClusterX = uiBorder % uiNumClustersX;
+		const unsigned int uiClusterY = uiBorder / uiNumClustersX;
+		uiFirstCell = cNavGrid.GetCell(uiClusterX * uiClusterSize, (uiClusterY + 1) * uiClusterSize - 1);
+		uiStepAlong = 1;
+		uiLength = std::min(uiClusterSize, uiWidth - uiClusterX * uiClusterSize);
+		uiDirectionAB = CNavGrid::DIRECTION_UP;
+		uiDirectionBA = CNavGrid::DIRECTION_DOWN;
+		uiDirectionAlong = CNavGrid::DIRECTION_RIGHT;
+		uiDirectionBack = CNavGrid::DIRECTION_LEFT;
+	}
+
+	unsigned int uiRunStart = 0;
+	unsigned int uiRunCrossing = 0;
+	for (unsigned int i = 0; i <= uiLength; i++)
+	{
+		// The directions which the pair crosses in, with 1 for A to B and 2 for B to A, or 0 at the end of the border
+		unsigned int uiCrossing = 0;
+		unsigned int uiCellA = 0, uiCellB = 0;
+		if (i < uiLength)
+		{
+			uiCellA = uiFirstCell + i * uiStepAlong;
+			uiCellB = cNavGrid.GetNeighbour(uiCellA, uiDirectionAB);
+			uiCrossing = ((cNavGrid.GetEdges(uiCellA) & (1 << uiDirectionAB)) ? 1 : 0) |
+						 ((cNavGrid.GetEdges(uiCellB) & (1 << uiDirectionBA)) ? 2 : 0);
+		}
+
+		// The run goes on if this pair crosses in the same directions as the last, and both sides are joined along the border
+		if ((i < uiLength) && (i > uiRunStart) && (uiCrossing == uiRunCrossing) &&
+			(IsJoined(cNavGrid, uiCellA - uiStepAlong, uiDirectionAlong, uiDirectionBack)) &&
+			(IsJoined(cNavGrid, uiCellB - uiStepAlong, uiDirectionAlong, uiDirectionBack)))
+			continue;
+
+		// End the last run, and start a new run at this pair
+		if ((i > uiRunStart) && (uiRunCrossing != 0))
+		{
+			const unsigned int uiRunLength = i - uiRunStart;
+			if (uiRunLength < LONG_ENTRANCE_LENGTH)
+			{
+				AddTransition(cNavGrid, vecTransitions, uiFirstCell + (uiRunStart + uiRunLength / 2) * uiStepAlong, uiDirectionAB);
+			}
+			else
+			{
+				AddTransition(cNavGrid, vecTransitions, uiFirstCell + uiRunStart * uiStepAlong, uiDirectionAB);
+				AddTransition(cNavGrid, vecTransitions, uiFirstCell + (i - 1) * uiStepAlong, uiDirectionAB);
+			}
+		}
+		uiRunStart = i;
+		uiRunCrossing = uiCrossing;
+	}
+}
+
+/**
+ @brief Add the transition from a cell on side A of a border to the cell across it
+ @param cNavGrid A const CNavGrid& variable containing the cells
+ @param vecTransitions A std::vector<Transition>& variable containing the transitions of the border
+ @param uiCellA A const unsigned int variable containing the cell on side A
+ @param uiDirectionAB A const unsigned int variable containing the direction across the border from side A
+ */
+void CHPAStar::AddTransition(const CNavGrid& cNavGrid, std::vector<Transition>& vecTransitions, const unsigned int uiCellA, const unsigned int uiDirectionAB)
+{
+	Transition transition;
+	transition.uiCellA = uiCellA;
+	transition.uiCellB = cNavGrid.GetNeighbour(uiCellA, uiDirectionAB);
+	vecTransitions.push_back(transition);
+}
+
+/**
+ @brief Check if a cell and its neighbour in a direction can move to each other
+ @param cNavGrid A const CNavGrid& variable containing the cells and their edges
+ @param uiCell A const unsigned int variable containing the cell
+ @param uiDirection A const unsigned int variable containing the direction of the neighbour
+ @param uiOpposite A const unsigned int variable containing the direction back from the neighbour
+ */
+bool CHPAStar::IsJoined(const CNavGrid& cNavGrid, const unsigned int uiCell, const unsigned int uiDirection, const unsigned int uiOpposite) const
+{
+	return (cNavGrid.GetEdges(uiCell) & (1 << uiDirection)) &&
+		(cNavGrid.GetEdges(cNavGrid.GetNeighbour(uiCell, uiDirection)) & (1 << uiOpposite));
+}
+
+/**
+ @brief Build the entrance nodes of a cluster from the transitions across its 4 borders, 
+		and the cost of the cheapest path in the cluster between each pair of them
+ */
+void CHPAStar::BuildCluster(const CNavGrid& cNavGrid, const unsigned int uiCluster)
+{
+	Cluster& cluster = vecClusters[uiCluster];
+	cluster.vecNodeCells.clear();
+	cluster.vecNodePartners.clear();
+
+	const unsigned int uiClusterX = uiCluster % uiNumClustersX;
+	const unsigned int uiClusterY = uiCluster / uiNumClustersX;
+	if (uiClusterX > 0)
+	{
+		const std::vector<Transition>& vecLeft = vecVerticalBorders[uiClusterY * (uiNumClustersX - 1) + uiClusterX - 1];
+		for (unsigned int i = 0; i < vecLeft.size(); i++)
+			AddNode(cNavGrid, cluster, vecLeft[i].uiCellB, vecLeft[i].uiCellA);
+	}
+	if (uiClusterX + 1 < uiNumClustersX)
+	{
+		const std::vector<Transition>& vecRight = vecVerticalBorders[uiClusterY * (uiNumClustersX - 1) + uiClusterX];
+		for (unsigned int i = 0; i < vecRight.size(); i++)
+			AddNode(cNavGrid, cluster, vecRight[i].uiCellA, vecRight[i].uiCellB);
+	}
+	if (uiClusterY > 0)
+	{
+		const std::vector<Transition>& vecBelow = vecHorizontalBorders[(uiClusterY - 1) * uiNumClustersX + uiClusterX];
+		for (unsigned int i = 0; i < vecBelow.size(); i++)
+			AddNode(cNavGrid, cluster, vecBelow[i].uiCellB, vecBelow[i].uiCellA);
+	}
+	if (uiClusterY + 1 < uiNumClustersY)
+	{
+		const std::vector<Transition>& vecAbove = vecHorizontalBorders[uiClusterY * uiNumClustersX + uiClusterX];
+		for (unsigned int i = 0; i < vecAbove.size(); i++)
+			AddNode(cNavGrid, cluster, vecAbove[i].uiCellA, vecAbove[i].uiCellB);
+	}
+
+	const unsigned int uiNumNodes = cluster.vecNodeCells.size();
+	cluster.arrCosts.assign(uiNumNodes * uiNumNodes, COST_INFINITE);
+	std::vector<unsigned int> vecNodeCosts;
+	for (unsigned int i = 0; i < uiNumNodes; i++)
+	{
+		SearchCluster(cNavGrid, uiCluster, cluster.vecNodeCells[i], false, vecNodeCosts);
+		std::copy(vecNodeCosts.begin(), vecNodeCosts.end(), cluster.arrCosts.begin() + i * uiNumNodes);
+	}
+
+	cluster.bDirty = false;
+	uiNumClusterBuilds++;
+}
+
+/**
+ @brief Add an entrance node to a cluster for one side of a transition, if it is not already a node. 
+		The node is given the cell across the border as a partner, if it has an edge to it
+ @param cNavGrid A const CNavGrid& variable containing the cells and their edges
+ @param cluster A Cluster& variable containing the cluster
+ @param uiCell A const unsigned int variable containing the cell of the node
+ @param uiPartner A const unsigned int variable containing the cell across the border
+ */
+void CHPAStar::AddNode(const CNavGrid& cNavGrid, Cluster& cluster, const unsigned int uiCell, const unsigned int uiPartner)
+{
+	const unsigned int i = GetNodeIndex(cluster, uiCell);
+	if (i == cluster.vecNodeCells.size())
+	{
+		cluster.vecNodeCells.push_back(uiCell);
+		cluster.vecNodePartners.push_back(std::vector<std::pair<unsigned int, unsigned int>>());
+	}
+
+	const unsigned char ucEdges = cNavGrid.GetEdges(uiCell);
+	for (unsigned int uiDirection = 0; uiDirection < 4; uiDirection++)
+	{
+		if ((ucEdges & (1 << uiDirection)) && (cNavGrid.GetNeighbour(uiCell, uiDirection) == uiPartner))
+			cluster.vecNodePartners[i].push_back(std::make_pair(uiPartner, cNavGrid.GetEdgeCost(uiCell, uiDirection)));
+	}
+}
+
+/**
+ @brief Find the costs between a cell and the entrance nodes of its cluster, with a search which stays in the cluster.
+		The costs between the cell and all the cells of the cluster are left in arrLocalDistances
+ @param cNavGrid A const CNavGrid& variable containing the cells and their edges
+ @param uiCluster A const unsigned int variable containing the cluster of the cell
+ @param uiCell A const unsigned int variable containing the cell to search from
+ @param bReverse A const bool variable which is true to find the costs from the entrance nodes to the cell, 
+		or false to find the costs from the cell to the entrance nodes
+ @param vecNodeCosts A std::vector<unsigned int>& variable to store the cost for each entrance node
+ */
+void CHPAStar::SearchCluster(const CNavGrid& cNavGrid, const unsigned int uiCluster, const unsigned int uiCell, const bool bReverse, std::vector<unsigned int>& vecNodeCosts)
+{
+	const int iClusterX0 = (uiCluster % uiNumClustersX) * uiClusterSize;
+	const int iClusterY0 = (uiCluster / uiNumClustersX) * uiClusterSize;
+	const int iClusterWidth = std::min(uiClusterSize, uiWidth - iClusterX0);
+	const int iClusterHeight = std::min(uiClusterSize, uiHeight - iClusterY0);
+
+	std::fill(arrLocalDistances.begin(), arrLocalDistances.begin() + iClusterWidth * iClusterHeight, COST_INFINITE);
+	arrLocalDistances[(cNavGrid.GetY(uiCell) - iClusterY0) * iClusterWidth + (cNavGrid.GetX(uiCell) - iClusterX0)] = 0;
+	vecLocalQueue.clear();
+	vecLocalQueue.push_back(std::make_pair(0u, uiCell));
+
+	while (!vecLocalQueue.empty())
+	{
+		std::pop_heap(vecLocalQueue.begin(), vecLocalQueue.end(), std::greater<std::pair<unsigned int, unsigned int>>());
+		const unsigned int uiCurrent = vecLocalQueue.back().second;
+		const unsigned int uiCurrentDistance = vecLocalQueue.back().first;
+		vecLocalQueue.pop_back();
+		const int iX = cNavGrid.GetX(uiCurrent);
+		const int iY = cNavGrid.GetY(uiCurrent);
+		if (uiCurrentDistance > arrLocalDistances[(iY - iClusterY0) * iClusterWidth + (iX - iClusterX0)])
+			continue;
+
+		for (unsigned int uiDirection = 0; uiDirection < 4; uiDirection++)
+		{
+			// Forwards, follow the edges out of the current cell. Backwards, follow the edges of the neighbours into it
+			const int iNeighbourX = bReverse ? iX - CNavGrid::DIRECTION_X[uiDirection] : iX + CNavGrid::DIRECTION_X[uiDirection];
+			const int iNeighbourY = bReverse ? iY - CNavGrid::DIRECTION_Y[uiDirection] : iY + CNavGrid::DIRECTION_Y[uiDirection];
+			if ((iNeighbourX < iClusterX0) || (iNeighbourX >= iClusterX0 + iClusterWidth) || 
+				(iNeighbourY < iClusterY0) || (iNeighbourY >= iClusterY0 + iClusterHeight))
+				continue;
+			const unsigned int uiNeighbour = cNavGrid.GetCell(iNeighbourX, iNeighbourY);
+			const unsigned int uiEdgeFrom = bReverse ? uiNeighbour : uiCurrent;
+			if ((cNavGrid.GetEdges(uiEdgeFrom) & (1 << uiDirection)) == 0)
+				continue;
+
+			const unsigned int uiDistance = uiCurrentDistance + cNavGrid.GetEdgeCost(uiEdgeFrom, uiDirection);
+			unsigned int& uiNeighbourDistance = arrLocalDistances[(iNeighbourY - iClusterY0) * iClusterWidth + (iNeighbourX - iClusterX0)];
+			if (uiNeighbourDistance <= uiDistance)
+				continue;
+			uiNeighbourDistance = uiDistance;
+			vecLocalQueue.push_back(std::make_pair(uiDistance, uiNeighbour));
+			std::push_heap(vecLocalQueue.begin(), vecLocalQueue.end(), std::greater<std::pair<unsigned int, unsigned int>>());
+		}
+	}
+
+	const Cluster& cluster = vecClusters[uiCluster];
+	vecNodeCosts.resize(cluster.vecNodeCells.size());
+	for (unsigned int j = 0; j < cluster.vecNodeCells.size(); j++)
+		vecNodeCosts[j] = GetLocalDistance(cNavGrid, uiCluster, cluster.vecNodeCells[j]);
+}
+
+/**
+ @brief Get the cost between a cell in a cluster and the cell which the last call to SearchCluster() searched from
+ */
+unsigned int CHPAStar::GetLocalDistance(const CNavGrid& cNavGrid, const unsigned int uiCluster, const unsigned int uiCell) const
+{
+	const unsigned int uiClusterX0 = (uiCluster % uiNumClustersX) * uiClusterSize;
+	const unsigned int uiClusterY0 = (uiCluster / uiNumClustersX) * uiClusterSize;
+	const unsigned int uiClusterWidth = std::min(uiClusterSize, uiWidth - uiClusterX0);
+	return arrLocalDistances[(cNavGrid.GetY(uiCell) - uiClusterY0) * uiClusterWidth + (cNavGrid.GetX(uiCell) - uiClusterX0)];
+}
+
+/**
+ @brief Add the cells of the cheapest path in a cluster from a cell to the cell which the last backward call to SearchCluster() 
+		searched from, by moving along an edge whose cost is the drop in the cost to that cell at each step
+ @param cNavGrid A const CNavGrid& variable containing the cells and their edges
+ @param uiCluster A const unsigned int variable containing the cluster which was searched
+ @param uiCell A const unsigned int variable containing the cell to start from, which is not added
+ @param vecPath A std::vector<unsigned int>& variable to add the cells to
+ @return true if the path was found, or false if the cell cannot reach the searched cell in the cluster
+ */
+bool CHPAStar::FollowLocalDistances(const CNavGrid& cNavGrid, const unsigned int uiCluster, const unsigned int uiCell, std::vector<unsigned int>& vecPath) const
+{
+	unsigned int uiCurrent = uiCell;
+	unsigned int uiDistance = GetLocalDistance(cNavGrid, uiCluster, uiCurrent);
+	if (uiDistance == COST_INFINITE)
+		return false;
+
+	while (uiDistance > 0)
+	{
+		unsigned int uiNext = uiCurrent;
+		const unsigned char ucEdges = cNavGrid.GetEdges(uiCurrent);
+		for (unsigned int uiDirection = 0; uiDirection < 4; uiDirection++)
+		{
+			if ((ucEdges & (1 << uiDirection)) == 0)
+				continue;
+			const unsigned int uiNeighbour = cNavGrid.GetNeighbour(uiCurrent, uiDirection);
+			if (GetCluster(cNavGrid, uiNeighbour) != uiCluster)
+				continue;
+			const unsigned int uiNeighbourDistance = GetLocalDistance(cNavGrid, uiCluster, uiNeighbour);
+			if ((uiNeighbourDistance != COST_INFINITE) &&
+				(uiNeighbourDistance + cNavGrid.GetEdgeCost(uiCurrent, uiDirection) == uiDistance))
+			{
+				uiNext = uiNeighbour;
+				uiDistance = uiNeighbourDistance;
+				break;
+			}
+		}
+		if (uiNext == uiCurrent)
+			return false;
+		vecPath.push_back(uiNext);
+		uiCurrent = uiNext;
+	}
+	return true;
+}
+
+/**
+ @brief Get the cluster of a cell
+ */
+unsigned int CHPAStar::GetCluster(const CNavGrid& cNavGrid, const unsigned int uiCell) const
+{
+	return (cNavGrid.GetY(uiCell) / uiClusterSize) * uiNumClustersX + cNavGrid.GetX(uiCell) / uiClusterSize;
+}
+
+/**
+ @brief Get the index of the entrance node at a cell in a cluster, or the number of nodes if there is none
+ */
+unsigned int CHPAStar::GetNodeIndex(const Cluster& cluster, const unsigned int uiCell) const
+{
+	unsigned int i = 0;
+	while ((i < cluster.vecNodeCells.size()) && (cluster.vecNodeCells[i] != uiCell))
+		i++;
+	return i;
+}
+
+/**
+ @brief Get the search data of a cell in FindAbstractPath(), adding it if the cell has not been reached
+ */
+unsigned int CHPAStar::GetSearchNode(const unsigned int uiCell)
+{
+	if (arrSearchGeneration[uiCell] == uiSearchGeneration)
+		return arrSearchNodeOfCell[uiCell];
+
+	SearchNode node;
+	node.uiCell = uiCell;
+	node.g = COST_INFINITE;
+	node.uiParent = COST_INFINITE;
+	node.bClosed = false;
+	vecSearchNodes.push_back(node);
+	arrSearchGeneration[uiCell] = uiSearchGeneration;
+	arrSearchNodeOfCell[uiCell] = vecSearchNodes.size() - 1;
+	return vecSearchNodes.size() - 1;
+}
+
+/**
+ @brief Lower the cost of reaching a cell in FindAbstractPath(), and add it to the open list
+ @param uiFrom A const unsigned int variable containing the search node which the cell is reached from
+ @param uiCell A const unsigned int variable containing the cell
+ @param g A const unsigned int variable containing the cost from the start to the cell
+ */
+void CHPAStar::Relax(const unsigned int uiFrom, const unsigned int uiCell, const unsigned int g, const unsigned int uiGoalX, const unsigned int uiGoalY, const CNavGrid& cNavGrid)
+{
+	const unsigned int uiNode = GetSearchNode(uiCell);
+	SearchNode& node = vecSearchNodes[uiNode];
+	if ((node.bClosed) || (g >= node.g))
+		return;
+
+	node.g = g;
+	node.uiParent = uiFrom;
+	const unsigned int h = Heuristics::Manhattan::Get(	abs((int)cNavGrid.GetX(uiCell) - (int)uiGoalX),
+														abs((int)cNavGrid.GetY(uiCell) - (int)uiGoalY), 1);
+	vecOpenList.push_back(std::make_pair(g + h, uiNode));
+	std::push_heap(vecOpenList.begin(), vecOpenList.end(), std::greater<std::pair<unsigned int, unsigned int>>());
+}
@@ -0,0 +1,162 @@
+/**
+ CHPAStar
+ @brief Hierarchical path finding (HPA*) over a CNavGrid, for long paths on large maps.
+		The grid is divided into square clusters. Along each cluster border, the runs of cells which can cross it
+		get an entrance node at their middle, or at both ends of a long run, and the cost of the cheapest path 
+		between the entrance nodes of each cluster is precomputed. A long path is found by searching this small graph 
+		of entrance nodes, and only the first part of it is refined into cells, when it is needed. The path may cost
+		a little more than the cheapest, as it crosses each run at an entrance node.
+		The clusters are all built by Build() after Init(), e.g. when a map is loaded. When a cell changes, 
+		only its cluster, and the clusters across a border which it lies on, are rebuilt by the next search.
+		Only the 4 straight directions are supported.
+ By: JH Chong
+ Date: Aug 2022
+ */
+#pragma once
+
+// Include NavGrid
+#include "NavGrid.h"
+// Include Heuristics
+#include "Heuristics.h"
+
+#include <vector>
+#include <utility>
+
+class CHPAStar
+{
+public:
+	// Constructor
+	CHPAStar(void);
+
+	// Destructor
+	virtual ~CHPAStar(void);
+
+	// Init the clusters for the size of a grid, which are all marked to be built
+	void Init(const CNavGrid& cNavGrid, const unsigned int uiClusterSize = 16);
+
+	// Build the borders and clusters which are marked to be built, e.g. all of them after Init()
+	void Build(const CNavGrid& cNavGrid);
+
+	// Mark the clusters which depend on a cell to be rebuilt, after the cell changed
+	void OnCellChanged(const unsigned int uiX, const unsigned int uiY);
+
+	// Check if 2 cells are in the same cluster
+	bool IsSameCluster(const unsigned int uiCellA, const unsigned int uiCellB) const;
+
+	// Find the entrance nodes which a path from the start to the goal passes through
+	bool FindAbstractPath(	const CNavGrid& cNavGrid,
+							const unsigned int uiStart,
+							const unsigned int uiGoal,
+							std::vector<unsigned int>& vecWaypoints);
+
+	// Refine the first part of a path through a list of waypoints into cells
+	void RefinePath(const CNavGrid& cNavGrid,
+					const unsigned int uiStart,
+					const std::vector<unsigned int>& vecWaypoints,
+					const unsigned int uiMinCells,
+					std::vector<unsigned int>& vecPath);
+
+	// Get the number of clusters
+	unsigned int GetNumClusters(void) const;
+	// Get the size of the clusters
+	unsigned int GetClusterSize(void) const;
+	// Get the number of clusters which have been built since Init()
+	unsigned int GetNumClusterBuilds(void) const;
+
+protected:
+	// A pair of cells on either side of a border, with an edge between them in at least one direction, 
+	// which stands for the run of such pairs around it. Cell A is in the cluster to the left of or below the border
+	struct Transition
+	{
+		unsigned int uiCellA;
+		unsigned int uiCellB;
+	};
+
+	struct Cluster
+	{
+		// The cells of the entrance nodes in this cluster
+		std::vector<unsigned int> vecNodeCells;
+		// The cells in the neighbouring clusters which each entrance node has an edge to, and the cost of the edge
+		std::vector<std::vector<std::pair<unsigned int, unsigned int>>> vecNodePartners;
+		// The cost of the cheapest path in this cluster from each entrance node to each other, at [i * number of nodes + j]
+		std::vector<unsigned int> arrCosts;
+		bool bDirty;
+	};
+
+	// The search data of an entrance node in FindAbstractPath()
+	struct SearchNode
+	{
+		unsigned int uiCell;
+		unsigned int g;
+		unsigned int uiParent;
+		bool bClosed;
+	};
+
+	unsigned int uiClusterSize;
+	unsigned int uiWidth;
+	unsigned int uiHeight;
+	unsigned int uiNumClustersX;
+	unsigned int uiNumClustersY;
+	unsigned int uiNumClusterBuilds;
+
+	std::vector<Cluster> vecClusters;
+	// The transitions across the border on the right of each cluster, except the last column
+	std::vector<std::vector<Transition>> vecVerticalBorders;
+	std::vector<bool> vecVerticalBordersDirty;
+	// The transitions across the border above each cluster, except the last row
+	std::vector<std::vector<Transition>> vecHorizontalBorders;
+	std::vector<bool> vecHorizontalBordersDirty;
+	// The borders and clusters which have been marked, so that an update only visits them
+	std::vector<unsigned int> vecDirtyVerticalBorders;
+	std::vector<unsigned int> vecDirtyHorizontalBorders;
+	std::vector<unsigned int> vecDirtyClusters;
+
+	// The costs between a cell and the cells of its cluster, from the last call to SearchCluster()
+	std::vector<unsigned int> arrLocalDistances;
+	std::vector<std::pair<unsigned int, unsigned int>> vecLocalQueue;
+	// The costs from the start, and to the goal, of FindAbstractPath() for the entrance nodes of their clusters
+	std::vector<unsigned int> vecStartCosts;
+	std::vector<unsigned int> vecGoalCosts;
+	// The search data of FindAbstractPath(), and the index of the search data of each cell.
+	// The index of a cell is only valid if its generation is the generation of the current search
+	std::vector<SearchNode> vecSearchNodes;
+	std::vector<unsigned int> arrSearchNodeOfCell;
+	std::vector<unsigned int> arrSearchGeneration;
+	unsigned int uiSearchGeneration;
+	// The open list of FindAbstractPath(), as a heap of (f, search node) with the lowest f at the front.
+	// A node whose cost is lowered is pushed again, and the older entry is skipped when it is popped
+	std::vector<std::pair<unsigned int, unsigned int>> vecOpenList;
+
+	// The costs to the entrance nodes from the last search of RefinePath(), which are not used
+	std::vector<unsigned int> vecRefineNodeCosts;
+
+	// Mark a border or a cluster to be rebuilt, and add it to its dirty list
+	void MarkBorderDirty(const bool bVertical, const unsigned int uiBorder);
+	void MarkClusterDirty(const unsigned int uiCluster);
+	// Rebuild the borders and clusters which have been marked
+	void UpdateDirtyClusters(const CNavGrid& cNavGrid);
+	// Build the transitions across a border, one or two for each run of cells which can cross it
+	void BuildBorder(const CNavGrid& cNavGrid, const bool bVertical, const unsigned int uiBorder);
+	// Add the transition from a cell on side A of a border to the cell across it
+	void AddTransition(const CNavGrid& cNavGrid, std::vector<Transition>& vecTransitions, const unsigned int uiCellA, const unsigned int uiDirectionAB);
+	// Check if a cell and its neighbour in a direction can move to each other
+	bool IsJoined(const CNavGrid& cNavGrid, const unsigned int uiCell, const unsigned int uiDirection, const unsigned int uiOpposite) const;
+	// Build the entrance nodes of a cluster and the costs between them
+	void BuildCluster(const CNavGrid& cNavGrid, const unsigned int uiCluster);
+	// Add an entrance node to a cluster for one side of a transition
+	void AddNode(const CNavGrid& cNavGrid, Cluster& cluster, const unsigned int uiCell, const unsigned int uiPartner);
+	// Find the costs between a cell and the entrance nodes of its cluster, staying in the cluster
+	void SearchCluster(const CNavGrid& cNavGrid, const unsigned int uiCluster, const unsigned int uiCell, const bool bReverse, std::vector<unsigned int>& vecNodeCosts);
+	// Get the cost between a cell in a cluster and the cell which the last call to SearchCluster() searched from
+	unsigned int GetLocalDistance(const CNavGrid& cNavGrid, const unsigned int uiCluster, const unsigned int uiCell) const;
+	// Add the cells of the cheapest path in a cluster from a cell to the cell which the last backward call to SearchCluster() searched from
+	bool FollowLocalDistances(const CNavGrid& cNavGrid, const unsigned int uiCluster, const unsigned int uiCell, std::vector<unsigned int>& vecPath) const;
+	// Get the cluster of a cell
+	unsigned int GetCluster(const CNavGrid& cNavGrid, const unsigned int uiCell) const;
+	// Get the index of the entrance node at a cell in a cluster, or the number of nodes if there is none
+	unsigned int GetNodeIndex(const Cluster& cluster, const unsigned int uiCell) const;
+	// Get the search data of a cell in FindAbstractPath()
+	unsigned int GetSearchNode(const unsigned int uiCell);
+	// Lower the cost of reaching a cell in FindAbstractPath()
+	void Relax(const unsigned int uiFrom, const unsigned int uiCell, const unsigned int g, const unsigned int uiGoalX, const unsigned int uiGoalY, const CNavGrid& cNavGrid);
+};
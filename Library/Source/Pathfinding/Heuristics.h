@@ -0,0 +1,90 @@
+/**
+ Heuristics
+ @brief The heuristics which estimate the cost between 2 cells for path finding.
+		The estimates are in the units of CNavGrid::EDGE_COSTS, and never more than the cheapest moves
+		between the cells, so that a search with a weight of 1 finds the cheapest path.
+		Each heuristic is a type, so that CAStar::Search() is compiled for the heuristic 
+		and can inline it, instead of calling it through a function pointer for every neighbour.
+ By: JH Chong
+ Date: Aug 2022
+ */
+#pragma once
+
+// Include NavGrid
+#include "NavGrid.h"
+
+#include <cmath>
+#include <cstdlib>
+
+namespace Heuristics
+{
+	// The sum of the distances along each axis, for 4 directions
+	struct Manhattan
+	{
+		static inline unsigned int Get(const int iDX, const int iDY, const int iWeight)
+		{
+			return static_cast<unsigned int>(iWeight * (int)CNavGrid::COST_STRAIGHT * (iDX + iDY));
+		}
+	};
+
+	// The straight line distance
+	struct Euclidean
+	{
+		static inline unsigned int Get(const int iDX, const int iDY, const int iWeight)
+		{
+			return static_cast<unsigned int>(iWeight * (int)CNavGrid::COST_STRAIGHT * sqrtf(static_cast<float>(iDX * iDX + iDY * iDY)));
+		}
+	};
+
+	// The distance when moving diagonally costs CNavGrid::COST_DIAGONAL, for 8 directions.
+	// This is the cheapest that the moves can be, as no move costs less than walking across flat ground
+	struct Octile
+	{
+		static inline unsigned int Get(const int iDX, const int iDY, const int iWeight)
+		{
+			const int iMin = (iDX < iDY) ? iDX : iDY;
+			const int iMax = (iDX < iDY) ? iDY : iDX;
+			return static_cast<unsigned int>(iWeight * ((int)CNavGrid::COST_STRAIGHT * iMax +
+														(int)(CNavGrid::COST_DIAGONAL - CNavGrid::COST_STRAIGHT) * iMin));
+		}
+	};
+
+	// No estimate, which turns the search into Dijkstra's algorithm
+	struct Zero
+	{
+		static inline unsigned int Get(const int, const int, const int)
+		{
+			return 0;
+		}
+	};
+
+	/**
+	 @brief A function object which estimates the cost from a cell of a CNavGrid to a goal, 
+			using one of the heuristics above
+	 */
+	template <typename Distance>
+	class CGoalHeuristic
+	{
+	public:
+		CGoalHeuristic(const CNavGrid& cNavGrid, const int iGoalX, const int iGoalY, const int iWeight)
+			: cNavGrid(cNavGrid)
+			, iGoalX(iGoalX)
+			, iGoalY(iGoalY)
+			, iWeight(iWeight)
+		{
+		}
+
+		inline unsigned int operator()(const unsigned int uiCell) const
+		{
+			return Distance::Get(	abs(static_cast<int>(cNavGrid.GetX(uiCell)) - iGoalX),
+									abs(static_cast<int>(cNavGrid.GetY(uiCell)) - iGoalY),
+									iWeight);
+		}
+
+	protected:
+		const CNavGrid& cNavGrid;
+		const int iGoalX;
+		const int iGoalY;
+		const int iWeight;
+	};
+}
@@ -0,0 +1,290 @@
+/**
+ CNavGrid
+ @brief A navigation graph over a grid of cells, for path finding on a platformer map.
+		Each cell has a type, and the moves out of each cell are built from the types of the cell 
+		and its neighbours as explicit walk, climb and fall edges, each with a cost. 
+		A search reads one bit mask and a few costs per cell, instead of looking up the tiles around 
+		every neighbour, and only finds moves which an entity can make.
+		The edges are kept up to date as cells change, by updating only the edges into and out of the changed cell.
+		This class does not depend on OpenGL, so it can be used by tools as well as the game.
+ By: JH Chong
+ Date: Aug 2022
+ */
+#include "NavGrid.h"
+
+const int CNavGrid::DIRECTION_X[CNavGrid::NUM_DIRECTIONS] = { -1, 1, 0, 0, -1, 1, -1, 1 };
+const int CNavGrid::DIRECTION_Y[CNavGrid::NUM_DIRECTIONS] = { 0, 0, 1, -1, -1, 1, 1, -1 };
+// Climbing is slower than walking or falling
+const unsigned int CNavGrid::EDGE_COSTS[CNavGrid::NUM_EDGE_TYPES] = { 0, COST_STRAIGHT, 2 * COST_STRAIGHT, COST_STRAIGHT };
+
+/**
+ @brief Constructor
+ */
+CNavGrid::CNavGrid(void)
+	: uiWidth(0)
+	, uiHeight(0)
+	, uiRevision(0)
+	, uiInitRevision(0)
+{
+	for (unsigned int uiDirection = 0; uiDirection < NUM_DIRECTIONS; uiDirection++)
+		arrNeighbourOffsets[uiDirection] = 0;
+}
+
+/**
+ @brief Destructor
+ */
+CNavGrid::~CNavGrid(void)
+{
+}
+
+/**
+ @brief Init the grid with all cells blocked
+ @param uiWidth A const unsigned int variable containing the number of columns
+ @param uiHeight A const unsigned int variable containing the number of rows
+ */
+void CNavGrid::Init(const unsigned int uiWidth, const unsigned int uiHeight)
+{
+	this->uiWidth = uiWidth;
+	this->uiHeight = uiHeight;
+	arrCellTypes.assign(uiWidth * uiHeight, CELL_BLOCKED);
+	arrPenalties.assign(uiWidth * uiHeight, 0);
+	arrEdges.assign(uiWidth * uiHeight, 0);
+	arrEdgeCosts.assign(uiWidth * uiHeight * NUM_DIRECTIONS, 0);
+	for (unsigned int uiDirection = 0; uiDirection < NUM_DIRECTIONS; uiDirection++)
+		arrNeighbourOffsets[uiDirection] = DIRECTION_Y[uiDirection] * (int)uiWidth + DIRECTION_X[uiDirection];
+	arrChangeLog.assign(CHANGE_LOG_SIZE, 0);
+	uiRevision++;
+	uiInitRevision = uiRevision;
+}
+
+/**
+ @brief Set the type of a cell, and the extra cost of entering it. 
+		The edges out of the cell, and the edges of its neighbours into it, are updated
+ @param uiX A const unsigned int variable containing the column of the cell
+ @param uiY A const unsigned int variable containing the row of the cell
+ @param eType A const CELL_TYPE variable containing the type of the cell
+ @param uiPenalty A const unsigned int variable containing the extra cost of entering the cell, in the units of EDGE_COSTS
+ */
+void CNavGrid::SetCell(const unsigned int uiX, const unsigned int uiY, const CELL_TYPE eType, const unsigned int uiPenalty)
+{
+	const unsigned int uiCell = GetCell(uiX, uiY);
+	if ((arrCellTypes[uiCell] == eType) && (arrPenalties[uiCell] == uiPenalty))
+		return;
+	arrCellTypes[uiCell] = eType;
+	arrPenalties[uiCell] = uiPenalty;
+
+	for (unsigned int uiDirection = 0; uiDirection < NUM_DIRECTIONS; uiDirection++)
+	{
+		UpdateEdge(uiX, uiY, uiDirection);
+
+		// The neighbour reaches this cell by moving in the opposite direction
+		const int iX = (int)uiX + DIRECTION_X[uiDirection];
+		const int iY = (int)uiY + DIRECTION_Y[uiDirection];
+		if ((iX >= 0) && (iX < (int)uiWidth) && (iY >= 0) && (iY < (int)uiHeight))
+			UpdateEdge(iX, iY, uiDirection ^ 1);
+	}
+	uiRevision++;
+	arrChangeLog[uiRevision % CHANGE_LOG_SIZE] = uiCell;
+}
+
+/**
+ @brief Get the type of a cell
+ */
+CNavGrid::CELL_TYPE CNavGrid::GetCellType(const unsigned int uiCell) const
+{
+	return (CELL_TYPE)arrCellTypes[uiCell];
+}
+
+/**
+ @brief Check if a cell can be entered
+ */
+bool CNavGrid::IsPassable(const unsigned int uiCell) const
+{
+	return arrCellTypes[uiCell] != CELL_BLOCKED;
+}
+
+/**
+ @brief Get the type of the move in a direction between 2 types of cell.
+		An entity in the air can only fall. Otherwise it can walk sideways onto a cell which can be stood in, 
+		or step off a ledge into the air. It can climb up and down where either cell has a ladder, 
+		and climb up onto a cell which can be stood in. It can move diagonally between cells which can be stood in
+ @param eFrom A const CELL_TYPE variable containing the type of the cell to move from
+ @param eTo A const CELL_TYPE variable containing the type of the cell to move to
+ @param uiDirection A const unsigned int variable containing the direction of the move
+ @return The type of the move, or EDGE_NONE if it cannot be made
+ */
+CNavGrid::EDGE_TYPE CNavGrid::GetEdgeType(const CELL_TYPE eFrom, const CELL_TYPE eTo, const unsigned int uiDirection)
+{
+	if ((eFrom == CELL_BLOCKED) || (eTo == CELL_BLOCKED))
+		return EDGE_NONE;
+
+	switch (uiDirection)
+	{
+	case DIRECTION_DOWN:
+		if ((eFrom == CELL_AIR) || (eTo == CELL_AIR))
+			return EDGE_FALL;
+		if ((eFrom == CELL_LADDER) || (eTo == CELL_LADDER))
+			return EDGE_CLIMB;
+		return EDGE_FALL;
+	case DIRECTION_UP:
+		if ((eFrom == CELL_AIR) || (eTo == CELL_AIR))
+			return EDGE_NONE;
+		return EDGE_CLIMB;
+	case DIRECTION_LEFT:
+	case DIRECTION_RIGHT:
+		if (eFrom == CELL_AIR)
+			return EDGE_NONE;
+		return EDGE_WALK;
+	default:
+		if ((eFrom == CELL_AIR) || (eTo == CELL_AIR))
+			return EDGE_NONE;
+		return EDGE_WALK;
+	}
+}
+
+/**
+ @brief Get the cost of a move of a type in a direction, without the penalty of the cell which it enters.
+		A diagonal move costs as much as walking sideways and its vertical part, less the difference between 
+		2 straight moves and COST_DIAGONAL. A diagonal across flat ground costs COST_DIAGONAL, 
+		and going straight up by diagonal steps costs more than climbing a ladder
+ @param eEdgeType A const EDGE_TYPE variable containing the type of the move
+ @param uiDirection A const unsigned int variable containing the direction of the move
+ @return The cost of the move
+ */
+unsigned int CNavGrid::GetMoveCost(const EDGE_TYPE eEdgeType, const unsigned int uiDirection)
+{
+	if (eEdgeType == EDGE_NONE)
+		return 0;
+	if (uiDirection < DIRECTION_DOWN_LEFT)
+		return EDGE_COSTS[eEdgeType];
+
+	// The vertical part of a diagonal up is a climb, and of a diagonal down is a fall
+	const EDGE_TYPE eVertical = (DIRECTION_Y[uiDirection] > 0) ? EDGE_CLIMB : EDGE_FALL;
+	return EDGE_COSTS[EDGE_WALK] + EDGE_COSTS[eVertical] - (2 * COST_STRAIGHT - COST_DIAGONAL);
+}
+
+/**
+ @brief Get the number of columns
+ */
+unsigned int CNavGrid::GetWidth(void) const
+{
+	return uiWidth;
+}
+
+/**
+ @brief Get the number of rows
+ */
+unsigned int CNavGrid::GetHeight(void) const
+{
+	return uiHeight;
+}
+
+/**
+ @brief Get the number of cells
+ */
+unsigned int CNavGrid::GetNumCells(void) const
+{
+	return uiWidth * uiHeight;
+}
+
+/**
+ @brief Get the number of times that the edges have been changed
+ */
+unsigned int CNavGrid::GetRevision(void) const
+{
+	return uiRevision;
+}
+
+/**
+ @brief Get the cells which have been changed since a revision, so that a search can update only what they affect. 
+		A cell which changed more than once is listed once for each change
+ @param uiSinceRevision A const unsigned int variable containing the revision to list the changes after
+ @param vecCells A std::vector<unsigned int>& variable to store the changed cells, oldest first
+ @return true if all the changes are known, or false if the grid was initialised again since the revision, 
+		or there are more changes than CHANGE_LOG_SIZE
+ */
+bool CNavGrid::GetChangedCells(const unsigned int uiSinceRevision, std::vector<unsigned int>& vecCells) const
+{
+	vecCells.clear();
+	if ((uiSinceRevision < uiInitRevision) || (uiSinceRevision > uiRevision) ||
+		(uiRevision - uiSinceRevision > CHANGE_LOG_SIZE))
+		return false;
+
+	for (unsigned int uiChange = uiSinceRevision + 1; uiChange <= uiRevision; uiChange++)
+		vecCells.push_back(arrChangeLog[uiChange % CHANGE_LOG_SIZE]);
+	return true;
+}
+
+/**
+ @brief Bring this grid, an earlier copy of another grid, up to the revision of the other grid. 
+		Only the cells which changed since the revision of this grid, and the edges of their neighbours into them, 
+		are copied, so this costs much less than copying the whole grid after a few changes
+ @param cSource A const CNavGrid& variable containing the grid which this grid was copied from
+ @return true if this grid was brought up to date, or false if the changes are not known, 
+		in which case the whole grid has to be copied
+ */
+bool CNavGrid::CopyChangesFrom(const CNavGrid& cSource)
+{
+	if ((uiWidth != cSource.uiWidth) || (uiHeight != cSource.uiHeight) || (uiInitRevision != cSource.uiInitRevision) ||
+		(!cSource.GetChangedCells(uiRevision, vecCopiedCells)))
+		return false;
+
+	for (unsigned int i = 0; i < vecCopiedCells.size(); i++)
+	{
+		const unsigned int uiCell = vecCopiedCells[i];
+		arrCellTypes[uiCell] = cSource.arrCellTypes[uiCell];
+		arrPenalties[uiCell] = cSource.arrPenalties[uiCell];
+
+		// The edges out of the cell, and out of each neighbour, which may lead into the cell
+		const int iX = (int)GetX(uiCell);
+		const int iY = (int)GetY(uiCell);
+		for (int iNeighbourY = iY - 1; iNeighbourY <= iY + 1; iNeighbourY++)
+		{
+			for (int iNeighbourX = iX - 1; iNeighbourX <= iX + 1; iNeighbourX++)
+			{
+				if ((iNeighbourX < 0) || (iNeighbourX >= (int)uiWidth) || (iNeighbourY < 0) || (iNeighbourY >= (int)uiHeight))
+					continue;
+				const unsigned int uiNeighbour = GetCell(iNeighbourX, iNeighbourY);
+				arrEdges[uiNeighbour] = cSource.arrEdges[uiNeighbour];
+				for (unsigned int uiDirection = 0; uiDirection < NUM_DIRECTIONS; uiDirection++)
+					arrEdgeCosts[uiNeighbour * NUM_DIRECTIONS + uiDirection] = cSource.arrEdgeCosts[uiNeighbour * NUM_DIRECTIONS + uiDirection];
+			}
+		}
+	}
+
+	// The change log is copied too, so that a search of this grid can find what changed since its last search
+	arrChangeLog = cSource.arrChangeLog;
+	uiRevision = cSource.uiRevision;
+	return true;
+}
+
+/**
+ @brief Build the edge out of a cell in a direction, from the types of the cell and its neighbour
+ @param uiX A const unsigned int variable containing the column of the cell
+ @param uiY A const unsigned int variable containing the row of the cell
+ @param uiDirection A const unsigned int variable containing the direction of the edge
+ */
+void CNavGrid::UpdateEdge(const unsigned int uiX, const unsigned int uiY, const unsigned int uiDirection)
+{
+	const unsigned int uiCell = GetCell(uiX, uiY);
+	const unsigned char ucEdge = 1 << uiDirection;
+
+	const int iX = (int)uiX + DIRECTION_X[uiDirection];
+	const int iY = (int)uiY + DIRECTION_Y[uiDirection];
+	EDGE_TYPE eEdgeType = EDGE_NONE;
+	if ((iX >= 0) && (iX < (int)uiWidth) && (iY >= 0) && (iY < (int)uiHeight))
+		eEdgeType = GetEdgeType((CELL_TYPE)arrCellTypes[uiCell], (CELL_TYPE)arrCellTypes[GetCell(iX, iY)], uiDirection);
+
+	if (eEdgeType == EDGE_NONE)
+	{
+		arrEdges[uiCell] &= ~ucEdge;
+		arrEdgeCosts[uiCell * NUM_DIRECTIONS + uiDirection] = 0;
+	}
+	else
+	{
+		// The costs are stored in a byte each, so a large penalty is capped
+		const unsigned int uiCost = GetMoveCost(eEdgeType, uiDirection) + arrPenalties[GetCell(iX, iY)];
+		arrEdges[uiCell] |= ucEdge;
+		arrEdgeCosts[uiCell * NUM_DIRECTIONS + uiDirection] = (uiCost < 0xFF) ? uiCost : 0xFF;
+	}
+}
@@ -0,0 +1,162 @@
+/**
+ CNavGrid
+ @brief A navigation graph over a grid of cells, for path finding on a platformer map.
+		Each cell has a type, and the moves out of each cell are built from the types of the cell 
+		and its neighbours as explicit walk, climb and fall edges, each with a cost. 
+		A search reads one bit mask and a few costs per cell, instead of looking up the tiles around 
+		every neighbour, and only finds moves which an entity can make.
+		The edges are kept up to date as cells change, by updating only the edges into and out of the changed cell.
+		This class does not depend on OpenGL, so it can be used by tools as well as the game.
+ By: JH Chong
+ Date: Aug 2022
+ */
+#pragma once
+
+#include <vector>
+
+class CNavGrid
+{
+public:
+	// The directions to the neighbours of a cell. The first 4 directions are the straight moves.
+	// Each direction is followed by its opposite, so the opposite of a direction is (eDirection ^ 1)
+	enum DIRECTION
+	{
+		DIRECTION_LEFT = 0,
+		DIRECTION_RIGHT,
+		DIRECTION_UP,
+		DIRECTION_DOWN,
+		DIRECTION_DOWN_LEFT,
+		DIRECTION_UP_RIGHT,
+		DIRECTION_UP_LEFT,
+		DIRECTION_DOWN_RIGHT,
+		NUM_DIRECTIONS
+	};
+	// The change in x and y of a move in each direction
+	static const int DIRECTION_X[NUM_DIRECTIONS];
+	static const int DIRECTION_Y[NUM_DIRECTIONS];
+
+	// The types of cell
+	enum CELL_TYPE
+	{
+		// A cell which cannot be entered
+		CELL_BLOCKED = 0,
+		// A cell which cannot be stood in, so an entity in it falls
+		CELL_AIR,
+		// A cell which can be stood in
+		CELL_STANDABLE,
+		// A cell with a ladder, which can be climbed up and down
+		CELL_LADDER,
+		NUM_CELL_TYPES
+	};
+
+	// The types of move between 2 cells
+	enum EDGE_TYPE
+	{
+		EDGE_NONE = 0,
+		// A move sideways, including stepping off a ledge
+		EDGE_WALK,
+		// A move up or down a ladder, or up onto a cell which can be stood in
+		EDGE_CLIMB,
+		// A move down through a cell which cannot be stood in
+		EDGE_FALL,
+		NUM_EDGE_TYPES
+	};
+
+	// The cost of each type of move in a straight direction. The costs are scaled by COST_STRAIGHT,
+	// so that a diagonal move can cost about the square root of 2 times a straight move in whole numbers
+	static const unsigned int EDGE_COSTS[NUM_EDGE_TYPES];
+	// The cost of walking one cell straight, and diagonally across flat ground
+	static const unsigned int COST_STRAIGHT = 10;
+	static const unsigned int COST_DIAGONAL = 14;
+
+	// The number of the latest changed cells which are remembered, see GetChangedCells()
+	static const unsigned int CHANGE_LOG_SIZE = 256;
+
+	// Constructor
+	CNavGrid(void);
+
+	// Destructor
+	virtual ~CNavGrid(void);
+
+	// Init the grid with all cells blocked
+	void Init(const unsigned int uiWidth, const unsigned int uiHeight);
+
+	// Set the type of a cell, and the extra cost of entering it in the units of EDGE_COSTS, and update the edges into and out of it
+	void SetCell(const unsigned int uiX, const unsigned int uiY, const CELL_TYPE eType, const unsigned int uiPenalty = 0);
+	// Get the type of a cell
+	CELL_TYPE GetCellType(const unsigned int uiCell) const;
+	// Check if a cell can be entered
+	bool IsPassable(const unsigned int uiCell) const;
+
+	// Get the type of the move in a direction between 2 types of cell
+	static EDGE_TYPE GetEdgeType(const CELL_TYPE eFrom, const CELL_TYPE eTo, const unsigned int uiDirection);
+	// Get the cost of a move of a type in a direction, without the penalty of the cell which it enters
+	static unsigned int GetMoveCost(const EDGE_TYPE eEdgeType, const unsigned int uiDirection);
+
+	// Get the size of the grid
+	unsigned int GetWidth(void) const;
+	unsigned int GetHeight(void) const;
+	unsigned int GetNumCells(void) const;
+
+	// Get the number of times that the edges have been changed
+	unsigned int GetRevision(void) const;
+	// Get the cells which have been changed since a revision
+	bool GetChangedCells(const unsigned int uiSinceRevision, std::vector<unsigned int>& vecCells) const;
+	// Bring this grid, an earlier copy of another grid, up to the revision of the other grid by copying only the changed cells
+	bool CopyChangesFrom(const CNavGrid& cSource);
+
+	// Get the index of a cell
+	inline unsigned int GetCell(const unsigned int uiX, const unsigned int uiY) const
+	{
+		return uiY * uiWidth + uiX;
+	}
+	// Get the x and y of a cell
+	inline unsigned int GetX(const unsigned int uiCell) const
+	{
+		return uiCell % uiWidth;
+	}
+	inline unsigned int GetY(const unsigned int uiCell) const
+	{
+		return uiCell / uiWidth;
+	}
+	// Get the outgoing edges of a cell, as a bit mask of DIRECTION
+	inline unsigned char GetEdges(const unsigned int uiCell) const
+	{
+		return arrEdges[uiCell];
+	}
+	// Get the cost of the edge out of a cell in a direction. The cell must have an edge in this direction
+	inline unsigned int GetEdgeCost(const unsigned int uiCell, const unsigned int uiDirection) const
+	{
+		return arrEdgeCosts[uiCell * NUM_DIRECTIONS + uiDirection];
+	}
+	// Get the neighbour of a cell in a direction. The cell must have an edge in this direction
+	inline unsigned int GetNeighbour(const unsigned int uiCell, const unsigned int uiDirection) const
+	{
+		return uiCell + arrNeighbourOffsets[uiDirection];
+	}
+
+protected:
+	unsigned int uiWidth;
+	unsigned int uiHeight;
+	unsigned int uiRevision;
+	// The revision of the last call to Init()
+	unsigned int uiInitRevision;
+
+	// The type of each cell, as a CELL_TYPE
+	std::vector<unsigned char> arrCellTypes;
+	// The extra cost of entering each cell, e.g. for a cell which hurts
+	std::vector<unsigned char> arrPenalties;
+	// The outgoing edges of each cell, as a bit mask of DIRECTION
+	std::vector<unsigned char> arrEdges;
+	// The cost of the outgoing edge of each cell in each direction, at [uiCell * NUM_DIRECTIONS + uiDirection]
+	std::vector<unsigned char> arrEdgeCosts;
+	// The cell which was changed by each of the latest revisions, at [revision % CHANGE_LOG_SIZE]
+	std::vector<unsigned int> arrChangeLog;
+	// The change in cell index of a move in each direction
+	int arrNeighbourOffsets[NUM_DIRECTIONS];
+	// The changed cells read by CopyChangesFrom()
+	std::vector<unsigned int> vecCopiedCells;
+
+	// Build the edge out of a cell in a direction
+	void UpdateEdge(const unsigned int uiX, const unsigned int uiY, const unsigned int uiDirection);
+};
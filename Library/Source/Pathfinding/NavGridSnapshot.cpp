@@ -0,0 +1,100 @@
+/**
+ CNavGridSnapshot
+ @brief Read-only copies of a CNavGrid for searches on other threads, such as the requests of a CPathJobQueue.
+		A copy is shared by all the requests made while the grid is unchanged. When the grid changes,
+		a copy which no request holds any more is brought up to date by copying only the cells which changed,
+		so the game thread does not copy the whole grid after every edit.
+		Usually only 2 copies are needed: the one which the workers are searching and the one which is being updated.
+ By: JH Chong
+ Date: Aug 2022
+ */
+#include "NavGridSnapshot.h"
+
+/**
+ @brief Constructor
+ */
+CNavGridSnapshot::CNavGridSnapshot(void)
+	: pIdleCopies(std::make_shared<IdleCopies>())
+	, uiNumFullCopies(0)
+	, uiNumUpdates(0)
+{
+}
+
+/**
+ @brief Destructor. The copies which are still held by requests are deleted when they are released
+ */
+CNavGridSnapshot::~CNavGridSnapshot(void)
+{
+}
+
+/**
+ @brief Get a copy of a grid at its current revision.
+		The latest copy is returned if the grid has not changed since it was made. Otherwise an idle copy
+		is updated with the changed cells, or the whole grid is copied if there is no idle copy or too much has changed
+ @param cNavGrid A const CNavGrid& variable containing the grid
+ @return The copy, which must not be changed
+ */
+std::shared_ptr<const CNavGrid> CNavGridSnapshot::Get(const CNavGrid& cNavGrid)
+{
+	if ((pLatest) && (pLatest->GetRevision() == cNavGrid.GetRevision()))
+		return pLatest;
+
+	// Release the latest copy first, so that it is idle if no request holds it
+	pLatest.reset();
+
+	std::unique_ptr<CNavGrid> pCopy;
+	{
+		std::lock_guard<std::mutex> lock(pIdleCopies->mutexCopies);
+		if (!pIdleCopies->vecCopies.empty())
+		{
+			pCopy = std::move(pIdleCopies->vecCopies.back());
+			pIdleCopies->vecCopies.pop_back();
+		}
+	}
+
+	if ((pCopy) && (pCopy->CopyChangesFrom(cNavGrid)))
+	{
+		uiNumUpdates++;
+	}
+	else
+	{
+		if (pCopy)
+			*pCopy = cNavGrid;
+		else
+			pCopy.reset(new CNavGrid(cNavGrid));
+		uiNumFullCopies++;
+	}
+
+	// The copy goes back to the idle copies when the last request which holds it is done with it
+	std::shared_ptr<IdleCopies> pIdle = pIdleCopies;
+	pLatest = std::shared_ptr<const CNavGrid>(pCopy.release(), [pIdle](const CNavGrid* pGrid)
+	{
+		std::lock_guard<std::mutex> lock(pIdle->mutexCopies);
+		pIdle->vecCopies.push_back(std::unique_ptr<CNavGrid>(const_cast<CNavGrid*>(pGrid)));
+	});
+	return pLatest;
+}
+
+/**
+ @brief Release the latest copy, e.g. when the grid has been initialised again
+ */
+void CNavGridSnapshot::Clear(void)
+{
+	pLatest.reset();
+}
+
+/**
+ @brief Get the number of copies which were made of the whole grid
+ */
+unsigned int CNavGridSnapshot::GetNumFullCopies(void) const
+{
+	return uiNumFullCopies;
+}
+
+/**
+ @brief Get the number of copies which were updated with the changed cells only
+ */
+unsigned int CNavGridSnapshot::GetNumUpdates(void) const
+{
+	return uiNumUpdates;
+}
@@ -0,0 +1,53 @@
+/**
+ CNavGridSnapshot
+ @brief Read-only copies of a CNavGrid for searches on other threads, such as the requests of a CPathJobQueue.
+		A copy is shared by all the requests made while the grid is unchanged. When the grid changes,
+		a copy which no request holds any more is brought up to date by copying only the cells which changed,
+		so the game thread does not copy the whole grid after every edit.
+		Usually only 2 copies are needed: the one which the workers are searching and the one which is being updated.
+ By: JH Chong
+ Date: Aug 2022
+ */
+#pragma once
+
+// Include NavGrid
+#include "NavGrid.h"
+
+#include <vector>
+#include <memory>
+#include <mutex>
+
+class CNavGridSnapshot
+{
+public:
+	// Constructor
+	CNavGridSnapshot(void);
+
+	// Destructor
+	virtual ~CNavGridSnapshot(void);
+
+	// Get a copy of a grid at its current revision
+	std::shared_ptr<const CNavGrid> Get(const CNavGrid& cNavGrid);
+
+	// Release the latest copy, e.g. when the grid has been initialised again
+	void Clear(void);
+
+	// Get the number of copies which were made of the whole grid, and which were updated with the changed cells only
+	unsigned int GetNumFullCopies(void) const;
+	unsigned int GetNumUpdates(void) const;
+
+protected:
+	// The copies which no request holds. A copy is put back here by the thread which releases it last,
+	// which may be a worker, so this is shared with the copies and outlives this class if they do
+	struct IdleCopies
+	{
+		std::mutex mutexCopies;
+		std::vector<std::unique_ptr<CNavGrid>> vecCopies;
+	};
+
+	std::shared_ptr<IdleCopies> pIdleCopies;
+	// The copy which is given to the requests until the grid changes
+	std::shared_ptr<const CNavGrid> pLatest;
+	unsigned int uiNumFullCopies;
+	unsigned int uiNumUpdates;
+};
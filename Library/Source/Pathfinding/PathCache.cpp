@@ -0,0 +1,155 @@
+/**
+ CPathCache
+ @brief A cache of the paths found in a CNavGrid, so that entities which need the same path 
+		in the same frame share one search. A cached path is also reused by an entity whose start 
+		cell lies on a path to the same goal, by returning the part of the path after that cell.
+		The cache is cleared when the revision of the grid changes, so a path is never reused 
+		after a cell along it has become blocked.
+ By: JH Chong
+ Date: Aug 2022
+ */
+#include "PathCache.h"
+
+/**
+ @brief Constructor
+ */
+CPathCache::CPathCache(void)
+	: uiRevision(0)
+	, uiUseCounter(0)
+	, uiNumHits(0)
+	, uiNumMisses(0)
+{
+	vecEntries.reserve(MAX_ENTRIES);
+}
+
+/**
+ @brief Destructor
+ */
+CPathCache::~CPathCache(void)
+{
+}
+
+/**
+ @brief Set the revision of the grid, clearing the cache if it has changed
+ @param uiRevision A const unsigned int variable containing the revision of the grid
+ */
+void CPathCache::SetRevision(const unsigned int uiRevision)
+{
+	if (this->uiRevision == uiRevision)
+		return;
+	this->uiRevision = uiRevision;
+	vecEntries.clear();
+}
+
+/**
+ @brief Find the result of a search in the cache. 
+		A path found from another start is reused if the start of this search lies on it and the path ends at the goal, 
+		since the rest of that path leads from this start to the goal
+ @param key A const Key& variable containing the search
+ @param bFound A bool& variable to store if the goal can be reached
+ @param vecPath A std::vector<unsigned int>& variable to store the cells of the path, excluding the start cell
+ @return true if the search was found in the cache, otherwise false
+ */
+bool CPathCache::Find(const Key& key, bool& bFound, std::vector<unsigned int>& vecPath)
+{
+	for (unsigned int i = 0; i < vecEntries.size(); i++)
+	{
+		Entry& entry = vecEntries[i];
+		if (!IsSameSearch(entry.key, key))
+			continue;
+
+		if (entry.key.uiStart == key.uiStart)
+		{
+			bFound = entry.bFound;
+			vecPath = entry.vecPath;
+			entry.uiLastUsed = ++uiUseCounter;
+			uiNumHits++;
+			return true;
+		}
+
+		// Only a path which ends at the goal is reused from another start. A path which only leads part of the way, 
+		// such as the first refined part of a hierarchical path, would otherwise give an empty path to its last cell
+		if ((!entry.bFound) || (entry.vecPath.empty()) || (entry.vecPath.back() != key.uiGoal))
+			continue;
+		for (unsigned int j = 0; j < entry.vecPath.size(); j++)
+		{
+			if (entry.vecPath[j] == key.uiStart)
+			{
+				bFound = true;
+				vecPath.assign(entry.vecPath.begin() + j + 1, entry.vecPath.end());
+				entry.uiLastUsed = ++uiUseCounter;
+				uiNumHits++;
+				return true;
+			}
+		}
+	}
+
+	uiNumMisses++;
+	return false;
+}
+
+/**
+ @brief Add the result of a search to the cache, replacing the least recently used path if the cache is full
+ @param key A const Key& variable containing the search
+ @param bFound A const bool variable which is true if the goal can be reached
+ @param vecPath A const std::vector<unsigned int>& variable containing the cells of the path, excluding the start cell
+ */
+void CPathCache::Add(const Key& key, const bool bFound, const std::vector<unsigned int>& vecPath)
+{
+	Entry* pEntry = NULL;
+	if (vecEntries.size() < MAX_ENTRIES)
+	{
+		vecEntries.push_back(Entry());
+		pEntry = &vecEntries.back();
+	}
+	else
+	{
+		pEntry = &vecEntries[0];
+		for (unsigned int i = 1; i < vecEntries.size(); i++)
+		{
+			if (vecEntries[i].uiLastUsed < pEntry->uiLastUsed)
+				pEntry = &vecEntries[i];
+		}
+	}
+
+	pEntry->key = key;
+	pEntry->bFound = bFound;
+	if (bFound)
+		pEntry->vecPath = vecPath;
+	else
+		pEntry->vecPath.clear();
+	pEntry->uiLastUsed = ++uiUseCounter;
+}
+
+/**
+ @brief Remove all the paths from the cache
+ */
+void CPathCache::Clear(void)
+{
+	vecEntries.clear();
+}
+
+/**
+ @brief Get the number of searches which were found in the cache
+ */
+unsigned int CPathCache::GetNumHits(void) const
+{
+	return uiNumHits;
+}
+
+/**
+ @brief Get the number of searches which were not found in the cache
+ */
+unsigned int CPathCache::GetNumMisses(void) const
+{
+	return uiNumMisses;
+}
+
+/**
+ @brief Check if 2 searches have the same goal and settings, ignoring their start cells
+ */
+bool CPathCache::IsSameSearch(const Key& a, const Key& b) const
+{
+	return (a.uiGoal == b.uiGoal) && (a.uiHeuristic == b.uiHeuristic) &&
+		(a.iWeight == b.iWeight) && (a.uiNumDirections == b.uiNumDirections);
+}
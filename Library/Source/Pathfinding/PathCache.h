@@ -0,0 +1,74 @@
+/**
+ CPathCache
+ @brief A cache of the paths found in a CNavGrid, so that entities which need the same path 
+		in the same frame share one search. A cached path is also reused by an entity whose start 
+		cell lies on a path to the same goal, by returning the part of the path after that cell.
+		The cache is cleared when the revision of the grid changes, so a path is never reused 
+		after a cell along it has become blocked.
+ By: JH Chong
+ Date: Aug 2022
+ */
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+class CPathCache
+{
+public:
+	// The search which produced a path
+	struct Key
+	{
+		unsigned int uiStart;
+		unsigned int uiGoal;
+		// Identifies the heuristic, e.g. the address of the heuristic function
+		size_t uiHeuristic;
+		int iWeight;
+		unsigned int uiNumDirections;
+	};
+
+	// The maximum number of paths in the cache
+	static const unsigned int MAX_ENTRIES = 64;
+
+	// Constructor
+	CPathCache(void);
+
+	// Destructor
+	virtual ~CPathCache(void);
+
+	// Set the revision of the grid, clearing the cache if it has changed
+	void SetRevision(const unsigned int uiRevision);
+
+	// Find the result of a search in the cache
+	bool Find(const Key& key, bool& bFound, std::vector<unsigned int>& vecPath);
+
+	// Add the result of a search to the cache
+	void Add(const Key& key, const bool bFound, const std::vector<unsigned int>& vecPath);
+
+	// Remove all the paths from the cache
+	void Clear(void);
+
+	// Get the number of searches which were found in the cache, and which were not
+	unsigned int GetNumHits(void) const;
+	unsigned int GetNumMisses(void) const;
+
+protected:
+	struct Entry
+	{
+		Key key;
+		bool bFound;
+		// The cells of the path, excluding the start cell
+		std::vector<unsigned int> vecPath;
+		// The value of uiUseCounter when this entry was last used
+		unsigned int uiLastUsed;
+	};
+
+	std::vector<Entry> vecEntries;
+	unsigned int uiRevision;
+	unsigned int uiUseCounter;
+	unsigned int uiNumHits;
+	unsigned int uiNumMisses;
+
+	// Check if an entry was produced by a search with the same goal and settings as a key
+	bool IsSameSearch(const Key& a, const Key& b) const;
+};
@@ -0,0 +1,277 @@
+/**
+ CPathJobQueue
+ @brief Runs path finding requests on a pool of worker threads, so that a slow search does not stall a frame.
+		Each request searches a read-only snapshot of a CNavGrid, which the game can keep changing meanwhile, 
+		with either the search data of its worker or a CDStarLite shared with the requester. 
+		A result is published by the first call to BeginFrame() after its search finishes, 
+		so it is always delivered on a later frame than the one which submitted it, and never part way through a frame.
+ By: JH Chong
+ Date: Aug 2022
+ */
+#include "PathJobQueue.h"
+
+// Include Heuristics
+#include "Heuristics.h"
+
+#include <algorithm>
+
+/**
+ @brief Constructor
+ */
+CPathJobQueue::CPathJobQueue(void)
+	: bStopping(false)
+	, uiNextJobID(JOB_NONE + 1)
+{
+}
+
+/**
+ @brief Destructor
+ */
+CPathJobQueue::~CPathJobQueue(void)
+{
+	Destroy();
+}
+
+/**
+ @brief Start the worker threads
+ @param uiNumWorkers A const unsigned int variable containing the number of workers, 
+		or 0 to start one for each hardware thread except the one running the game
+ */
+void CPathJobQueue::Init(const unsigned int uiNumWorkers)
+{
+	Destroy();
+
+	unsigned int uiWorkers = uiNumWorkers;
+	if (uiWorkers == 0)
+	{
+		const unsigned int uiHardwareThreads = std::thread::hardware_concurrency();
+		uiWorkers = (uiHardwareThreads > 1) ? uiHardwareThreads - 1 : 1;
+	}
+
+	bStopping = false;
+	for (unsigned int i = 0; i < uiWorkers; i++)
+		vecWorkers.push_back(std::thread(&CPathJobQueue::RunWorker, this));
+}
+
+/**
+ @brief Stop the worker threads, after they finish the searches which they are running. 
+		The requests which have not been delivered are dropped
+ */
+void CPathJobQueue::Destroy(void)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutexJobs);
+		bStopping = true;
+		dequeWaitingJobs.clear();
+	}
+	cvJobSubmitted.notify_all();
+
+	for (unsigned int i = 0; i < vecWorkers.size(); i++)
+		vecWorkers[i].join();
+	vecWorkers.clear();
+
+	setRunningJobs.clear();
+	setRunningPlanners.clear();
+	setCancelledJobs.clear();
+	mapFinishedResults.clear();
+	mapPublishedResults.clear();
+}
+
+/**
+ @brief Submit a request for a path from the start to the goal
+ @param pNavGrid A const std::shared_ptr<const CNavGrid>& variable containing the snapshot of the grid to search, 
+		which must not be changed after it is submitted
+ @param uiStart A const unsigned int variable containing the start cell
+ @param uiGoal A const unsigned int variable containing the goal cell
+ @param uiNumDirections A const unsigned int variable containing the number of directions to move in, 4 or 8
+ @param pPlanner A const std::shared_ptr<CDStarLite>& variable containing the planner of the requester, to repair its last path, 
+		or NULL to search with A*. The requester must not use it while IsPlannerBusy() is true
+ @return The ID of the request, or JOB_NONE if there are no workers
+ */
+unsigned int CPathJobQueue::Submit(	const std::shared_ptr<const CNavGrid>& pNavGrid,
+									const unsigned int uiStart,
+									const unsigned int uiGoal,
+									const unsigned int uiNumDirections,
+									const std::shared_ptr<CDStarLite>& pPlanner)
+{
+	if ((vecWorkers.empty()) || (!pNavGrid))
+		return JOB_NONE;
+
+	Job job;
+	job.pNavGrid = pNavGrid;
+	job.uiStart = uiStart;
+	job.uiGoal = uiGoal;
+	job.uiNumDirections = uiNumDirections;
+	job.pPlanner = pPlanner;
+	{
+		std::lock_guard<std::mutex> lock(mutexJobs);
+		job.uiID = uiNextJobID++;
+		if (uiNextJobID == JOB_NONE)
+			uiNextJobID++;
+		dequeWaitingJobs.push_back(job);
+	}
+	cvJobSubmitted.notify_one();
+	return job.uiID;
+}
+
+/**
+ @brief Cancel a request, so that its result is never delivered. 
+		If a worker is searching it, the request is marked so that its result is dropped when the search finishes, 
+		and this returns without waiting. The worker keeps its share of the planner of the request until then, 
+		so the requester may drop the planner, or check IsPlannerBusy() before using it again
+ @param uiJob A const unsigned int variable containing the ID of the request
+ */
+void CPathJobQueue::Cancel(const unsigned int uiJob)
+{
+	if (uiJob == JOB_NONE)
+		return;
+
+	std::lock_guard<std::mutex> lock(mutexJobs);
+	for (std::deque<Job>::iterator it = dequeWaitingJobs.begin(); it != dequeWaitingJobs.end(); ++it)
+	{
+		if (it->uiID == uiJob)
+		{
+			dequeWaitingJobs.erase(it);
+			return;
+		}
+	}
+
+	if (setRunningJobs.count(uiJob) > 0)
+		setCancelledJobs.insert(uiJob);
+
+	mapFinishedResults.erase(uiJob);
+	mapPublishedResults.erase(uiJob);
+}
+
+/**
+ @brief Check if a planner is used by a request which is waiting or being searched, including a request 
+		which was cancelled while it was being searched
+ @param pPlanner A const CDStarLite* variable containing the planner
+ @return true if the planner must not be used yet, otherwise false
+ */
+bool CPathJobQueue::IsPlannerBusy(const CDStarLite* pPlanner) const
+{
+	if (pPlanner == NULL)
+		return false;
+
+	std::lock_guard<std::mutex> lock(mutexJobs);
+	if (setRunningPlanners.count(pPlanner) > 0)
+		return true;
+	for (unsigned int i = 0; i < dequeWaitingJobs.size(); i++)
+	{
+		if (dequeWaitingJobs[i].pPlanner.get() == pPlanner)
+			return true;
+	}
+	return false;
+}
+
+/**
+ @brief Publish the results of the requests which have finished since the last call. Call this once at the start of each frame
+ */
+void CPathJobQueue::BeginFrame(void)
+{
+	std::lock_guard<std::mutex> lock(mutexJobs);
+	for (std::map<unsigned int, Result>::iterator it = mapFinishedResults.begin(); it != mapFinishedResults.end(); ++it)
+	{
+		Result& published = mapPublishedResults[it->first];
+		published.bFound = it->second.bFound;
+		published.vecPath.swap(it->second.vecPath);
+	}
+	mapFinishedResults.clear();
+}
+
+/**
+ @brief Take the result of a request, if it has been published
+ @param uiJob A const unsigned int variable containing the ID of the request
+ @param vecPath A std::vector<unsigned int>& variable to store the cells of the path, excluding the start cell
+ @return The state of the request. The path is only stored if it is JOB_FOUND, and the result cannot be taken again
+ */
+CPathJobQueue::JOB_STATUS CPathJobQueue::GetResult(const unsigned int uiJob, std::vector<unsigned int>& vecPath)
+{
+	std::lock_guard<std::mutex> lock(mutexJobs);
+	std::map<unsigned int, Result>::iterator it = mapPublishedResults.find(uiJob);
+	if (it != mapPublishedResults.end())
+	{
+		const bool bFound = it->second.bFound;
+		vecPath.swap(it->second.vecPath);
+		mapPublishedResults.erase(it);
+		return bFound ? JOB_FOUND : JOB_NOT_FOUND;
+	}
+
+	if ((setRunningJobs.count(uiJob) > 0) || (mapFinishedResults.count(uiJob) > 0))
+		return JOB_PENDING;
+	for (unsigned int i = 0; i < dequeWaitingJobs.size(); i++)
+	{
+		if (dequeWaitingJobs[i].uiID == uiJob)
+			return JOB_PENDING;
+	}
+	return JOB_UNKNOWN;
+}
+
+/**
+ @brief Get the number of workers
+ */
+unsigned int CPathJobQueue::GetNumWorkers(void) const
+{
+	return vecWorkers.size();
+}
+
+/**
+ @brief Get the number of requests which have not been delivered yet
+ */
+unsigned int CPathJobQueue::GetNumPending(void) const
+{
+	std::lock_guard<std::mutex> lock(mutexJobs);
+	return dequeWaitingJobs.size() + setRunningJobs.size() + mapFinishedResults.size() + mapPublishedResults.size();
+}
+
+/**
+ @brief The loop of each worker thread, which searches the waiting requests in the order they were submitted
+ */
+void CPathJobQueue::RunWorker(void)
+{
+	// The search data of this worker, which is reused by all its searches
+	CAStar cAStar;
+	Result result;
+
+	std::unique_lock<std::mutex> lock(mutexJobs);
+	for (;;)
+	{
+		cvJobSubmitted.wait(lock, [this] { return bStopping || !dequeWaitingJobs.empty(); });
+		if (bStopping)
+			return;
+
+		Job job = dequeWaitingJobs.front();
+		dequeWaitingJobs.pop_front();
+		setRunningJobs.insert(job.uiID);
+		if (job.pPlanner)
+			setRunningPlanners.insert(job.pPlanner.get());
+		lock.unlock();
+
+		const CNavGrid& cNavGrid = *job.pNavGrid;
+		if (job.pPlanner)
+		{
+			result.bFound = job.pPlanner->Plan(cNavGrid, job.uiStart, job.uiGoal, job.uiNumDirections, result.vecPath);
+		}
+		else if (job.uiNumDirections == 8)
+		{
+			Heuristics::CGoalHeuristic<Heuristics::Octile> heuristic(cNavGrid, cNavGrid.GetX(job.uiGoal), cNavGrid.GetY(job.uiGoal), 1);
+			result.bFound = cAStar.Search<8>(cNavGrid, job.uiStart, job.uiGoal, heuristic, result.vecPath);
+		}
+		else
+		{
+			Heuristics::CGoalHeuristic<Heuristics::Manhattan> heuristic(cNavGrid, cNavGrid.GetX(job.uiGoal), cNavGrid.GetY(job.uiGoal), 1);
+			result.bFound = cAStar.Search<4>(cNavGrid, job.uiStart, job.uiGoal, heuristic, result.vecPath);
+		}
+
+		// The shares of the grid and the planner are released under the lock, 
+		// so a requester which sees that the planner is not busy can use it at once
+		lock.lock();
+		setRunningJobs.erase(job.uiID);
+		setRunningPlanners.erase(job.pPlanner.get());
+		if (setCancelledJobs.erase(job.uiID) == 0)
+			mapFinishedResults[job.uiID] = result;
+		job.pPlanner.reset();
+		job.pNavGrid.reset();
+	}
+}
@@ -0,0 +1,126 @@
+/**
+ CPathJobQueue
+ @brief Runs path finding requests on a pool of worker threads, so that a slow search does not stall a frame.
+		Each request searches a read-only snapshot of a CNavGrid, which the game can keep changing meanwhile, 
+		with either the search data of its worker or a CDStarLite shared with the requester. 
+		A result is published by the first call to BeginFrame() after its search finishes, 
+		so it is always delivered on a later frame than the one which submitted it, and never part way through a frame.
+ By: JH Chong
+ Date: Aug 2022
+ */
+#pragma once
+
+// Include NavGrid
+#include "NavGrid.h"
+// Include AStar
+#include "AStar.h"
+// Include DStarLite
+#include "DStarLite.h"
+
+#include <vector>
+#include <deque>
+#include <map>
+#include <set>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+class CPathJobQueue
+{
+public:
+	// The state of a request, as seen by the requester
+	enum JOB_STATUS
+	{
+		// The request was never submitted, has been cancelled, or its result has already been taken
+		JOB_UNKNOWN = 0,
+		// The request is waiting, being searched, or its result has not been published yet
+		JOB_PENDING,
+		// The goal was reached
+		JOB_FOUND,
+		// The goal cannot be reached
+		JOB_NOT_FOUND
+	};
+
+	// The ID which is never given to a request
+	static const unsigned int JOB_NONE = 0;
+
+	// Constructor
+	CPathJobQueue(void);
+
+	// Destructor
+	virtual ~CPathJobQueue(void);
+
+	// Start the worker threads. 0 workers starts one for each hardware thread, except the one running the game
+	void Init(const unsigned int uiNumWorkers = 0);
+
+	// Stop the worker threads, dropping the requests which have not been searched
+	void Destroy(void);
+
+	// Submit a request for a path from the start to the goal
+	unsigned int Submit(const std::shared_ptr<const CNavGrid>& pNavGrid,
+						const unsigned int uiStart,
+						const unsigned int uiGoal,
+						const unsigned int uiNumDirections,
+						const std::shared_ptr<CDStarLite>& pPlanner = std::shared_ptr<CDStarLite>());
+
+	// Cancel a request, so that its result is never delivered. This does not wait for a search which is running
+	void Cancel(const unsigned int uiJob);
+
+	// Check if a planner is used by a request which is waiting or being searched, including a cancelled one
+	bool IsPlannerBusy(const CDStarLite* pPlanner) const;
+
+	// Publish the results of the requests which have finished since the last call
+	void BeginFrame(void);
+
+	// Take the result of a request, if it has been published
+	JOB_STATUS GetResult(const unsigned int uiJob, std::vector<unsigned int>& vecPath);
+
+	// Get the number of workers
+	unsigned int GetNumWorkers(void) const;
+	// Get the number of requests which have not been delivered yet
+	unsigned int GetNumPending(void) const;
+
+protected:
+	struct Job
+	{
+		unsigned int uiID;
+		std::shared_ptr<const CNavGrid> pNavGrid;
+		unsigned int uiStart;
+		unsigned int uiGoal;
+		unsigned int uiNumDirections;
+		// The planner of the requester, or NULL to search with A*. 
+		// It is shared so that a request which is cancelled while it is searched keeps its planner until it finishes
+		std::shared_ptr<CDStarLite> pPlanner;
+	};
+
+	struct Result
+	{
+		bool bFound;
+		std::vector<unsigned int> vecPath;
+	};
+
+	std::vector<std::thread> vecWorkers;
+	bool bStopping;
+	unsigned int uiNextJobID;
+
+	// Guards all the members below
+	mutable std::mutex mutexJobs;
+	// Signalled when a request is submitted, or the workers are stopping
+	std::condition_variable cvJobSubmitted;
+	// The requests which are waiting for a worker
+	std::deque<Job> dequeWaitingJobs;
+	// The requests which are being searched by a worker
+	std::set<unsigned int> setRunningJobs;
+	// The planners of the requests which are being searched
+	std::set<const CDStarLite*> setRunningPlanners;
+	// The requests which have been cancelled while being searched
+	std::set<unsigned int> setCancelledJobs;
+	// The results which have finished since the last call to BeginFrame()
+	std::map<unsigned int, Result> mapFinishedResults;
+	// The results which have been published, and are waiting to be taken by the requesters
+	std::map<unsigned int, Result> mapPublishedResults;
+
+	// The loop of each worker thread
+	void RunWorker(void);
+};
@@ -0,0 +1,342 @@
+/**
+ CReachability
+ @brief Which cells of a CNavGrid can reach which, so that a search for a goal which cannot be reached 
+		can fail at once, instead of expanding every cell which the start can reach.
+		The cells are labelled with their strongly connected components: every cell in a component can reach 
+		every other cell in it. Falls are one way, so a component can also reach the components below it, 
+		which is found from the graph of components, and remembered for the latest goals.
+		When cells change, the labels are updated without a rebuild unless a new cell or a new cycle appears. 
+		Edges which are removed are left in the labels, so a goal may be reported as reachable when it is not, 
+		and the search finds out, but a reachable goal is never reported as unreachable
+ By: JH Chong
+ Date: Aug 2022
+ */
+#include "Reachability.h"
+
+#include <algorithm>
+
+/**
+ @brief Constructor
+ */
+CReachability::CReachability(void)
+	: uiNumComponents(0)
+	, bBuilt(false)
+	, uiGridRevision(0)
+	, uiNumDirections(4)
+{
+}
+
+/**
+ @brief Destructor
+ */
+CReachability::~CReachability(void)
+{
+}
+
+/**
+ @brief Label the components of a grid with Tarjan's algorithm, without recursion so that large maps do not overflow the stack. 
+		Tarjan's algorithm completes a component after all the components which it can reach, 
+		so every edge between 2 components goes from a higher number to a lower number
+ @param cNavGrid A const CNavGrid& variable containing the cells and their edges
+ @param uiNumDirections A const unsigned int variable containing the number of directions to move in, 4 or 8
+ */
+void CReachability::Build(const CNavGrid& cNavGrid, const unsigned int uiNumDirections)
+{
+	const unsigned int uiNumCells = cNavGrid.GetNumCells();
+	const unsigned int INDEX_NONE = 0xFFFFFFFF;
+
+	arrIndices.assign(uiNumCells, INDEX_NONE);
+	arrLowLinks.resize(uiNumCells);
+	arrOnStack.assign(uiNumCells, 0);
+	vecCellStack.clear();
+	vecSearchStack.clear();
+
+	arrComponents.assign(uiNumCells, static_cast<unsigned int>(COMPONENT_NONE));
+	uiNumComponents = 0;
+	unsigned int uiNextIndex = 0;
+
+	for (unsigned int uiRoot = 0; uiRoot < uiNumCells; uiRoot++)
+	{
+		if ((!cNavGrid.IsPassable(uiRoot)) || (arrIndices[uiRoot] != INDEX_NONE))
+			continue;
+
+		arrIndices[uiRoot] = arrLowLinks[uiRoot] = uiNextIndex++;
+		vecCellStack.push_back(uiRoot);
+		arrOnStack[uiRoot] = 1;
+		vecSearchStack.push_back(std::make_pair(uiRoot, 0u));
+
+		while (!vecSearchStack.empty())
+		{
+			const unsigned int uiCell = vecSearchStack.back().first;
+			const unsigned int uiDirection = vecSearchStack.back().second;
+			if (uiDirection < uiNumDirections)
+			{
+				vecSearchStack.back().second++;
+				if ((cNavGrid.GetEdges(uiCell) & (1 << uiDirection)) == 0)
+					continue;
+
+				const unsigned int uiNeighbour = cNavGrid.GetNeighbour(uiCell, uiDirection);
+				if (arrIndices[uiNeighbour] == INDEX_NONE)
+				{
+					arrIndices[uiNeighbour] = arrLowLinks[uiNeighbour] = uiNextIndex++;
+					vecCellStack.push_back(uiNeighbour);
+					arrOnStack[uiNeighbour] = 1;
+					vecSearchStack.push_back(std::make_pair(uiNeighbour, 0u));
+				}
+				else if (arrOnStack[uiNeighbour])
+				{
+					arrLowLinks[uiCell] = std::min(arrLowLinks[uiCell], arrIndices[uiNeighbour]);
+				}
+				continue;
+			}
+
+			// All the edges of the cell have been searched
+			vecSearchStack.pop_back();
+			if (!vecSearchStack.empty())
+			{
+				const unsigned int uiParent = vecSearchStack.back().first;
+				arrLowLinks[uiParent] = std::min(arrLowLinks[uiParent], arrLowLinks[uiCell]);
+			}
+
+			// The cell is the first cell found in its component, so the cells above it on the stack are the component
+			if (arrLowLinks[uiCell] == arrIndices[uiCell])
+			{
+				unsigned int uiMember = 0;
+				do
+				{
+					uiMember = vecCellStack.back();
+					vecCellStack.pop_back();
+					arrOnStack[uiMember] = 0;
+					arrComponents[uiMember] = uiNumComponents;
+				} while (uiMember != uiCell);
+				uiNumComponents++;
+			}
+		}
+	}
+
+	// Build the edges between the components, backwards, so that the components which reach a goal can be found
+	arrPredecessorOffsets.assign(uiNumComponents + 1, 0);
+	for (int iPass = 0; iPass < 2; iPass++)
+	{
+		for (unsigned int uiCell = 0; uiCell < uiNumCells; uiCell++)
+		{
+			const unsigned int uiComponent = arrComponents[uiCell];
+			if (uiComponent == COMPONENT_NONE)
+				continue;
+			const unsigned char ucEdges = cNavGrid.GetEdges(uiCell);
+			for (unsigned int uiDirection = 0; uiDirection < uiNumDirections; uiDirection++)
+			{
+				if ((ucEdges & (1 << uiDirection)) == 0)
+					continue;
+				const unsigned int uiNeighbourComponent = arrComponents[cNavGrid.GetNeighbour(uiCell, uiDirection)];
+				if (uiNeighbourComponent == uiComponent)
+					continue;
+
+				// The first pass counts the edges into each component, and the second pass stores them
+				if (iPass == 0)
+					arrPredecessorOffsets[uiNeighbourComponent + 1]++;
+				else
+					arrPredecessors[vecStack[uiNeighbourComponent]++] = uiComponent;
+			}
+		}
+
+		if (iPass == 0)
+		{
+			for (unsigned int i = 0; i < uiNumComponents; i++)
+				arrPredecessorOffsets[i + 1] += arrPredecessorOffsets[i];
+			arrPredecessors.resize(arrPredecessorOffsets[uiNumComponents]);
+			// The next free entry of each component
+			vecStack.assign(arrPredecessorOffsets.begin(), arrPredecessorOffsets.end() - 1);
+		}
+	}
+
+	arrLabelledEdges.resize(uiNumCells);
+	for (unsigned int uiCell = 0; uiCell < uiNumCells; uiCell++)
+		arrLabelledEdges[uiCell] = cNavGrid.GetEdges(uiCell);
+	vecAddedEdges.clear();
+	vecCachedGoals.clear();
+	bBuilt = true;
+	uiGridRevision = cNavGrid.GetRevision();
+	this->uiNumDirections = uiNumDirections;
+}
+
+/**
+ @brief Bring the labels up to date with a grid. 
+		The cells which have changed since the last update, and their neighbours, are checked for new edges. 
+		The labels are only rebuilt if a changed cell is new, a new edge could close a cycle between components, 
+		there are too many new edges, or the changes are not known
+ @param cNavGrid A const CNavGrid& variable containing the cells and their edges
+ @param uiNumDirections A const unsigned int variable containing the number of directions to move in, 4 or 8
+ */
+void CReachability::Update(const CNavGrid& cNavGrid, const unsigned int uiNumDirections)
+{
+	if ((bBuilt) && (uiGridRevision == cNavGrid.GetRevision()) && (this->uiNumDirections == uiNumDirections))
+		return;
+
+	if ((!bBuilt) || (this->uiNumDirections != uiNumDirections) || 
+		(arrComponents.size() != cNavGrid.GetNumCells()) ||
+		(!cNavGrid.GetChangedCells(uiGridRevision, vecStack)))
+	{
+		Build(cNavGrid, uiNumDirections);
+		return;
+	}
+
+	// A changed cell changes its own edges, and the edges of its neighbours into it
+	const std::vector<unsigned int> vecChangedCells(vecStack);
+	const unsigned int uiNumAddedEdges = vecAddedEdges.size();
+	for (unsigned int i = 0; i < vecChangedCells.size(); i++)
+	{
+		const unsigned int uiCell = vecChangedCells[i];
+		bool bUpdated = UpdateCell(cNavGrid, uiCell);
+		for (unsigned int uiDirection = 0; (bUpdated) && (uiDirection < CNavGrid::NUM_DIRECTIONS); uiDirection++)
+		{
+			const int iX = (int)cNavGrid.GetX(uiCell) + CNavGrid::DIRECTION_X[uiDirection];
+			const int iY = (int)cNavGrid.GetY(uiCell) + CNavGrid::DIRECTION_Y[uiDirection];
+			if ((iX >= 0) && (iX < (int)cNavGrid.GetWidth()) && (iY >= 0) && (iY < (int)cNavGrid.GetHeight()))
+				bUpdated = UpdateCell(cNavGrid, cNavGrid.GetCell(iX, iY));
+		}
+
+		if ((!bUpdated) || (vecAddedEdges.size() > MAX_ADDED_EDGES))
+		{
+			Build(cNavGrid, uiNumDirections);
+			return;
+		}
+	}
+
+	// The goals which were remembered may be reached from more components now
+	if (vecAddedEdges.size() != uiNumAddedEdges)
+		vecCachedGoals.clear();
+	uiGridRevision = cNavGrid.GetRevision();
+}
+
+/**
+ @brief Check if there may be a path from a cell to another. 
+		Cells in the same component can always reach each other, and a component can never reach a higher number. 
+		Otherwise, the components which can reach the goal are found once, and remembered for the next queries with the same goal
+ @param uiStart A const unsigned int variable containing the start cell
+ @param uiGoal A const unsigned int variable containing the goal cell
+ @return false if the goal cannot be reached from the start, or true if it may be reached
+ */
+bool CReachability::CanReach(const unsigned int uiStart, const unsigned int uiGoal)
+{
+	if (uiStart == uiGoal)
+		return true;
+	if ((uiStart >= arrComponents.size()) || (uiGoal >= arrComponents.size()))
+		return false;
+
+	const unsigned int uiStartComponent = arrComponents[uiStart];
+	const unsigned int uiGoalComponent = arrComponents[uiGoal];
+	if ((uiStartComponent == COMPONENT_NONE) || (uiGoalComponent == COMPONENT_NONE))
+		return false;
+	if (uiStartComponent == uiGoalComponent)
+		return true;
+	if (uiStartComponent < uiGoalComponent)
+		return false;
+
+	for (unsigned int i = 0; i < vecCachedGoals.size(); i++)
+	{
+		if (vecCachedGoals[i].first == uiGoalComponent)
+		{
+			// Move the goal to the back, as the latest goal
+			std::rotate(vecCachedGoals.begin() + i, vecCachedGoals.begin() + i + 1, vecCachedGoals.end());
+			return vecCachedGoals.back().second[uiStartComponent];
+		}
+	}
+
+	// Forget the oldest goal, reusing its memory
+	if (vecCachedGoals.size() < MAX_CACHED_GOALS)
+		vecCachedGoals.push_back(std::make_pair(0u, std::vector<bool>()));
+	else
+		std::rotate(vecCachedGoals.begin(), vecCachedGoals.begin() + 1, vecCachedGoals.end());
+	vecCachedGoals.back().first = uiGoalComponent;
+	FindPredecessors(uiGoalComponent, vecCachedGoals.back().second);
+	return vecCachedGoals.back().second[uiStartComponent];
+}
+
+/**
+ @brief Get the component of a cell
+ */
+unsigned int CReachability::GetComponent(const unsigned int uiCell) const
+{
+	return arrComponents[uiCell];
+}
+
+/**
+ @brief Get the number of components
+ */
+unsigned int CReachability::GetNumComponents(void) const
+{
+	return uiNumComponents;
+}
+
+/**
+ @brief Update the labels for the edges out of a cell. 
+		A cell which has become blocked leaves its component. A new edge within a component changes nothing, 
+		and a new edge to a lower component is added to the graph of components
+ @param cNavGrid A const CNavGrid& variable containing the cells and their edges
+ @param uiCell A const unsigned int variable containing the cell
+ @return true if the labels were updated, or false if they must be rebuilt
+ */
+bool CReachability::UpdateCell(const CNavGrid& cNavGrid, const unsigned int uiCell)
+{
+	if (!cNavGrid.IsPassable(uiCell))
+	{
+		arrComponents[uiCell] = COMPONENT_NONE;
+		arrLabelledEdges[uiCell] = 0;
+		return true;
+	}
+
+	const unsigned int uiComponent = arrComponents[uiCell];
+	if (uiComponent == COMPONENT_NONE)
+		return false;
+
+	const unsigned char ucEdges = cNavGrid.GetEdges(uiCell);
+	const unsigned char ucNewEdges = ucEdges & ~arrLabelledEdges[uiCell];
+	for (unsigned int uiDirection = 0; uiDirection < uiNumDirections; uiDirection++)
+	{
+		if ((ucNewEdges & (1 << uiDirection)) == 0)
+			continue;
+		const unsigned int uiNeighbourComponent = arrComponents[cNavGrid.GetNeighbour(uiCell, uiDirection)];
+		if ((uiNeighbourComponent == COMPONENT_NONE) || (uiNeighbourComponent > uiComponent))
+			return false;
+		if (uiNeighbourComponent < uiComponent)
+			vecAddedEdges.push_back(std::make_pair(uiComponent, uiNeighbourComponent));
+	}
+	arrLabelledEdges[uiCell] = ucEdges;
+	return true;
+}
+
+/**
+ @brief Find the components which can reach a goal component, by following the edges between the components backwards
+ @param uiGoalComponent A const unsigned int variable containing the goal component
+ @param vecCanReach A std::vector<bool>& variable to store if each component can reach the goal component
+ */
+void CReachability::FindPredecessors(const unsigned int uiGoalComponent, std::vector<bool>& vecCanReach)
+{
+	vecCanReach.assign(uiNumComponents, false);
+	vecCanReach[uiGoalComponent] = true;
+	vecStack.assign(1, uiGoalComponent);
+	while (!vecStack.empty())
+	{
+		const unsigned int uiComponent = vecStack.back();
+		vecStack.pop_back();
+		for (unsigned int i = arrPredecessorOffsets[uiComponent]; i < arrPredecessorOffsets[uiComponent + 1]; i++)
+		{
+			const unsigned int uiPredecessor = arrPredecessors[i];
+			if (!vecCanReach[uiPredecessor])
+			{
+				vecCanReach[uiPredecessor] = true;
+				vecStack.push_back(uiPredecessor);
+			}
+		}
+		for (unsigned int i = 0; i < vecAddedEdges.size(); i++)
+		{
+			const unsigned int uiPredecessor = vecAddedEdges[i].first;
+			if ((vecAddedEdges[i].second == uiComponent) && (!vecCanReach[uiPredecessor]))
+			{
+				vecCanReach[uiPredecessor] = true;
+				vecStack.push_back(uiPredecessor);
+			}
+		}
+	}
+}
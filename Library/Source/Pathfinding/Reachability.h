@@ -0,0 +1,88 @@
+/**
+ CReachability
+ @brief Which cells of a CNavGrid can reach which, so that a search for a goal which cannot be reached 
+		can fail at once, instead of expanding every cell which the start can reach.
+		The cells are labelled with their strongly connected components: every cell in a component can reach 
+		every other cell in it. Falls are one way, so a component can also reach the components below it, 
+		which is found from the graph of components, and remembered for the latest goals.
+		When cells change, the labels are updated without a rebuild unless a new cell or a new cycle appears. 
+		Edges which are removed are left in the labels, so a goal may be reported as reachable when it is not, 
+		and the search finds out, but a reachable goal is never reported as unreachable
+ By: JH Chong
+ Date: Aug 2022
+ */
+#pragma once
+
+// Include NavGrid
+#include "NavGrid.h"
+
+#include <vector>
+#include <utility>
+
+class CReachability
+{
+public:
+	// The component of a blocked cell
+	static const unsigned int COMPONENT_NONE = 0xFFFFFFFF;
+	// The number of goal components whose reachability is remembered
+	static const unsigned int MAX_CACHED_GOALS = 8;
+	// The number of edges between components which can be added by Update() before the labels are rebuilt
+	static const unsigned int MAX_ADDED_EDGES = 64;
+
+	// Constructor
+	CReachability(void);
+
+	// Destructor
+	virtual ~CReachability(void);
+
+	// Label the components of a grid, moving in 4 or 8 directions
+	void Build(const CNavGrid& cNavGrid, const unsigned int uiNumDirections);
+
+	// Bring the labels up to date with a grid, only updating the cells which have changed when it can
+	void Update(const CNavGrid& cNavGrid, const unsigned int uiNumDirections);
+
+	// Check if there may be a path from a cell to another
+	bool CanReach(const unsigned int uiStart, const unsigned int uiGoal);
+
+	// Get the component of a cell
+	unsigned int GetComponent(const unsigned int uiCell) const;
+	// Get the number of components
+	unsigned int GetNumComponents(void) const;
+
+protected:
+	// The component of each cell. The components are numbered so that every edge between 2 components 
+	// goes from a higher number to a lower number
+	std::vector<unsigned int> arrComponents;
+	unsigned int uiNumComponents;
+	// The components with an edge into each component, as the entries of arrPredecessors 
+	// from arrPredecessorOffsets[component] to arrPredecessorOffsets[component + 1]
+	std::vector<unsigned int> arrPredecessorOffsets;
+	std::vector<unsigned int> arrPredecessors;
+	// The edges between components which were added by Update(), as (from, to)
+	std::vector<std::pair<unsigned int, unsigned int>> vecAddedEdges;
+	// The edges of each cell which the labels include
+	std::vector<unsigned char> arrLabelledEdges;
+
+	// The components which can reach each of the latest goal components, with the latest goal at the back
+	std::vector<std::pair<unsigned int, std::vector<bool>>> vecCachedGoals;
+	std::vector<unsigned int> vecStack;
+
+	// The search data of Build(), which is kept to be reused by the next build.
+	// The order in which each cell was found, and the lowest order of a cell on the stack which it can reach
+	std::vector<unsigned int> arrIndices;
+	std::vector<unsigned int> arrLowLinks;
+	// The cells which have been found but are not in a component yet
+	std::vector<unsigned int> vecCellStack;
+	std::vector<unsigned char> arrOnStack;
+	// The cells being searched, and the next direction to search from each of them
+	std::vector<std::pair<unsigned int, unsigned int>> vecSearchStack;
+
+	bool bBuilt;
+	unsigned int uiGridRevision;
+	unsigned int uiNumDirections;
+
+	// Update the labels for the edges out of a cell, or return false if they must be rebuilt
+	bool UpdateCell(const CNavGrid& cNavGrid, const unsigned int uiCell);
+	// Find the components which can reach a goal component
+	void FindPredecessors(const unsigned int uiGoalComponent, std::vector<bool>& vecCanReach);
+};
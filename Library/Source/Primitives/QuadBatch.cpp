@@ -0,0 +1,181 @@
+/**
+ CQuadBatch
+ @brief A mesh which stores many textured quads in one vertex buffer, so that they can be drawn in a few draw calls
+ By: JH Chong
+ Date: Aug 2022
+ */
+#include "QuadBatch.h"
+
+// Include GLEW
+#ifndef GLEW_STATIC
+#include <GL/glew.h>
+#define GLEW_STATIC
+#endif
+
+/**
+ @brief Constructor
+ */
+CQuadBatch::CQuadBatch(void)
+	: CMesh()
+{
+	indexSize = 0;
+	mode = CMesh::DRAW_TRIANGLES;
+}
+
+/**
+ @brief Destructor
+ */
+CQuadBatch::~CQuadBatch(void)
+{
+}
+
+/**
+ @brief Remove all the quads from this batch
+ */
+void CQuadBatch::Clear(void)
+{
+	vertex_buffer_data.clear();
+	index_buffer_data.clear();
+}
+
+/**
+ @brief Add a quad which is centred at vec2Position
+ @param vec2Position A const glm::vec2& variable containing the centre of the quad
+ @param vec2Size A const glm::vec2& variable containing the width and height of the quad
+ @param vec2UVMin A const glm::vec2& variable containing the texture coordinates of the bottom-left corner
+ @param vec2UVMax A const glm::vec2& variable containing the texture coordinates of the top-right corner
+ @param vec4Colour A const glm::vec4& variable containing the colour of the quad
+ */
+void CQuadBatch::AddQuad(	const glm::vec2& vec2Position,
+							const glm::vec2& vec2Size,
+							const glm::vec2& vec2UVMin,
+							const glm::vec2& vec2UVMax,
+							const glm::vec4& vec4Colour)
+{
+	const unsigned int offset = (unsigned int)vertex_buffer_data.size();
+
+	vertex_buffer_data.resize(offset + 4);
+	SetQuad(offset / 4, vec2Position, vec2Size, vec2UVMin, vec2UVMax, vec4Colour);
+
+	// Same winding as CMeshBuilder::GenerateQuad
+	index_buffer_data.push_back(offset + 3);
+	index_buffer_data.push_back(offset + 0);
+	index_buffer_data.push_back(offset + 2);
+	index_buffer_data.push_back(offset + 1);
+	index_buffer_data.push_back(offset + 2);
+	index_buffer_data.push_back(offset + 0);
+}
+
+/**
+ @brief Replace a quad which was added earlier. Call UploadQuads() to send it to the graphics card
+ @param uiQuad A const unsigned int variable containing the index of the quad to replace
+ @param vec2Position A const glm::vec2& variable containing the centre of the quad
+ @param vec2Size A const glm::vec2& variable containing the width and height of the quad
+ @param vec2UVMin A const glm::vec2& variable containing the texture coordinates of the bottom-left corner
+ @param vec2UVMax A const glm::vec2& variable containing the texture coordinates of the top-right corner
+ @param vec4Colour A const glm::vec4& variable containing the colour of the quad
+ */
+void CQuadBatch::SetQuad(	const unsigned int uiQuad,
+							const glm::vec2& vec2Position,
+							const glm::vec2& vec2Size,
+							const glm::vec2& vec2UVMin,
+							const glm::vec2& vec2UVMax,
+							const glm::vec4& vec4Colour)
+{
+	if (uiQuad >= GetNumQuads())
+		return;
+
+	const glm::vec2 vec2HalfSize = vec2Size * 0.5f;
+	Vertex* v = &vertex_buffer_data[uiQuad * 4];
+
+	v[0].position = glm::vec3(vec2Position.x - vec2HalfSize.x, vec2Position.y - vec2HalfSize.y, 0);
+	v[0].texCoord = glm::vec2(vec2UVMin.x, vec2UVMin.y);
+
+	v[1].position = glm::vec3(vec2Position.x + vec2HalfSize.x, vec2Position.y - vec2HalfSize.y, 0);
+	v[1].texCoord = glm::vec2(vec2UVMax.x, vec2UVMin.y);
+
+	v[2].position = glm::vec3(vec2Position.x + vec2HalfSize.x, vec2Position.y + vec2HalfSize.y, 0);
+	v[2].texCoord = glm::vec2(vec2UVMax.x, vec2UVMax.y);
+
+	v[3].position = glm::vec3(vec2Position.x - vec2HalfSize.x, vec2Position.y + vec2HalfSize.y, 0);
+	v[3].texCoord = glm::vec2(vec2UVMin.x, vec2UVMax.y);
+
+	for (unsigned int i = 0; i < 4; i++)
+		v[i].color = vec4Colour;
+}
+
+/**
+ @brief Get the number of quads in this batch
+ */
+unsigned int CQuadBatch::GetNumQuads(void) const
+{
+	return (unsigned int)(vertex_buffer_data.size() / 4);
+}
+
+/**
+ @brief Upload the quads to the graphics card
+ */
+void CQuadBatch::Upload(void)
+{
+	indexSize = (unsigned int)index_buffer_data.size();
+	if (indexSize == 0)
+		return;
+
+	glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+	glBufferData(GL_ARRAY_BUFFER, vertex_buffer_data.size() * sizeof(Vertex), &vertex_buffer_data[0], GL_STATIC_DRAW);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, index_buffer_data.size() * sizeof(GLuint), &index_buffer_data[0], GL_STATIC_DRAW);
+}
+
+/**
+ @brief Upload a range of quads to the graphics card, after the batch has been uploaded with Upload().
+		Only the vertices are uploaded, as the indices of a quad do not change when it is replaced
+ @param uiFirstQuad A const unsigned int variable containing the index of the first quad to upload
+ @param uiNumQuads A const unsigned int variable containing the number of quads to upload
+ */
+void CQuadBatch::UploadQuads(const unsigned int uiFirstQuad, const unsigned int uiNumQuads)
+{
+	if ((uiNumQuads == 0) || ((uiFirstQuad + uiNumQuads) * 6 > indexSize))
+		return;
+
+	glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+	glBufferSubData(GL_ARRAY_BUFFER, 
+					uiFirstQuad * 4 * sizeof(Vertex), 
+					uiNumQuads * 4 * sizeof(Vertex), 
+					&vertex_buffer_data[uiFirstQuad * 4]);
+}
+
+/**
+ @brief Render all the quads in this batch
+ */
+void CQuadBatch::Render(void)
+{
+	RenderRange(0, indexSize / 6);
+}
+
+/**
+ @brief Render a range of quads in this batch
+ @param uiFirstQuad A const unsigned int variable containing the index of the first quad to render
+ @param uiNumQuads A const unsigned int variable containing the number of quads to render
+ */
+void CQuadBatch::RenderRange(const unsigned int uiFirstQuad, const unsigned int uiNumQuads)
+{
+	if ((uiNumQuads == 0) || ((uiFirstQuad + uiNumQuads) * 6 > indexSize))
+		return;
+
+	glEnableVertexAttribArray(0);
+	glEnableVertexAttribArray(1);
+	glEnableVertexAttribArray(2);
+
+	glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
+	glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)sizeof(glm::vec3));
+	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(sizeof(glm::vec3) + sizeof(glm::vec4)));
+
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+	glDrawElements(GL_TRIANGLES, uiNumQuads * 6, GL_UNSIGNED_INT, (void*)(uiFirstQuad * 6 * sizeof(GLuint)));
+
+	glDisableVertexAttribArray(2);
+	glDisableVertexAttribArray(1);
+	glDisableVertexAttribArray(0);
+}
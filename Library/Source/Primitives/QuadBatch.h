@@ -0,0 +1,58 @@
+/**
+ CQuadBatch
+ @brief A mesh which stores many textured quads in one vertex buffer, so that they can be drawn in a few draw calls
+ By: JH Chong
+ Date: Aug 2022
+ */
+#pragma once
+
+#include "Mesh.h"
+
+#include <vector>
+
+class CQuadBatch : public CMesh
+{
+public:
+	// Constructor
+	CQuadBatch(void);
+	// Destructor
+	virtual ~CQuadBatch(void);
+
+	// Remove all the quads from this batch
+	void Clear(void);
+
+	// Add a quad which is centred at vec2Position
+	void AddQuad(	const glm::vec2& vec2Position,
+					const glm::vec2& vec2Size,
+					const glm::vec2& vec2UVMin = glm::vec2(0.0f, 0.0f),
+					const glm::vec2& vec2UVMax = glm::vec2(1.0f, 1.0f),
+					const glm::vec4& vec4Colour = glm::vec4(1.0f));
+
+	// Replace a quad which was added earlier. Call UploadQuads() to send it to the graphics card
+	void SetQuad(	const unsigned int uiQuad,
+					const glm::vec2& vec2Position,
+					const glm::vec2& vec2Size,
+					const glm::vec2& vec2UVMin = glm::vec2(0.0f, 0.0f),
+					const glm::vec2& vec2UVMax = glm::vec2(1.0f, 1.0f),
+					const glm::vec4& vec4Colour = glm::vec4(1.0f));
+
+	// Get the number of quads in this batch
+	unsigned int GetNumQuads(void) const;
+
+	// Upload the quads to the graphics card
+	void Upload(void);
+
+	// Upload a range of quads to the graphics card, after the batch has been uploaded with Upload()
+	void UploadQuads(const unsigned int uiFirstQuad, const unsigned int uiNumQuads);
+
+	// Render all the quads in this batch
+	virtual void Render(void);
+
+	// Render a range of quads in this batch
+	void RenderRange(const unsigned int uiFirstQuad, const unsigned int uiNumQuads);
+
+protected:
+	// The vertices and indices of the quads, kept in system memory until Upload() is called
+	std::vector<Vertex> vertex_buffer_data;
+	std::vector<unsigned int> index_buffer_data;
+};
@@ -0,0 +1,225 @@
+/**
+ CSpatialHash2D
+ @brief A uniform grid of the entities on a tile map, so that the entities in or near a tile can be found
+		without checking every entity. Each cell covers a square of tiles and keeps a linked list of the
+		entities in it, so an entity is added, moved and removed in constant time.
+		The entities are numbers from 0, such as the indices of the enemies in CEnemySystem2D.
+ By: JH Chong
+ Date: Aug 2022
+ */
+#include "SpatialHash2D.h"
+
+/**
+ @brief Constructor
+ */
+CSpatialHash2D::CSpatialHash2D(void)
+	: uiCellSize(1)
+	, uiNumCellsX(0)
+	, uiNumCellsY(0)
+{
+}
+
+/**
+ @brief Destructor
+ */
+CSpatialHash2D::~CSpatialHash2D(void)
+{
+}
+
+/**
+ @brief Set the size of the tile map and of a cell, and remove all the entities
+ @param uiWidth A const unsigned int variable containing the number of columns of tiles
+ @param uiHeight A const unsigned int variable containing the number of rows of tiles
+ @param uiCellSize A const unsigned int variable containing the number of tiles across a cell
+ */
+void CSpatialHash2D::Init(const unsigned int uiWidth, const unsigned int uiHeight, const unsigned int uiCellSize)
+{
+	this->uiCellSize = (uiCellSize > 0) ? uiCellSize : 1;
+	uiNumCellsX = (uiWidth + this->uiCellSize - 1) / this->uiCellSize;
+	uiNumCellsY = (uiHeight + this->uiCellSize - 1) / this->uiCellSize;
+	arrCellHeads.assign(uiNumCellsX * uiNumCellsY, static_cast<unsigned int>(NONE));
+	Clear();
+}
+
+/**
+ @brief Remove all the entities
+ */
+void CSpatialHash2D::Clear(void)
+{
+	arrCellHeads.assign(arrCellHeads.size(), static_cast<unsigned int>(NONE));
+	arrEntityCells.clear();
+	arrPrevious.clear();
+	arrNext.clear();
+}
+
+/**
+ @brief Add an entity at a tile, or move it there if it is already in the grid
+ @param uiEntity A const unsigned int variable containing the entity
+ @param iX A const int variable containing the column of the tile
+ @param iY A const int variable containing the row of the tile
+ */
+void CSpatialHash2D::Insert(const unsigned int uiEntity, const int iX, const int iY)
+{
+	if (arrCellHeads.empty())
+		return;
+
+	if (uiEntity >= arrEntityCells.size())
+	{
+		arrEntityCells.resize(uiEntity + 1, static_cast<unsigned int>(NONE));
+		arrPrevious.resize(uiEntity + 1, static_cast<unsigned int>(NONE));
+		arrNext.resize(uiEntity + 1, static_cast<unsigned int>(NONE));
+	}
+	Move(uiEntity, iX, iY);
+}
+
+/**
+ @brief Move an entity to a tile. The grid is only changed if the tile is in another cell
+ @param uiEntity A const unsigned int variable containing the entity, which has been added with Insert()
+ @param iX A const int variable containing the column of the tile
+ @param iY A const int variable containing the row of the tile
+ */
+void CSpatialHash2D::Move(const unsigned int uiEntity, const int iX, const int iY)
+{
+	if (uiEntity >= arrEntityCells.size())
+		return;
+
+	int iCellX = 0, iCellY = 0;
+	GetCellCoordinates(iX, iY, iCellX, iCellY);
+	const unsigned int uiCell = iCellY * uiNumCellsX + iCellX;
+	if (arrEntityCells[uiEntity] == uiCell)
+		return;
+
+	Unlink(uiEntity);
+	Link(uiEntity, uiCell);
+}
+
+/**
+ @brief Remove an entity
+ @param uiEntity A const unsigned int variable containing the entity
+ */
+void CSpatialHash2D::Remove(const unsigned int uiEntity)
+{
+	if (uiEntity < arrEntityCells.size())
+		Unlink(uiEntity);
+}
+
+/**
+ @brief Check if an entity is in the grid
+ @param uiEntity A const unsigned int variable containing the entity
+ */
+bool CSpatialHash2D::Contains(const unsigned int uiEntity) const
+{
+	return (uiEntity < arrEntityCells.size()) && (arrEntityCells[uiEntity] != NONE);
+}
+
+/**
+ @brief Get the first entity in the cell of a tile. The other entities in the cell are found with GetNext()
+ @param iX A const int variable containing the column of the tile
+ @param iY A const int variable containing the row of the tile
+ @return The first entity, or NONE if the cell is empty
+ */
+unsigned int CSpatialHash2D::GetFirst(const int iX, const int iY) const
+{
+	if (arrCellHeads.empty())
+		return NONE;
+
+	int iCellX = 0, iCellY = 0;
+	GetCellCoordinates(iX, iY, iCellX, iCellY);
+	return arrCellHeads[iCellY * uiNumCellsX + iCellX];
+}
+
+/**
+ @brief Get the entity after an entity in its cell
+ @param uiEntity A const unsigned int variable containing the entity
+ @return The next entity, or NONE if it is the last entity in its cell
+ */
+unsigned int CSpatialHash2D::GetNext(const unsigned int uiEntity) const
+{
+	return arrNext[uiEntity];
+}
+
+/**
+ @brief Find the entities in the cells within a number of cells of the cell of a tile
+ @param iX A const int variable containing the column of the tile
+ @param iY A const int variable containing the row of the tile
+ @param uiRadius A const unsigned int variable containing the number of cells around the cell of the tile to search
+ @param vecEntities A std::vector<unsigned int>& variable to store the entities, in no particular order
+ */
+void CSpatialHash2D::Query(const int iX, const int iY, const unsigned int uiRadius, std::vector<unsigned int>& vecEntities) const
+{
+	vecEntities.clear();
+	if (arrCellHeads.empty())
+		return;
+
+	int iCellX = 0, iCellY = 0;
+	GetCellCoordinates(iX, iY, iCellX, iCellY);
+	const int iMinX = (iCellX > (int)uiRadius) ? iCellX - (int)uiRadius : 0;
+	const int iMinY = (iCellY > (int)uiRadius) ? iCellY - (int)uiRadius : 0;
+	const int iMaxX = (iCellX + (int)uiRadius < (int)uiNumCellsX) ? iCellX + (int)uiRadius : (int)uiNumCellsX - 1;
+	const int iMaxY = (iCellY + (int)uiRadius < (int)uiNumCellsY) ? iCellY + (int)uiRadius : (int)uiNumCellsY - 1;
+	for (int iQueryY = iMinY; iQueryY <= iMaxY; iQueryY++)
+	{
+		for (int iQueryX = iMinX; iQueryX <= iMaxX; iQueryX++)
+		{
+			for (unsigned int uiEntity = arrCellHeads[iQueryY * uiNumCellsX + iQueryX]; uiEntity != NONE; uiEntity = arrNext[uiEntity])
+				vecEntities.push_back(uiEntity);
+		}
+	}
+}
+
+/**
+ @brief Get the cell of a tile. A tile outside the map is in the nearest cell at the edge of the grid
+ @param iX A const int variable containing the column of the tile
+ @param iY A const int variable containing the row of the tile
+ @param iCellX An int& variable to store the column of the cell
+ @param iCellY An int& variable to store the row of the cell
+ */
+void CSpatialHash2D::GetCellCoordinates(const int iX, const int iY, int& iCellX, int& iCellY) const
+{
+	iCellX = (iX > 0) ? iX / (int)uiCellSize : 0;
+	iCellY = (iY > 0) ? iY / (int)uiCellSize : 0;
+	if (iCellX >= (int)uiNumCellsX)
+		iCellX = (int)uiNumCellsX - 1;
+	if (iCellY >= (int)uiNumCellsY)
+		iCellY = (int)uiNumCellsY - 1;
+}
+
+/**
+ @brief Link an entity into the front of the list of a cell
+ @param uiEntity A const unsigned int variable containing the entity, which is not in a cell
+ @param uiCell A const unsigned int variable containing the cell
+ */
+void CSpatialHash2D::Link(const unsigned int uiEntity, const unsigned int uiCell)
+{
+	const unsigned int uiHead = arrCellHeads[uiCell];
+	arrPrevious[uiEntity] = NONE;
+	arrNext[uiEntity] = uiHead;
+	if (uiHead != NONE)
+		arrPrevious[uiHead] = uiEntity;
+	arrCellHeads[uiCell] = uiEntity;
+	arrEntityCells[uiEntity] = uiCell;
+}
+
+/**
+ @brief Unlink an entity from the list of its cell
+ @param uiEntity A const unsigned int variable containing the entity
+ */
+void CSpatialHash2D::Unlink(const unsigned int uiEntity)
+{
+	const unsigned int uiCell = arrEntityCells[uiEntity];
+	if (uiCell == NONE)
+		return;
+
+	const unsigned int uiPrevious = arrPrevious[uiEntity];
+	const unsigned int uiNext = arrNext[uiEntity];
+	if (uiPrevious != NONE)
+		arrNext[uiPrevious] = uiNext;
+	else
+		arrCellHeads[uiCell] = uiNext;
+	if (uiNext != NONE)
+		arrPrevious[uiNext] = uiPrevious;
+
+	arrPrevious[uiEntity] = NONE;
+	arrNext[uiEntity] = NONE;
+	arrEntityCells[uiEntity] = NONE;
+}
@@ -0,0 +1,124 @@
+/**
+ CSpatialHash2D
+ @brief A uniform grid of the entities on a tile map, so that the entities in or near a tile can be found
+		without checking every entity. Each cell covers a square of tiles and keeps a linked list of the
+		entities in it, so an entity is added, moved and removed in constant time.
+		The entities are numbers from 0, such as the indices of the enemies in CEnemySystem2D.
+ By: JH Chong
+ Date: Aug 2022
+ */
+#pragma once
+
+#include <vector>
+
+class CSpatialHash2D
+{
+public:
+	// The end of the list of a cell, and the cell of an entity which is not in the grid
+	static const unsigned int NONE = 0xFFFFFFFF;
+
+	// Constructor
+	CSpatialHash2D(void);
+
+	// Destructor
+	virtual ~CSpatialHash2D(void);
+
+	// Set the size of the tile map and of a cell, and remove all the entities
+	void Init(const unsigned int uiWidth, const unsigned int uiHeight, const unsigned int uiCellSize = 1);
+
+	// Remove all the entities
+	void Clear(void);
+
+	// Add an entity at a tile, or move it there if it is already in the grid
+	void Insert(const unsigned int uiEntity, const int iX, const int iY);
+	// Move an entity to a tile, which only changes the grid if the tile is in another cell
+	void Move(const unsigned int uiEntity, const int iX, const int iY);
+	// Remove an entity
+	void Remove(const unsigned int uiEntity);
+
+	// Check if an entity is in the grid
+	bool Contains(const unsigned int uiEntity) const;
+
+	// Get the first entity in the cell of a tile, or NONE
+	unsigned int GetFirst(const int iX, const int iY) const;
+	// Get the entity after an entity in its cell, or NONE
+	unsigned int GetNext(const unsigned int uiEntity) const;
+
+	// Find the entities in the cells within a number of cells of the cell of a tile
+	void Query(const int iX, const int iY, const unsigned int uiRadius, std::vector<unsigned int>& vecEntities) const;
+
+	// Find the entity nearest to a tile by cells which matches a predicate, searching outwards one ring of cells at a time
+	template <typename Predicate>
+	unsigned int FindNearest(const int iX, const int iY, const Predicate& predicate, const unsigned int uiMaxRadius = NONE) const;
+
+protected:
+	unsigned int uiCellSize;
+	unsigned int uiNumCellsX;
+	unsigned int uiNumCellsY;
+
+	// The first entity in each cell
+	std::vector<unsigned int> arrCellHeads;
+	// The cell of each entity, and the entities before and after it in its cell
+	std::vector<unsigned int> arrEntityCells;
+	std::vector<unsigned int> arrPrevious;
+	std::vector<unsigned int> arrNext;
+
+	// Get the cell of a tile, clamped to the grid
+	void GetCellCoordinates(const int iX, const int iY, int& iCellX, int& iCellY) const;
+	// Link an entity into a cell
+	void Link(const unsigned int uiEntity, const unsigned int uiCell);
+	// Unlink an entity from its cell
+	void Unlink(const unsigned int uiEntity);
+};
+
+/**
+ @brief Find the entity nearest to a tile by cells which matches a predicate.
+		The cells are searched in rings around the cell of the tile, so the search stops at the first ring with a match.
+		Entities in the same ring are equally near, and the one with the lowest number is returned
+ @param iX A const int variable containing the column of the tile
+ @param iY A const int variable containing the row of the tile
+ @param predicate A const Predicate& variable containing a function object which is called with an entity and returns true if it matches
+ @param uiMaxRadius A const unsigned int variable containing the most rings of cells to search, or NONE to search the whole grid
+ @return The nearest entity which matches, or NONE
+ */
+template <typename Predicate>
+unsigned int CSpatialHash2D::FindNearest(const int iX, const int iY, const Predicate& predicate, const unsigned int uiMaxRadius) const
+{
+	if (arrCellHeads.empty())
+		return NONE;
+
+	int iCellX = 0, iCellY = 0;
+	GetCellCoordinates(iX, iY, iCellX, iCellY);
+	const int iGridRadius = (int)(uiNumCellsX > uiNumCellsY ? uiNumCellsX : uiNumCellsY);
+	const int iMaxRadius = ((uiMaxRadius == NONE) || ((int)uiMaxRadius > iGridRadius)) ? iGridRadius : (int)uiMaxRadius;
+
+	for (int iRadius = 0; iRadius <= iMaxRadius; iRadius++)
+	{
+		unsigned int uiNearest = NONE;
+		for (int iRingY = iCellY - iRadius; iRingY <= iCellY + iRadius; iRingY++)
+		{
+			if ((iRingY < 0) || (iRingY >= (int)uiNumCellsY))
+				continue;
+
+			// Only the first and last rows of the ring are whole, the other rows only have their ends in the ring
+			const bool bWholeRow = (iRingY == iCellY - iRadius) || (iRingY == iCellY + iRadius);
+			const int iStepX = ((bWholeRow) || (iRadius == 0)) ? 1 : 2 * iRadius;
+			for (int iRingX = iCellX - iRadius; iRingX <= iCellX + iRadius; iRingX += iStepX)
+			{
+				if ((iRingX < 0) || (iRingX >= (int)uiNumCellsX))
+					continue;
+
+				for (unsigned int uiEntity = arrCellHeads[iRingY * uiNumCellsX + iRingX]; uiEntity != NONE; uiEntity = arrNext[uiEntity])
+				{
+					if ((uiEntity < uiNearest) && (predicate(uiEntity)))
+						uiNearest = uiEntity;
+				}
+			}
+		}
+
+		if (uiNearest != NONE)
+			return uiNearest;
+	}
+
+	return NONE;
+}
@@ -0,0 +1,232 @@
+/**
+ CMapFile
+ @brief A class which reads and writes tile maps in a binary format.
+		The file is mapped into memory and its layers are used in place, so loading a map 
+		costs about the same as copying its bytes, instead of parsing every cell as text.
+ By: JH Chong
+ Date: Aug 2022
+ */
+#include "MapFile.h"
+
+#include <fstream>
+#include <iostream>
+using namespace std;
+
+/**
+ @brief Constructor
+ */
+CMapFile::CMapFile(void)
+	: pHeader(NULL)
+{
+}
+
+/**
+ @brief Destructor
+ */
+CMapFile::~CMapFile(void)
+{
+	Close();
+}
+
+/**
+ @brief Map a map file into memory and check that it is valid
+ @param filename A const std::string& variable containing the name of the map file
+ @return true if the file is a valid map file, otherwise false
+ */
+bool CMapFile::Open(const std::string& filename)
+{
+	Close();
+
+	if (cFile.Open(filename) == false)
+		return false;
+
+	if (cFile.GetSize() < sizeof(MapFileHeader))
+	{
+		cout << "CMapFile::Open() : " << filename << " is too small to be a map file" << endl;
+		Close();
+		return false;
+	}
+
+	const MapFileHeader* pFileHeader = (const MapFileHeader*)cFile.GetData();
+	if (pFileHeader->uiMagic != MAGIC)
+	{
+		cout << "CMapFile::Open() : " << filename << " is not a map file" << endl;
+		Close();
+		return false;
+	}
+	if (pFileHeader->usVersion > VERSION)
+	{
+		cout << "CMapFile::Open() : " << filename << " has an unsupported version " << pFileHeader->usVersion << endl;
+		Close();
+		return false;
+	}
+
+	// Check that the layers and spawns are within the file, and aligned so that they can be read in place
+	const unsigned long long ullLayersSize = 
+		(unsigned long long)pFileHeader->usNumLayers * pFileHeader->uiNumRows * pFileHeader->uiNumCols * sizeof(unsigned short);
+	const unsigned long long ullSpawnsSize = 
+		(unsigned long long)pFileHeader->uiNumSpawns * sizeof(MapFileSpawn);
+	const unsigned long long ullValueCountsSize = 
+		(pFileHeader->usVersion >= 3 ? (unsigned long long)pFileHeader->uiNumValueCounts * sizeof(MapFileValueCount) : 0);
+	if ((pFileHeader->uiNumRows == 0) || (pFileHeader->uiNumCols == 0) ||
+		(pFileHeader->uiLayersOffset % sizeof(unsigned short) != 0) ||
+		(pFileHeader->uiSpawnsOffset % sizeof(unsigned int) != 0) ||
+		(pFileHeader->uiLayersOffset + ullLayersSize > cFile.GetSize()) ||
+		(pFileHeader->uiSpawnsOffset + ullSpawnsSize + ullValueCountsSize > cFile.GetSize()))
+	{
+		cout << "CMapFile::Open() : " << filename << " is corrupted" << endl;
+		Close();
+		return false;
+	}
+
+	pHeader = pFileHeader;
+	return true;
+}
+
+/**
+ @brief Unmap the map file
+ */
+void CMapFile::Close(void)
+{
+	pHeader = NULL;
+	cFile.Close();
+}
+
+/**
+ @brief Get the number of rows in the map
+ */
+unsigned int CMapFile::GetNumRows(void) const
+{
+	return (pHeader ? pHeader->uiNumRows : 0);
+}
+
+/**
+ @brief Get the number of columns in the map
+ */
+unsigned int CMapFile::GetNumCols(void) const
+{
+	return (pHeader ? pHeader->uiNumCols : 0);
+}
+
+/**
+ @brief Get the version of the format of the map file
+ */
+unsigned short CMapFile::GetVersion(void) const
+{
+	return (pHeader ? pHeader->usVersion : 0);
+}
+
+/**
+ @brief Get the tiles of a layer, or NULL if the file does not have this layer
+ @param uiLayer A const unsigned int variable containing the layer, e.g. LAYER_TILES
+ */
+const unsigned short* CMapFile::GetLayer(const unsigned int uiLayer) const
+{
+	if ((pHeader == NULL) || (uiLayer >= pHeader->usNumLayers))
+		return NULL;
+
+	const unsigned short* pLayers = (const unsigned short*)(cFile.GetData() + pHeader->uiLayersOffset);
+	return pLayers + (size_t)uiLayer * pHeader->uiNumRows * pHeader->uiNumCols;
+}
+
+/**
+ @brief Get the number of spawn points
+ */
+unsigned int CMapFile::GetNumSpawns(void) const
+{
+	return (pHeader ? pHeader->uiNumSpawns : 0);
+}
+
+/**
+ @brief Get the spawn points
+ */
+const MapFileSpawn* CMapFile::GetSpawns(void) const
+{
+	if (pHeader == NULL)
+		return NULL;
+
+	return (const MapFileSpawn*)(cFile.GetData() + pHeader->uiSpawnsOffset);
+}
+
+/**
+ @brief Get the number of value counts, which is 0 for files before version 3
+ */
+unsigned int CMapFile::GetNumValueCounts(void) const
+{
+	if ((pHeader == NULL) || (pHeader->usVersion < 3))
+		return 0;
+
+	return pHeader->uiNumValueCounts;
+}
+
+/**
+ @brief Get the value counts, which are stored right after the spawn points
+ */
+const MapFileValueCount* CMapFile::GetValueCounts(void) const
+{
+	if (pHeader == NULL)
+		return NULL;
+
+	return (const MapFileValueCount*)(cFile.GetData() + pHeader->uiSpawnsOffset + 
+		(size_t)pHeader->uiNumSpawns * sizeof(MapFileSpawn));
+}
+
+/**
+ @brief Write a map to a map file
+ @param filename A const std::string& variable containing the name of the map file
+ @param uiNumRows A const unsigned int variable containing the number of rows in the map
+ @param uiNumCols A const unsigned int variable containing the number of columns in the map
+ @param arrLayers A const unsigned short* const* variable containing the tiles of each layer, with the rows counted from the top
+ @param usNumLayers A const unsigned short variable containing the number of layers in arrLayers
+ @param vecSpawns A const std::vector<MapFileSpawn>& variable containing the spawn points
+ @param vecValueCounts A const std::vector<MapFileValueCount>& variable containing the number of tiles of each value listed in vecSpawns
+ @return true if the file was written, otherwise false
+ */
+bool CMapFile::Write(	const std::string& filename,
+						const unsigned int uiNumRows,
+						const unsigned int uiNumCols,
+						const unsigned short* const* arrLayers,
+						const unsigned short usNumLayers,
+						const std::vector<MapFileSpawn>& vecSpawns,
+						const std::vector<MapFileValueCount>& vecValueCounts)
+{
+	const size_t layerSize = (size_t)uiNumRows * uiNumCols * sizeof(unsigned short);
+
+	MapFileHeader header;
+	header.uiMagic = MAGIC;
+	header.usVersion = VERSION;
+	header.usNumLayers = usNumLayers;
+	header.uiNumRows = uiNumRows;
+	header.uiNumCols = uiNumCols;
+	header.uiNumSpawns = (unsigned int)vecSpawns.size();
+	header.uiLayersOffset = sizeof(MapFileHeader);
+	// Align the spawns to 4 bytes so that they can be read in place
+	header.uiSpawnsOffset = (unsigned int)((header.uiLayersOffset + layerSize * usNumLayers + 3) & ~(size_t)3);
+	header.uiNumValueCounts = (unsigned int)vecValueCounts.size();
+
+	ofstream file(filename.c_str(), ios::out | ios::binary | ios::trunc);
+	if (!file.is_open())
+	{
+		cout << "CMapFile::Write() : Unable to open " << filename << endl;
+		return false;
+	}
+
+	file.write((const char*)&header, sizeof(header));
+	for (unsigned short usLayer = 0; usLayer < usNumLayers; usLayer++)
+		file.write((const char*)arrLayers[usLayer], layerSize);
+
+	const char padding[4] = { 0, 0, 0, 0 };
+	file.write(padding, header.uiSpawnsOffset - (header.uiLayersOffset + layerSize * usNumLayers));
+	if (vecSpawns.size() > 0)
+		file.write((const char*)&vecSpawns[0], vecSpawns.size() * sizeof(MapFileSpawn));
+	if (vecValueCounts.size() > 0)
+		file.write((const char*)&vecValueCounts[0], vecValueCounts.size() * sizeof(MapFileValueCount));
+
+	if (!file.good())
+	{
+		cout << "CMapFile::Write() : Unable to write " << filename << endl;
+		return false;
+	}
+
+	return true;
+}
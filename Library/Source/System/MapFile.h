@@ -0,0 +1,118 @@
+/**
+ CMapFile
+ @brief A class which reads and writes tile maps in a binary format.
+		The file is mapped into memory and its layers are used in place, so loading a map 
+		costs about the same as copying its bytes, instead of parsing every cell as text.
+ By: JH Chong
+ Date: Aug 2022
+ */
+#pragma once
+
+// Include MemoryMappedFile
+#include "MemoryMappedFile.h"
+
+#include <string>
+#include <vector>
+
+// The header at the start of a map file. 
+// A map file is laid out as follows, with all values in little endian:
+//	MapFileHeader
+//	unsigned short arrLayers[usNumLayers][uiNumRows * uiNumCols], with the rows counted from the top of the map
+//	MapFileSpawn arrSpawns[uiNumSpawns]
+//	MapFileValueCount arrValueCounts[uiNumValueCounts], from version 3
+struct MapFileHeader {
+	unsigned int uiMagic;
+	unsigned short usVersion;
+	unsigned short usNumLayers;
+	unsigned int uiNumRows;
+	unsigned int uiNumCols;
+	unsigned int uiNumSpawns;
+	// The offsets of the layers and the spawns from the start of the file, in bytes
+	unsigned int uiLayersOffset;
+	unsigned int uiSpawnsOffset;
+	// The number of value counts after the spawns. This is 0 before version 3
+	unsigned int uiNumValueCounts;
+};
+
+// A spawn point in a map file, e.g. the start position of the player or an enemy.
+// From version 2, the spawn table also has the other tiles which the game looks up by value, such as items,
+// so that a map can be indexed from this table without scanning its tiles.
+// The row is counted from the top of the map
+struct MapFileSpawn {
+	unsigned short usValue;
+	unsigned short usReserved;
+	unsigned int uiRow;
+	unsigned int uiCol;
+};
+
+// The number of tiles of a value in the tiles layer, from version 3.
+// The spawn table lists each of these tiles, so a reader can check that none of them is missing from the table
+struct MapFileValueCount {
+	unsigned short usValue;
+	unsigned short usReserved;
+	unsigned int uiCount;
+};
+
+class CMapFile
+{
+public:
+	// The layers stored in a map file
+	enum LAYER
+	{
+		LAYER_TILES = 0,
+		LAYER_BACKGROUND,
+		NUM_LAYERS
+	};
+
+	// The "MAP2" tag at the start of every map file
+	static const unsigned int MAGIC = 0x3250414D;
+	// The version of the format written by Write()
+	static const unsigned short VERSION = 3;
+
+	// Constructor
+	CMapFile(void);
+
+	// Destructor
+	~CMapFile(void);
+
+	// Map a map file into memory and check that it is valid
+	bool Open(const std::string& filename);
+
+	// Unmap the map file
+	void Close(void);
+
+	// Get the number of rows in the map
+	unsigned int GetNumRows(void) const;
+	// Get the number of columns in the map
+	unsigned int GetNumCols(void) const;
+	// Get the version of the format of the map file
+	unsigned short GetVersion(void) const;
+
+	// Get the tiles of a layer, or NULL if the file does not have this layer
+	const unsigned short* GetLayer(const unsigned int uiLayer) const;
+
+	// Get the number of spawn points
+	unsigned int GetNumSpawns(void) const;
+	// Get the spawn points
+	const MapFileSpawn* GetSpawns(void) const;
+
+	// Get the number of value counts
+	unsigned int GetNumValueCounts(void) const;
+	// Get the value counts
+	const MapFileValueCount* GetValueCounts(void) const;
+
+	// Write a map to a map file
+	static bool Write(	const std::string& filename,
+						const unsigned int uiNumRows,
+						const unsigned int uiNumCols,
+						const unsigned short* const* arrLayers,
+						const unsigned short usNumLayers,
+						const std::vector<MapFileSpawn>& vecSpawns,
+						const std::vector<MapFileValueCount>& vecValueCounts);
+
+protected:
+	// The mapped file
+	CMemoryMappedFile cFile;
+	// The header of the mapped file, or NULL if no file is open
+	const MapFileHeader* pHeader;
+};
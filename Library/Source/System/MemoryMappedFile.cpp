@@ -0,0 +1,160 @@
+/**
+ CMemoryMappedFile
+ @brief A class which maps a file into memory as read-only, so that it can be read without copying it into a buffer first
+ By: JH Chong
+ Date: Aug 2022
+ */
+#include "MemoryMappedFile.h"
+
+#ifdef _WIN32
+	#include <Windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+#include <iostream>
+using namespace std;
+
+/**
+ @brief Constructor
+ */
+CMemoryMappedFile::CMemoryMappedFile(void)
+	: pData(NULL)
+	, size(0)
+#ifdef _WIN32
+	, hFile(INVALID_HANDLE_VALUE)
+	, hMapping(NULL)
+#else
+	, iFile(-1)
+#endif
+{
+}
+
+/**
+ @brief Destructor
+ */
+CMemoryMappedFile::~CMemoryMappedFile(void)
+{
+	Close();
+}
+
+/**
+ @brief Map a file into memory
+ @param filename A const std::string& variable containing the name of the file to map
+ @return true if the file was mapped, otherwise false
+ */
+bool CMemoryMappedFile::Open(const std::string& filename)
+{
+	Close();
+
+#ifdef _WIN32
+	hFile = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, 
+						OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (hFile == INVALID_HANDLE_VALUE)
+	{
+		cout << "CMemoryMappedFile::Open() : Unable to open " << filename << endl;
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+	if ((GetFileSizeEx(hFile, &fileSize) == FALSE) || (fileSize.QuadPart == 0))
+	{
+		cout << "CMemoryMappedFile::Open() : " << filename << " is empty" << endl;
+		Close();
+		return false;
+	}
+	size = (size_t)fileSize.QuadPart;
+
+	hMapping = CreateFileMappingA(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (hMapping == NULL)
+	{
+		cout << "CMemoryMappedFile::Open() : Unable to map " << filename << endl;
+		Close();
+		return false;
+	}
+
+	pData = (const unsigned char*)MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+#else
+	iFile = open(filename.c_str(), O_RDONLY);
+	if (iFile < 0)
+	{
+		cout << "CMemoryMappedFile::Open() : Unable to open " << filename << endl;
+		return false;
+	}
+
+	struct stat fileStat;
+	if ((fstat(iFile, &fileStat) != 0) || (fileStat.st_size == 0))
+	{
+		cout << "CMemoryMappedFile::Open() : " << filename << " is empty" << endl;
+		Close();
+		return false;
+	}
+	size = (size_t)fileStat.st_size;
+
+	void* pMapped = mmap(NULL, size, PROT_READ, MAP_PRIVATE, iFile, 0);
+	if (pMapped != MAP_FAILED)
+		pData = (const unsigned char*)pMapped;
+#endif
+
+	if (pData == NULL)
+	{
+		cout << "CMemoryMappedFile::Open() : Unable to map " << filename << endl;
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ @brief Unmap the file
+ */
+void CMemoryMappedFile::Close(void)
+{
+#ifdef _WIN32
+	if (pData)
+		UnmapViewOfFile(pData);
+	if (hMapping)
+		CloseHandle(hMapping);
+	if (hFile != INVALID_HANDLE_VALUE)
+		CloseHandle(hFile);
+	hMapping = NULL;
+	hFile = INVALID_HANDLE_VALUE;
+#else
+	if (pData)
+		munmap((void*)pData, size);
+	if (iFile >= 0)
+		close(iFile);
+	iFile = -1;
+#endif
+
+	pData = NULL;
+	size = 0;
+}
+
+/**
+ @brief Check if a file is mapped
+ */
+bool CMemoryMappedFile::IsOpen(void) const
+{
+	return (pData != NULL);
+}
+
+/**
+ @brief Get the contents of the file
+ */
+const unsigned char* CMemoryMappedFile::GetData(void) const
+{
+	return pData;
+}
+
+/**
+ @brief Get the size of the file in bytes
+ */
+size_t CMemoryMappedFile::GetSize(void) const
+{
+	return size;
+}
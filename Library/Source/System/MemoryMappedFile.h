@@ -0,0 +1,53 @@
+/**
+ CMemoryMappedFile
+ @brief A class which maps a file into memory as read-only, so that it can be read without copying it into a buffer first
+ By: JH Chong
+ Date: Aug 2022
+ */
+#pragma once
+
+#include <string>
+
+class CMemoryMappedFile
+{
+public:
+	// Constructor
+	CMemoryMappedFile(void);
+
+	// Destructor
+	~CMemoryMappedFile(void);
+
+	// Map a file into memory
+	bool Open(const std::string& filename);
+
+	// Unmap the file
+	void Close(void);
+
+	// Check if a file is mapped
+	bool IsOpen(void) const;
+
+	// Get the contents of the file
+	const unsigned char* GetData(void) const;
+
+	// Get the size of the file in bytes
+	size_t GetSize(void) const;
+
+protected:
+	// The contents of the file
+	const unsigned char* pData;
+	// The size of the file in bytes
+	size_t size;
+
+#ifdef _WIN32
+	// The handles of the file and its mapping
+	void* hFile;
+	void* hMapping;
+#else
+	// The file descriptor
+	int iFile;
+#endif
+
+	// This class owns the mapping, so it is not copied
+	CMemoryMappedFile(const CMemoryMappedFile&);
+	CMemoryMappedFile& operator=(const CMemoryMappedFile&);
+};
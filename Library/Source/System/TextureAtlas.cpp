@@ -0,0 +1,249 @@
+/**
+ CTextureAtlas
+ @brief A class which packs many images into one texture at load time, so that
+		quads using different images can be drawn with the same texture bound
+ By: JH Chong
+ Date: Aug 2022
+ */
+#include "TextureAtlas.h"
+
+// Include GLEW
+#ifndef GLEW_STATIC
+#include <GL/glew.h>
+#define GLEW_STATIC
+#endif
+
+// Include ImageLoader
+#include "ImageLoader.h"
+// STB Image, which is implemented in ImageLoader.cpp
+#include <includes/stb_image.h>
+
+// STB Rect Pack, which is bundled with IMGUI. Keep our own copy of the implementation in this file
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+#include "../GUI/imstb_rectpack.h"
+
+#include <iostream>
+using namespace std;
+
+/**
+ @brief Constructor
+ */
+CTextureAtlas::CTextureAtlas(void)
+	: iAtlasWidth(0)
+	, iAtlasHeight(0)
+	, uiTextureID(0)
+{
+}
+
+/**
+ @brief Destructor
+ */
+CTextureAtlas::~CTextureAtlas(void)
+{
+	if (uiTextureID != 0)
+	{
+		glDeleteTextures(1, &uiTextureID);
+		uiTextureID = 0;
+	}
+}
+
+/**
+ @brief Add an image to be packed into this atlas, and identify it by iKey
+ @param iKey A const int variable which identifies this image, e.g. a tile value
+ @param filename A const char* storing the name of the image file
+ @param bInvert A const bool variable which indicates if the image should be flipped on the y-axis
+ @return true if the image was loaded, otherwise false
+ */
+bool CTextureAtlas::AddImage(const int iKey, const char* filename, const bool bInvert)
+{
+	// If this file was loaded before, then let this key share it
+	for (unsigned int i = 0; i < images.size(); i++)
+	{
+		if (images[i].filename == filename)
+		{
+			mapOfKeys[iKey] = i;
+			return true;
+		}
+	}
+
+	int iWidth = 0, iHeight = 0, nrChannels = 0;
+	unsigned char* data = CImageLoader::GetInstance().Load(filename, iWidth, iHeight, nrChannels, bInvert);
+	if (data == NULL)
+	{
+		cout << "CTextureAtlas::AddImage(): Unable to load " << filename << endl;
+		return false;
+	}
+
+	AtlasImage image;
+	image.filename = filename;
+	image.iWidth = iWidth;
+	image.iHeight = iHeight;
+	image.iPosX = 0;
+	image.iPosY = 0;
+
+	// Convert the image to RGBA, so that every image in the atlas has the same format
+	image.pixels.resize(iWidth * iHeight * 4);
+	for (int i = 0; i < iWidth * iHeight; i++)
+	{
+		unsigned char* pixel = &image.pixels[i * 4];
+		const unsigned char* source = &data[i * nrChannels];
+		if (nrChannels == 1)
+		{
+			pixel[0] = pixel[1] = pixel[2] = source[0];
+			pixel[3] = 255;
+		}
+		else
+		{
+			pixel[0] = source[0];
+			pixel[1] = source[1];
+			pixel[2] = source[2];
+			pixel[3] = (nrChannels == 4) ? source[3] : 255;
+		}
+	}
+	stbi_image_free(data);
+
+	mapOfKeys[iKey] = (unsigned int)images.size();
+	images.push_back(image);
+
+	return true;
+}
+
+/**
+ @brief Pack the images into an atlas of this size
+ @return true if all the images fit into the atlas, otherwise false
+ */
+bool CTextureAtlas::Pack(const int iWidth, const int iHeight, const int iPadding)
+{
+	vector<stbrp_rect> rects(images.size());
+	for (unsigned int i = 0; i < images.size(); i++)
+	{
+		rects[i].id = (int)i;
+		rects[i].w = (stbrp_coord)(images[i].iWidth + iPadding * 2);
+		rects[i].h = (stbrp_coord)(images[i].iHeight + iPadding * 2);
+	}
+
+	vector<stbrp_node> nodes(iWidth);
+	stbrp_context context;
+	stbrp_init_target(&context, iWidth, iHeight, &nodes[0], (int)nodes.size());
+	if (stbrp_pack_rects(&context, &rects[0], (int)rects.size()) == 0)
+		return false;
+
+	for (unsigned int i = 0; i < rects.size(); i++)
+	{
+		images[rects[i].id].iPosX = rects[i].x + iPadding;
+		images[rects[i].id].iPosY = rects[i].y + iPadding;
+	}
+	return true;
+}
+
+/**
+ @brief Pack all the added images into one texture and upload it to the graphics card
+ @param iMaxSize A const int variable containing the largest width or height of the atlas
+ @param iPadding A const int variable containing the number of pixels around each image.
+		The padding repeats the edge pixels of the image so that filtering does not bleed into other images
+ @return true if the atlas was built, otherwise false
+ */
+bool CTextureAtlas::Build(const int iMaxSize, const int iPadding)
+{
+	if (images.empty())
+	{
+		cout << "CTextureAtlas::Build(): No images to pack" << endl;
+		return false;
+	}
+
+	// Start with a small atlas and grow it until all the images fit
+	iAtlasWidth = 64;
+	iAtlasHeight = 64;
+	while (Pack(iAtlasWidth, iAtlasHeight, iPadding) == false)
+	{
+		if (iAtlasWidth <= iAtlasHeight)
+			iAtlasWidth *= 2;
+		else
+			iAtlasHeight *= 2;
+
+		if ((iAtlasWidth > iMaxSize) || (iAtlasHeight > iMaxSize))
+		{
+			cout << "CTextureAtlas::Build(): Images do not fit into a " << iMaxSize << "x" << iMaxSize << " atlas" << endl;
+			return false;
+		}
+	}
+
+	// Copy the images into the atlas, including the padding
+	vector<unsigned char> atlas(iAtlasWidth * iAtlasHeight * 4, 0);
+	for (unsigned int i = 0; i < images.size(); i++)
+	{
+		const AtlasImage& image = images[i];
+		for (int y = -iPadding; y < image.iHeight + iPadding; y++)
+		{
+			const int iSourceY = glm::clamp(y, 0, image.iHeight - 1);
+			for (int x = -iPadding; x < image.iWidth + iPadding; x++)
+			{
+				const int iSourceX = glm::clamp(x, 0, image.iWidth - 1);
+				const unsigned char* source = &image.pixels[(iSourceY * image.iWidth + iSourceX) * 4];
+				unsigned char* target = &atlas[((image.iPosY + y) * iAtlasWidth + (image.iPosX + x)) * 4];
+				target[0] = source[0];
+				target[1] = source[1];
+				target[2] = source[2];
+				target[3] = source[3];
+			}
+		}
+	}
+
+	// The pixels are now in the atlas, so release them
+	for (unsigned int i = 0; i < images.size(); i++)
+		vector<unsigned char>().swap(images[i].pixels);
+
+	// Upload the atlas into the graphics card
+	if (uiTextureID == 0)
+		glGenTextures(1, &uiTextureID);
+	glBindTexture(GL_TEXTURE_2D, uiTextureID);
+
+	// No mipmaps, as they would blend neighbouring images together
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+#if defined(GL_UNPACK_ROW_LENGTH)
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+#endif
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, iAtlasWidth, iAtlasHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, &atlas[0]);
+
+	return true;
+}
+
+/**
+ @brief Get the texture ID of this atlas
+ */
+unsigned int CTextureAtlas::GetTextureID(void) const
+{
+	return uiTextureID;
+}
+
+/**
+ @brief Check if an image has been added with this key
+ */
+bool CTextureAtlas::HasImage(const int iKey) const
+{
+	return mapOfKeys.find(iKey) != mapOfKeys.end();
+}
+
+/**
+ @brief Get the UV coordinates of an image in this atlas
+ @param iKey A const int variable which identifies the image
+ @param vec2UVMin A glm::vec2& variable which stores the UV coordinates of the bottom-left corner
+ @param vec2UVMax A glm::vec2& variable which stores the UV coordinates of the top-right corner
+ @return true if the image was found, otherwise false
+ */
+bool CTextureAtlas::GetUVRect(const int iKey, glm::vec2& vec2UVMin, glm::vec2& vec2UVMax) const
+{
+	map<int, unsigned int>::const_iterator iter = mapOfKeys.find(iKey);
+	if ((iter == mapOfKeys.end()) || (iAtlasWidth == 0) || (iAtlasHeight == 0))
+		return false;
+
+	const AtlasImage& image = images[iter->second];
+	vec2UVMin = glm::vec2((float)image.iPosX / iAtlasWidth, (float)image.iPosY / iAtlasHeight);
+	vec2UVMax = glm::vec2((float)(image.iPosX + image.iWidth) / iAtlasWidth, (float)(image.iPosY + image.iHeight) / iAtlasHeight);
+	return true;
+}
@@ -0,0 +1,68 @@
+/**
+ CTextureAtlas
+ @brief A class which packs many images into one texture at load time, so that
+		quads using different images can be drawn with the same texture bound
+ By: JH Chong
+ Date: Aug 2022
+ */
+#pragma once
+
+// Include GLM
+#include <includes/glm.hpp>
+
+#include <map>
+#include <string>
+#include <vector>
+
+class CTextureAtlas
+{
+public:
+	// Constructor
+	CTextureAtlas(void);
+
+	// Destructor
+	~CTextureAtlas(void);
+
+	// Add an image to be packed into this atlas, and identify it by iKey
+	bool AddImage(const int iKey, const char* filename, const bool bInvert);
+
+	// Pack all the added images into one texture and upload it to the graphics card
+	bool Build(const int iMaxSize = 4096, const int iPadding = 2);
+
+	// Get the texture ID of this atlas
+	unsigned int GetTextureID(void) const;
+
+	// Check if an image has been added with this key
+	bool HasImage(const int iKey) const;
+
+	// Get the UV coordinates of an image in this atlas
+	bool GetUVRect(const int iKey, glm::vec2& vec2UVMin, glm::vec2& vec2UVMax) const;
+
+protected:
+	// An image which is packed into this atlas
+	struct AtlasImage {
+		std::string filename;
+		int iWidth;
+		int iHeight;
+		// The pixels of the image in RGBA format. It is released after Build()
+		std::vector<unsigned char> pixels;
+		// The position of the image in the atlas, in pixels
+		int iPosX;
+		int iPosY;
+	};
+
+	// The images in this atlas
+	std::vector<AtlasImage> images;
+	// Map the keys to the indices in images. Many keys can share the same image
+	std::map<int, unsigned int> mapOfKeys;
+
+	// The width and height of the atlas, in pixels
+	int iAtlasWidth;
+	int iAtlasHeight;
+
+	// The texture ID in OpenGL
+	unsigned int uiTextureID;
+
+	// Pack the images into an atlas of this size
+	bool Pack(const int iWidth, const int iHeight, const int iPadding);
+};
@@ -0,0 +1,164 @@
+/**
+ CWorkerPool
+ @brief Runs a loop over many items on a pool of worker threads and the calling thread, and returns when it is done.
+		The items are split into contiguous chunks, which are the same for the same number of items and chunks,
+		so a caller which keeps one buffer of results for each chunk can join them in the order of the items
+		no matter which thread ran each chunk.
+ By: JH Chong
+ Date: Aug 2022
+ */
+#include "WorkerPool.h"
+
+/**
+ @brief Constructor
+ */
+CWorkerPool::CWorkerPool(void)
+	: bStopping(false)
+	, uiNumLoops(0)
+	, pChunkTask(NULL)
+	, uiNumChunks(0)
+	, uiNextChunk(0)
+	, uiNumChunksDone(0)
+{
+}
+
+/**
+ @brief Destructor
+ */
+CWorkerPool::~CWorkerPool(void)
+{
+	Destroy();
+}
+
+/**
+ @brief Start the worker threads
+ @param uiNumWorkers A const unsigned int variable containing the number of workers,
+		or 0 to start one for each hardware thread except the one running the game
+ */
+void CWorkerPool::Init(const unsigned int uiNumWorkers)
+{
+	Destroy();
+
+	unsigned int uiWorkers = uiNumWorkers;
+	if (uiWorkers == 0)
+	{
+		const unsigned int uiHardwareThreads = std::thread::hardware_concurrency();
+		uiWorkers = (uiHardwareThreads > 1) ? uiHardwareThreads - 1 : 0;
+	}
+
+	bStopping = false;
+	for (unsigned int i = 0; i < uiWorkers; i++)
+		vecWorkers.push_back(std::thread(&CWorkerPool::RunWorker, this));
+}
+
+/**
+ @brief Stop the worker threads. A loop must not be running
+ */
+void CWorkerPool::Destroy(void)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutexWork);
+		bStopping = true;
+	}
+	cvWorkStarted.notify_all();
+
+	for (unsigned int i = 0; i < vecWorkers.size(); i++)
+		vecWorkers[i].join();
+	vecWorkers.clear();
+}
+
+/**
+ @brief Get the number of threads which run the chunks, including the calling thread
+ */
+unsigned int CWorkerPool::GetNumThreads(void) const
+{
+	return (unsigned int)vecWorkers.size() + 1;
+}
+
+/**
+ @brief Get the number of chunks which a loop over a number of items is split into, which is one for each thread
+		unless there are too few items
+ @param uiNumItems A const unsigned int variable containing the number of items
+ @param uiMinItemsPerChunk A const unsigned int variable containing the fewest items in a chunk
+ @return The number of chunks, which is at least 1
+ */
+unsigned int CWorkerPool::GetNumChunks(const unsigned int uiNumItems, const unsigned int uiMinItemsPerChunk) const
+{
+	const unsigned int uiMaxChunks = (uiMinItemsPerChunk > 0) ? uiNumItems / uiMinItemsPerChunk : uiNumItems;
+	if (uiMaxChunks <= 1)
+		return 1;
+	return (uiMaxChunks < GetNumThreads()) ? uiMaxChunks : GetNumThreads();
+}
+
+/**
+ @brief Run a number of chunks on the workers and the calling thread, and wait for them to finish.
+		A single chunk, or a pool without workers, runs the chunks on the calling thread only
+ @param uiNumChunks A const unsigned int variable containing the number of chunks
+ @param chunkTask A const std::function<void(unsigned int)>& variable containing the task which is called with each chunk
+ */
+void CWorkerPool::Run(const unsigned int uiNumChunks, const std::function<void(unsigned int)>& chunkTask)
+{
+	if ((uiNumChunks <= 1) || (vecWorkers.empty()))
+	{
+		for (unsigned int uiChunk = 0; uiChunk < uiNumChunks; uiChunk++)
+			chunkTask(uiChunk);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutexWork);
+		pChunkTask = &chunkTask;
+		this->uiNumChunks = uiNumChunks;
+		uiNextChunk = 0;
+		uiNumChunksDone = 0;
+		uiNumLoops++;
+	}
+	cvWorkStarted.notify_all();
+
+	RunChunks();
+
+	std::unique_lock<std::mutex> lock(mutexWork);
+	cvWorkFinished.wait(lock, [this] { return uiNumChunksDone == this->uiNumChunks; });
+	pChunkTask = NULL;
+}
+
+/**
+ @brief Take and run the chunks of the current loop until there are none left
+ */
+void CWorkerPool::RunChunks(void)
+{
+	std::unique_lock<std::mutex> lock(mutexWork);
+	while (uiNextChunk < uiNumChunks)
+	{
+		const unsigned int uiChunk = uiNextChunk++;
+		const std::function<void(unsigned int)>& chunkTask = *pChunkTask;
+		lock.unlock();
+
+		chunkTask(uiChunk);
+
+		lock.lock();
+		if (++uiNumChunksDone == uiNumChunks)
+			cvWorkFinished.notify_all();
+	}
+}
+
+/**
+ @brief The loop of each worker thread, which joins each loop once when it is started
+ */
+void CWorkerPool::RunWorker(void)
+{
+	unsigned int uiLastLoop = 0;
+
+	std::unique_lock<std::mutex> lock(mutexWork);
+	for (;;)
+	{
+		cvWorkStarted.wait(lock, [&] { return bStopping || (uiNumLoops != uiLastLoop); });
+		if (bStopping)
+			return;
+
+		uiLastLoop = uiNumLoops;
+		lock.unlock();
+		RunChunks();
+		lock.lock();
+	}
+}
@@ -0,0 +1,87 @@
+/**
+ CWorkerPool
+ @brief Runs a loop over many items on a pool of worker threads and the calling thread, and returns when it is done.
+		The items are split into contiguous chunks, which are the same for the same number of items and chunks,
+		so a caller which keeps one buffer of results for each chunk can join them in the order of the items
+		no matter which thread ran each chunk.
+ By: JH Chong
+ Date: Aug 2022
+ */
+#pragma once
+
+#include <vector>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+class CWorkerPool
+{
+public:
+	// Constructor
+	CWorkerPool(void);
+
+	// Destructor
+	virtual ~CWorkerPool(void);
+
+	// Start the worker threads. 0 workers starts one for each hardware thread, except the one running the game
+	void Init(const unsigned int uiNumWorkers = 0);
+
+	// Stop the worker threads
+	void Destroy(void);
+
+	// Get the number of threads which run the chunks, including the calling thread
+	unsigned int GetNumThreads(void) const;
+
+	// Get the number of chunks which a loop over a number of items is split into
+	unsigned int GetNumChunks(const unsigned int uiNumItems, const unsigned int uiMinItemsPerChunk) const;
+
+	// Run a loop over a number of items in chunks, and wait for all the chunks to finish
+	template <typename Task>
+	void ParallelFor(const unsigned int uiNumItems, const unsigned int uiMinItemsPerChunk, const Task& task);
+
+protected:
+	std::vector<std::thread> vecWorkers;
+	bool bStopping;
+
+	// Guards all the members below
+	std::mutex mutexWork;
+	// Signalled when a loop is started, or the workers are stopping
+	std::condition_variable cvWorkStarted;
+	// Signalled when the last chunk of a loop finishes
+	std::condition_variable cvWorkFinished;
+	// The number of loops which have been started, so that a worker only joins each loop once
+	unsigned int uiNumLoops;
+	// The chunk task of the current loop, and its chunks
+	const std::function<void(unsigned int)>* pChunkTask;
+	unsigned int uiNumChunks;
+	unsigned int uiNextChunk;
+	unsigned int uiNumChunksDone;
+
+	// Run a number of chunks on the workers and the calling thread, and wait for them to finish
+	void Run(const unsigned int uiNumChunks, const std::function<void(unsigned int)>& chunkTask);
+	// Take and run the chunks of the current loop until there are none left
+	void RunChunks(void);
+	// The loop of each worker thread
+	void RunWorker(void);
+};
+
+/**
+ @brief Run a loop over a number of items in chunks, and wait for all the chunks to finish.
+		The task must only write to the items of its chunk, or to the buffer of its chunk
+ @param uiNumItems A const unsigned int variable containing the number of items
+ @param uiMinItemsPerChunk A const unsigned int variable containing the fewest items in a chunk,
+		so that a loop over a few items runs on the calling thread without waking the workers
+ @param task A const Task& variable containing a function object which is called with the first item,
+		the item after the last item, and the number of the chunk, from 0 to GetNumChunks() - 1
+ */
+template <typename Task>
+void CWorkerPool::ParallelFor(const unsigned int uiNumItems, const unsigned int uiMinItemsPerChunk, const Task& task)
+{
+	const unsigned int uiNumLoopChunks = GetNumChunks(uiNumItems, uiMinItemsPerChunk);
+	const std::function<void(unsigned int)> chunkTask = [&](const unsigned int uiChunk)
+	{
+		task(uiChunk * uiNumItems / uiNumLoopChunks, (uiChunk + 1) * uiNumItems / uiNumLoopChunks, uiChunk);
+	};
+	Run(uiNumLoopChunks, chunkTask);
+}
@@ -0,0 +1,102 @@
+/**
+ MapConverter
+ @brief A command line tool which converts CSV tile maps into binary map files, which CMap2D::LoadMap() 
+		loads when the file name ends with .map
+		Usage: MapConverter <input.csv> <output.map>
+ By: JH Chong
+ Date: Aug 2022
+ */
+
+// Include the RapidCSV
+#include "System/rapidcsv.h"
+// Include the binary map format
+#include "System/MapFile.h"
+// Include TileRules
+#include "Scene2D/TileRules.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+using namespace std;
+
+int main(int argc, char* argv[])
+{
+	if (argc != 3)
+	{
+		cout << "Usage: MapConverter <input.csv> <output.map>" << endl;
+		return 1;
+	}
+
+	// Read the CSV file. The first line of the map files is a header, the same as in CMap2D::LoadMap()
+	rapidcsv::Document doc;
+	try
+	{
+		doc = rapidcsv::Document(argv[1]);
+	}
+	catch (const exception& e)
+	{
+		cout << "Unable to read " << argv[1] << ": " << e.what() << endl;
+		return 1;
+	}
+
+	const unsigned int uiNumRows = (unsigned int)doc.GetRowCount();
+	const unsigned int uiNumCols = (unsigned int)doc.GetColumnCount();
+	if ((uiNumRows == 0) || (uiNumCols == 0))
+	{
+		cout << argv[1] << " has no tiles" << endl;
+		return 1;
+	}
+
+	// Convert the cells into the tile and background layers, and collect the spawn points and the other indexed tiles
+	vector<TileValue> vecTiles((size_t)uiNumRows * uiNumCols);
+	vector<TileValue> vecBackground((size_t)uiNumRows * uiNumCols);
+	vector<MapFileSpawn> vecSpawns;
+	vector<MapFileValueCount> vecValueCounts;
+	for (unsigned int i = 0; i < TileRules::NUM_INDEXED_VALUES; i++)
+	{
+		MapFileValueCount count = { TileRules::INDEXED_VALUES[i], 0, 0 };
+		vecValueCounts.push_back(count);
+	}
+	for (unsigned int uiRow = 0; uiRow < uiNumRows; uiRow++)
+	{
+		vector<string> row = doc.GetRow<string>(uiRow);
+		if (row.size() < uiNumCols)
+		{
+			cout << "Row " << uiRow << " of " << argv[1] << " has " << row.size() << " columns instead of " << uiNumCols << endl;
+			return 1;
+		}
+
+		TileValue* pRow = &vecTiles[(size_t)uiRow * uiNumCols];
+		for (unsigned int uiCol = 0; uiCol < uiNumCols; uiCol++)
+		{
+			const int iValue = atoi(row[uiCol].c_str());
+			if ((iValue < 0) || (iValue > 0xFFFF))
+			{
+				cout << "Tile value " << iValue << " at row " << uiRow << ", column " << uiCol << " is out of range" << endl;
+				return 1;
+			}
+			pRow[uiCol] = (TileValue)iValue;
+
+			if (TileRules::IsIndexed(pRow[uiCol]))
+			{
+				MapFileSpawn spawn = { pRow[uiCol], 0, uiRow, uiCol };
+				vecSpawns.push_back(spawn);
+				for (unsigned int i = 0; i < vecValueCounts.size(); i++)
+				{
+					if (vecValueCounts[i].usValue == pRow[uiCol])
+						vecValueCounts[i].uiCount++;
+				}
+			}
+		}
+
+		TileRules::BuildBackgroundRow(pRow, &vecBackground[(size_t)uiRow * uiNumCols], uiNumCols);
+	}
+
+	const unsigned short* arrLayers[CMapFile::NUM_LAYERS] = { &vecTiles[0], &vecBackground[0] };
+	if (CMapFile::Write(argv[2], uiNumRows, uiNumCols, arrLayers, CMapFile::NUM_LAYERS, vecSpawns, vecValueCounts) == false)
+		return 1;
+
+	cout << "Converted " << argv[1] << " (" << uiNumCols << "x" << uiNumRows << ", " 
+		<< vecSpawns.size() << " spawns and items) to " << argv[2] << endl;
+	return 0;
+}
@@ -0,0 +1,478 @@
+/**
+ PathBenchmark
+ @brief A command line tool which measures the path finding of the game, without a window or an OpenGL context.
+		The shipped map and generated maps of several sizes are turned into a CNavGrid with the same rules as CMap2D, 
+		and batches of random queries are run with each heuristic, in 4 and 8 directions, and with hierarchical path finding.
+		For each batch, it reports the nodes expanded per query, the time per expanded node, 
+		the median and 99th percentile time per query, and the heap allocations per query after a warm up query.
+		The time to build the clusters of hierarchical path finding is reported on its own line, and left out of its queries.
+		Usage: PathBenchmark [map.csv] [--quick]
+		--quick leaves out the largest maps
+ By: JH Chong
+ Date: Aug 2022
+ */
+
+// Include the RapidCSV
+#include "System/rapidcsv.h"
+// Include TileRules
+#include "Scene2D/TileRules.h"
+// Include the path finding
+#include "Pathfinding/NavGrid.h"
+#include "Pathfinding/AStar.h"
+#include "Pathfinding/HPAStar.h"
+#include "Pathfinding/Heuristics.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <new>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+using namespace std;
+
+// The number of heap allocations since the start of the program. The benchmark runs on one thread
+static unsigned long long ullNumAllocations = 0;
+
+void* operator new(size_t size)
+{
+	ullNumAllocations++;
+	void* p = malloc(size ? size : 1);
+	if (p == NULL)
+		throw bad_alloc();
+	return p;
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void* p) noexcept
+{
+	free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+	free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+	free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept
+{
+	free(p);
+}
+
+// Tile values which the generated maps are made of
+static const TileValue TILE_SKY = 1;
+static const TileValue TILE_LADDER_TOP = 30;
+static const TileValue TILE_LADDER = 35;
+static const TileValue TILE_GROUND = 100;
+static const TileValue TILE_CLOUD = 115;
+
+// A map to run queries on, with its tiles stored from the top row down, like arrMapInfo in CMap2D
+struct BenchmarkMap
+{
+	string sName;
+	unsigned int uiNumRows;
+	unsigned int uiNumCols;
+	vector<TileValue> vecTiles;
+	// If true, the starts are on the left half of the map and the goals on the right half, which cannot be reached
+	bool bSplit;
+};
+
+// The results of a batch of queries
+struct BatchResult
+{
+	unsigned int uiNumFound;
+	unsigned long long ullNumExpanded;
+	double dTotalNs;
+	vector<double> vecLatenciesNs;
+	unsigned long long ullNumAllocations;
+	// The time to prepare the queries, such as building the clusters, which is not in the times of the queries
+	double dSetupNs;
+};
+
+/**
+ @brief Load a CSV map. The first line of the map files is a header, the same as in CMap2D::LoadMap()
+ @param sFilename A const string& variable containing the file name
+ @param map A BenchmarkMap& variable to store the map
+ @return true if the map was loaded, otherwise false
+ */
+static bool LoadMap(const string& sFilename, BenchmarkMap& map)
+{
+	rapidcsv::Document doc;
+	try
+	{
+		doc = rapidcsv::Document(sFilename);
+	}
+	catch (const exception& e)
+	{
+		cout << "Unable to read " << sFilename << ": " << e.what() << endl;
+		return false;
+	}
+
+	map.sName = sFilename.substr(sFilename.find_last_of("/\\") + 1);
+	map.uiNumRows = (unsigned int)doc.GetRowCount();
+	map.uiNumCols = (unsigned int)doc.GetColumnCount();
+	map.bSplit = false;
+	map.vecTiles.assign((size_t)map.uiNumRows * map.uiNumCols, 0);
+	for (unsigned int uiRow = 0; uiRow < map.uiNumRows; uiRow++)
+	{
+		vector<string> row = doc.GetRow<string>(uiRow);
+		for (unsigned int uiCol = 0; (uiCol < map.uiNumCols) && (uiCol < row.size()); uiCol++)
+			map.vecTiles[(size_t)uiRow * map.uiNumCols + uiCol] = (TileValue)atoi(row[uiCol].c_str());
+	}
+	return (map.uiNumRows > 0) && (map.uiNumCols > 0);
+}
+
+/**
+ @brief Generate an open field, where every tile can be moved through in any direction, with a few solid tiles in the way
+ */
+static void GenerateOpenField(const unsigned int uiNumCols, const unsigned int uiNumRows, mt19937& rng, BenchmarkMap& map)
+{
+	map.sName = "open";
+	map.uiNumRows = uiNumRows;
+	map.uiNumCols = uiNumCols;
+	map.bSplit = false;
+	map.vecTiles.assign((size_t)uiNumRows * uiNumCols, TILE_LADDER);
+	uniform_int_distribution<int> percent(0, 99);
+	for (size_t i = 0; i < map.vecTiles.size(); i++)
+	{
+		if (percent(rng) < 10)
+			map.vecTiles[i] = TILE_CLOUD;
+	}
+}
+
+/**
+ @brief Generate a maze of corridors one tile wide, which can be moved through in any direction, with a depth first search
+ */
+static void GenerateMaze(const unsigned int uiNumCols, const unsigned int uiNumRows, mt19937& rng, BenchmarkMap& map)
+{
+	map.sName = "maze";
+	map.uiNumRows = uiNumRows;
+	map.uiNumCols = uiNumCols;
+	map.bSplit = false;
+	map.vecTiles.assign((size_t)uiNumRows * uiNumCols, TILE_CLOUD);
+
+	// The rooms are the tiles at odd rows and columns, and the walls between them are knocked down
+	const int iRoomsX = (uiNumCols - 1) / 2;
+	const int iRoomsY = (uiNumRows - 1) / 2;
+	vector<bool> vecVisited(iRoomsX * iRoomsY, false);
+	vector<int> vecStack(1, 0);
+	vecVisited[0] = true;
+	map.vecTiles[(size_t)1 * uiNumCols + 1] = TILE_LADDER;
+	while (!vecStack.empty())
+	{
+		const int iRoom = vecStack.back();
+		const int iX = iRoom % iRoomsX;
+		const int iY = iRoom / iRoomsX;
+
+		int arrNeighbours[4];
+		int iNumNeighbours = 0;
+		for (unsigned int uiDirection = 0; uiDirection < 4; uiDirection++)
+		{
+			const int iNX = iX + CNavGrid::DIRECTION_X[uiDirection];
+			const int iNY = iY + CNavGrid::DIRECTION_Y[uiDirection];
+			if ((iNX >= 0) && (iNX < iRoomsX) && (iNY >= 0) && (iNY < iRoomsY) && (!vecVisited[iNY * iRoomsX + iNX]))
+				arrNeighbours[iNumNeighbours++] = iNY * iRoomsX + iNX;
+		}
+		if (iNumNeighbours == 0)
+		{
+			vecStack.pop_back();
+			continue;
+		}
+
+		const int iNext = arrNeighbours[uniform_int_distribution<int>(0, iNumNeighbours - 1)(rng)];
+		const int iNextX = iNext % iRoomsX;
+		const int iNextY = iNext / iRoomsX;
+		map.vecTiles[(size_t)(iY + iNextY + 1) * uiNumCols + (iX + iNextX + 1)] = TILE_LADDER;
+		map.vecTiles[(size_t)(2 * iNextY + 1) * uiNumCols + (2 * iNextX + 1)] = TILE_LADDER;
+		vecVisited[iNext] = true;
+		vecStack.push_back(iNext);
+	}
+}
+
+/**
+ @brief Generate tiers of platforms with gaps to fall through, joined by ladders
+ */
+static void GeneratePlatforms(const unsigned int uiNumCols, const unsigned int uiNumRows, mt19937& rng, BenchmarkMap& map)
+{
+	map.sName = "platforms";
+	map.uiNumRows = uiNumRows;
+	map.uiNumCols = uiNumCols;
+	map.bSplit = false;
+	map.vecTiles.assign((size_t)uiNumRows * uiNumCols, TILE_SKY);
+
+	const unsigned int TIER_HEIGHT = 4;
+	uniform_int_distribution<int> percent(0, 99);
+	for (unsigned int uiRow = uiNumRows - 1; uiRow >= TIER_HEIGHT; uiRow -= TIER_HEIGHT)
+	{
+		TileValue* pRow = &map.vecTiles[(size_t)uiRow * uiNumCols];
+		for (unsigned int uiCol = 0; uiCol < uiNumCols; uiCol++)
+		{
+			// The bottom row has no gaps
+			const int iPercent = percent(rng);
+			if ((uiRow != uiNumRows - 1) && (iPercent < 4))
+				continue;
+			pRow[uiCol] = TILE_GROUND;
+
+			// A ladder from this platform up to the next one, through a ladder top in the next platform
+			if ((iPercent >= 96) && (uiRow >= 2 * TIER_HEIGHT))
+			{
+				for (unsigned int i = 1; i < TIER_HEIGHT; i++)
+					map.vecTiles[(size_t)(uiRow - i) * uiNumCols + uiCol] = TILE_LADDER;
+				map.vecTiles[(size_t)(uiRow - TIER_HEIGHT) * uiNumCols + uiCol] = TILE_LADDER_TOP;
+			}
+		}
+	}
+
+	// Ladder tops are placed before the platform above is built, so place them again
+	for (unsigned int uiRow = TIER_HEIGHT; uiRow + 1 < uiNumRows; uiRow++)
+	{
+		for (unsigned int uiCol = 0; uiCol < uiNumCols; uiCol++)
+		{
+			if ((map.vecTiles[(size_t)(uiRow + 1) * uiNumCols + uiCol] == TILE_LADDER) && 
+				(map.vecTiles[(size_t)uiRow * uiNumCols + uiCol] == TILE_GROUND))
+				map.vecTiles[(size_t)uiRow * uiNumCols + uiCol] = TILE_LADDER_TOP;
+		}
+	}
+}
+
+/**
+ @brief Generate an open field split by a solid wall, with the goals on the other side of it from the starts
+ */
+static void GenerateUnreachable(const unsigned int uiNumCols, const unsigned int uiNumRows, mt19937& rng, BenchmarkMap& map)
+{
+	GenerateOpenField(uiNumCols, uiNumRows, rng, map);
+	map.sName = "unreachable";
+	map.bSplit = true;
+	for (unsigned int uiRow = 0; uiRow < uiNumRows; uiRow++)
+		map.vecTiles[(size_t)uiRow * uiNumCols + uiNumCols / 2] = TILE_CLOUD;
+}
+
+/**
+ @brief Build the nav grid of a map with the same rules as CMap2D::BuildNavGrid(). The rows of the grid are counted from the bottom
+ */
+static void BuildNavGrid(const BenchmarkMap& map, CNavGrid& cNavGrid)
+{
+	cNavGrid.Init(map.uiNumCols, map.uiNumRows);
+	for (unsigned int uiY = 0; uiY < map.uiNumRows; uiY++)
+	{
+		const unsigned int uiRow = map.uiNumRows - 1 - uiY;
+		for (unsigned int uiX = 0; uiX < map.uiNumCols; uiX++)
+		{
+			const TileValue value = map.vecTiles[(size_t)uiRow * map.uiNumCols + uiX];
+			const TileValue valueBelow = (uiRow + 1 < map.uiNumRows) ? map.vecTiles[(size_t)(uiRow + 1) * map.uiNumCols + uiX] : 0;
+			cNavGrid.SetCell(uiX, uiY, TileRules::GetNavCellType(value, valueBelow), TileRules::GetNavPenalty(value));
+		}
+	}
+}
+
+/**
+ @brief Pick random pairs of start and goal cells which an entity can be in, so not blocked and not in the air
+ */
+static void PickQueries(const BenchmarkMap& map, const CNavGrid& cNavGrid, const unsigned int uiNumQueries, mt19937& rng,
+						vector<pair<unsigned int, unsigned int>>& vecQueries)
+{
+	vector<unsigned int> vecLeft, vecRight;
+	for (unsigned int uiCell = 0; uiCell < cNavGrid.GetNumCells(); uiCell++)
+	{
+		const CNavGrid::CELL_TYPE eType = cNavGrid.GetCellType(uiCell);
+		if ((eType != CNavGrid::CELL_STANDABLE) && (eType != CNavGrid::CELL_LADDER))
+			continue;
+		if ((!map.bSplit) || (cNavGrid.GetX(uiCell) < map.uiNumCols / 2))
+			vecLeft.push_back(uiCell);
+		if ((!map.bSplit) || (cNavGrid.GetX(uiCell) > map.uiNumCols / 2))
+			vecRight.push_back(uiCell);
+	}
+
+	vecQueries.clear();
+	if ((vecLeft.empty()) || (vecRight.empty()))
+		return;
+	uniform_int_distribution<size_t> left(0, vecLeft.size() - 1);
+	uniform_int_distribution<size_t> right(0, vecRight.size() - 1);
+	for (unsigned int i = 0; i < uiNumQueries; i++)
+		vecQueries.push_back(make_pair(vecLeft[left(rng)], vecRight[right(rng)]));
+}
+
+/**
+ @brief Run a batch of queries with A*, after one query to warm up the search data
+ */
+template <unsigned int NUM_DIRECTIONS, typename Distance>
+static void RunAStar(const CNavGrid& cNavGrid, const vector<pair<unsigned int, unsigned int>>& vecQueries, BatchResult& result)
+{
+	CAStar cAStar;
+	vector<unsigned int> vecPath;
+	for (unsigned int i = 0; i <= vecQueries.size(); i++)
+	{
+		// The first query is run again after the warm up
+		const pair<unsigned int, unsigned int>& query = vecQueries[(i == 0) ? 0 : i - 1];
+		const unsigned long long ullAllocations = ullNumAllocations;
+		const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+		Heuristics::CGoalHeuristic<Distance> heuristic(cNavGrid, cNavGrid.GetX(query.second), cNavGrid.GetY(query.second), 1);
+		const bool bFound = cAStar.Search<NUM_DIRECTIONS>(cNavGrid, query.first, query.second, heuristic, vecPath);
+
+		const double dNs = (double)chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+		const unsigned long long ullQueryAllocations = ullNumAllocations - ullAllocations;
+		if (i == 0)
+			continue;
+		result.uiNumFound += bFound ? 1 : 0;
+		result.ullNumExpanded += cAStar.GetNumExpanded();
+		result.dTotalNs += dNs;
+		result.vecLatenciesNs.push_back(dNs);
+		result.ullNumAllocations += ullQueryAllocations;
+	}
+}
+
+/**
+ @brief Run a batch of queries with hierarchical path finding, refining the whole path, 
+		after building the clusters, as CMap2D does when a map is loaded, and one query to warm up the search data
+ */
+static void RunHPAStar(const CNavGrid& cNavGrid, const vector<pair<unsigned int, unsigned int>>& vecQueries, BatchResult& result)
+{
+	CHPAStar cHPAStar;
+	const chrono::steady_clock::time_point setupStart = chrono::steady_clock::now();
+	cHPAStar.Init(cNavGrid);
+	cHPAStar.Build(cNavGrid);
+	result.dSetupNs = (double)chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - setupStart).count();
+
+	vector<unsigned int> vecWaypoints, vecPath;
+	for (unsigned int i = 0; i <= vecQueries.size(); i++)
+	{
+		const pair<unsigned int, unsigned int>& query = vecQueries[(i == 0) ? 0 : i - 1];
+		const unsigned long long ullAllocations = ullNumAllocations;
+		const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+		const bool bFound = cHPAStar.FindAbstractPath(cNavGrid, query.first, query.second, vecWaypoints);
+		if (bFound)
+			cHPAStar.RefinePath(cNavGrid, query.first, vecWaypoints, 0xFFFFFFFF, vecPath);
+
+		const double dNs = (double)chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+		const unsigned long long ullQueryAllocations = ullNumAllocations - ullAllocations;
+		if (i == 0)
+			continue;
+		result.uiNumFound += bFound ? 1 : 0;
+		result.dTotalNs += dNs;
+		result.vecLatenciesNs.push_back(dNs);
+		result.ullNumAllocations += ullQueryAllocations;
+	}
+}
+
+/**
+ @brief Print the results of a batch as a row of the table
+ */
+static void PrintResult(const BenchmarkMap& map, const char* szConfig, const unsigned int uiNumQueries, BatchResult& result)
+{
+	if (uiNumQueries == 0)
+		return;
+	sort(result.vecLatenciesNs.begin(), result.vecLatenciesNs.end());
+	const double dP50 = result.vecLatenciesNs[result.vecLatenciesNs.size() / 2];
+	const double dP99 = result.vecLatenciesNs[min(result.vecLatenciesNs.size() - 1, result.vecLatenciesNs.size() * 99 / 100)];
+
+	char szSize[32];
+	snprintf(szSize, sizeof(szSize), "%ux%u", map.uiNumCols, map.uiNumRows);
+	printf("%-12s %-10s %-16s %5u/%-5u ", map.sName.c_str(), szSize, szConfig, result.uiNumFound, uiNumQueries);
+	if (result.ullNumExpanded > 0)
+		printf("%12.1f %9.2f ", (double)result.ullNumExpanded / uiNumQueries, result.dTotalNs / result.ullNumExpanded);
+	else
+		printf("%12s %9s ", "-", "-");
+	printf("%10.2f %10.2f %8.2f\n", dP50 / 1000.0, dP99 / 1000.0, (double)result.ullNumAllocations / uiNumQueries);
+	if (result.dSetupNs > 0.0)
+		printf("%-12s %-10s %-16s setup %.2f ms\n", map.sName.c_str(), szSize, szConfig, result.dSetupNs / 1000000.0);
+}
+
+/**
+ @brief Run all the configurations on a map
+ */
+static void RunMap(const BenchmarkMap& map, const unsigned int uiNumQueries, mt19937& rng)
+{
+	CNavGrid cNavGrid;
+	BuildNavGrid(map, cNavGrid);
+	vector<pair<unsigned int, unsigned int>> vecQueries;
+	PickQueries(map, cNavGrid, uiNumQueries, rng, vecQueries);
+	if (vecQueries.empty())
+	{
+		cout << map.sName << " has no cells to start from" << endl;
+		return;
+	}
+
+	const unsigned int uiCount = (unsigned int)vecQueries.size();
+	BatchResult arrResults[9] = {};
+	RunAStar<4, Heuristics::Manhattan>(cNavGrid, vecQueries, arrResults[0]);
+	PrintResult(map, "manhattan/4", uiCount, arrResults[0]);
+	RunAStar<4, Heuristics::Euclidean>(cNavGrid, vecQueries, arrResults[1]);
+	PrintResult(map, "euclidean/4", uiCount, arrResults[1]);
+	RunAStar<4, Heuristics::Octile>(cNavGrid, vecQueries, arrResults[2]);
+	PrintResult(map, "octile/4", uiCount, arrResults[2]);
+	RunAStar<4, Heuristics::Zero>(cNavGrid, vecQueries, arrResults[3]);
+	PrintResult(map, "zero/4", uiCount, arrResults[3]);
+	RunAStar<8, Heuristics::Manhattan>(cNavGrid, vecQueries, arrResults[4]);
+	PrintResult(map, "manhattan/8", uiCount, arrResults[4]);
+	RunAStar<8, Heuristics::Euclidean>(cNavGrid, vecQueries, arrResults[5]);
+	PrintResult(map, "euclidean/8", uiCount, arrResults[5]);
+	RunAStar<8, Heuristics::Octile>(cNavGrid, vecQueries, arrResults[6]);
+	PrintResult(map, "octile/8", uiCount, arrResults[6]);
+	RunAStar<8, Heuristics::Zero>(cNavGrid, vecQueries, arrResults[7]);
+	PrintResult(map, "zero/8", uiCount, arrResults[7]);
+	RunHPAStar(cNavGrid, vecQueries, arrResults[8]);
+	PrintResult(map, "hpa/4", uiCount, arrResults[8]);
+}
+
+int main(int argc, char* argv[])
+{
+	string sMapFilename = "../../App/Maps/Map_1.csv";
+	bool bQuick = false;
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--quick") == 0)
+			bQuick = true;
+		else
+			sMapFilename = argv[i];
+	}
+
+	// The sizes of the generated maps, and the number of queries to run on each, fewer for the larger maps
+	static const struct {
+		unsigned int uiNumCols;
+		unsigned int uiNumRows;
+		unsigned int uiNumQueries;
+	} arrSizes[] = {
+		{ 32, 24, 2000 },
+		{ 128, 96, 500 },
+		{ 512, 384, 100 },
+		{ 2048, 2048, 10 },
+	};
+	const unsigned int uiNumSizes = sizeof(arrSizes) / sizeof(arrSizes[0]) - (bQuick ? 1 : 0);
+
+	printf("%-12s %-10s %-16s %11s %12s %9s %10s %10s %8s\n",
+		"map", "size", "config", "found", "nodes/query", "ns/node", "p50 (us)", "p99 (us)", "allocs");
+
+	// The same seed gives the same maps and queries in every run
+	mt19937 rng(2022);
+
+	BenchmarkMap map;
+	if (LoadMap(sMapFilename, map))
+		RunMap(map, arrSizes[0].uiNumQueries, rng);
+
+	for (unsigned int i = 0; i < uiNumSizes; i++)
+	{
+		GenerateOpenField(arrSizes[i].uiNumCols, arrSizes[i].uiNumRows, rng, map);
+		RunMap(map, arrSizes[i].uiNumQueries, rng);
+		GenerateMaze(arrSizes[i].uiNumCols, arrSizes[i].uiNumRows, rng, map);
+		RunMap(map, arrSizes[i].uiNumQueries, rng);
+		GeneratePlatforms(arrSizes[i].uiNumCols, arrSizes[i].uiNumRows, rng, map);
+		RunMap(map, arrSizes[i].uiNumQueries, rng);
+		GenerateUnreachable(arrSizes[i].uiNumCols, arrSizes[i].uiNumRows, rng, map);
+		RunMap(map, arrSizes[i].uiNumQueries, rng);
+	}
+	return 0;
+}